@@ -14,6 +14,10 @@ internal const val ansiEndSynchronizedUpdate = "$CSI?2026l"
 internal const val ansiReset = "${CSI}0"
 internal const val clearLine = "${CSI}K"
 internal const val cursorUp = "${CSI}F"
+internal const val cursorUpCode = 'A'
+internal const val cursorDownCode = 'B'
+internal const val cursorColumnCode = 'G'
+internal const val deleteLinesCode = 'M'
 
 internal const val cursorHide = "$CSI?25l"
 internal const val cursorShow = "$CSI?25h"
@@ -2,8 +2,11 @@ package com.jakewharton.mosaic
 
 import androidx.collection.MutableIntList
 import androidx.collection.mutableIntListOf
+import androidx.collection.mutableObjectListOf
+import com.jakewharton.mosaic.terminal.CellGrid
 import com.jakewharton.mosaic.ui.AnsiLevel
 import com.jakewharton.mosaic.ui.Color
+import com.jakewharton.mosaic.ui.EmptyTextStyle
 import com.jakewharton.mosaic.ui.TextStyle
 import com.jakewharton.mosaic.ui.TextStyle.Companion.Bold
 import com.jakewharton.mosaic.ui.TextStyle.Companion.Dim
@@ -11,6 +14,7 @@ import com.jakewharton.mosaic.ui.TextStyle.Companion.Invert
 import com.jakewharton.mosaic.ui.TextStyle.Companion.Italic
 import com.jakewharton.mosaic.ui.TextStyle.Companion.Strikethrough
 import com.jakewharton.mosaic.ui.TextStyle.Companion.Underline
+import com.jakewharton.mosaic.ui.UnspecifiedColor
 import com.jakewharton.mosaic.ui.isNotEmptyTextStyle
 import com.jakewharton.mosaic.ui.isSpecifiedColor
 import com.jakewharton.mosaic.ui.isUnspecifiedColor
@@ -23,9 +27,15 @@ internal interface TextCanvas {
 	var translationY: Int
 
 	operator fun get(row: Int, column: Int): TextPixel
+
+	/** The code point of the cell at [row], [column]. Unlike [get], this does not count as an access. */
+	fun codePointAt(row: Int, column: Int): Int
 }
 
-private val blankPixel = TextPixel(' ')
+private const val codePointWord = 0
+private const val foregroundWord = 1
+private const val backgroundWord = 2
+private const val textStyleWord = 3
 
 internal class TextSurface(
 	override val width: Int,
@@ -35,40 +45,161 @@ internal class TextSurface(
 	override var translationX = 0
 	override var translationY = 0
 
-	private val cells = Array(width * height) { TextPixel(' ') }
+	/**
+	 * Every cell as [CellGrid.CellWords] consecutive values, row by row: its code point,
+	 * foreground, background, and text style. Frames can be compared directly with [CellGrid.diff].
+	 */
+	val cells = IntArray(width * height * CellGrid.CellWords)
+
+	// A single accessor is reused for every cell so that drawing does not allocate.
+	private val pixel = TextPixel(cells)
+
+	private val colorLevel = when (ansiLevel) {
+		AnsiLevel.NONE -> CellGrid.ColorLevelNone
+		AnsiLevel.ANSI16 -> CellGrid.ColorLevel16
+		AnsiLevel.ANSI256 -> CellGrid.ColorLevel256
+		AnsiLevel.TRUECOLOR -> CellGrid.ColorLevelTruecolor
+	}
+
+	/**
+	 * The smallest rectangle containing every cell accessed with [get] since the last call to
+	 * [resetAccessedBounds]. The right and bottom edges are exclusive. Empty when nothing was
+	 * accessed, in which case left and top are larger than right and bottom.
+	 */
+	var accessedLeft = Int.MAX_VALUE
+		private set
+	var accessedTop = Int.MAX_VALUE
+		private set
+	var accessedRight = Int.MIN_VALUE
+		private set
+	var accessedBottom = Int.MIN_VALUE
+		private set
+
+	init {
+		clear()
+	}
 
 	override operator fun get(row: Int, column: Int): TextPixel {
 		val x = translationX + column
 		val y = row + translationY
 		check(x in 0 until width)
 		check(y in 0 until height)
-		return cells[y * width + x]
+		if (x < accessedLeft) accessedLeft = x
+		if (x >= accessedRight) accessedRight = x + 1
+		if (y < accessedTop) accessedTop = y
+		if (y >= accessedBottom) accessedBottom = y + 1
+		pixel.index = (y * width + x) * CellGrid.CellWords
+		return pixel
+	}
+
+	override fun codePointAt(row: Int, column: Int): Int {
+		val x = translationX + column
+		val y = row + translationY
+		check(x in 0 until width)
+		check(y in 0 until height)
+		return cells[(y * width + x) * CellGrid.CellWords + codePointWord]
 	}
 
-	fun appendRowTo(appendable: Appendable, row: Int) {
+	fun resetAccessedBounds() {
+		accessedLeft = Int.MAX_VALUE
+		accessedTop = Int.MAX_VALUE
+		accessedRight = Int.MIN_VALUE
+		accessedBottom = Int.MIN_VALUE
+	}
+
+	/** Grow the accessed bounds to also contain the rectangle from [left], [top] to [right], [bottom]. */
+	fun includeAccessedBounds(left: Int, top: Int, right: Int, bottom: Int) {
+		if (left < accessedLeft) accessedLeft = left
+		if (top < accessedTop) accessedTop = top
+		if (right > accessedRight) accessedRight = right
+		if (bottom > accessedBottom) accessedBottom = bottom
+	}
+
+	/** Copy the cells of the [regionWidth] by [regionHeight] area at [x], [y] into [destination]. */
+	fun readRegion(x: Int, y: Int, regionWidth: Int, regionHeight: Int, destination: IntArray) {
+		val rowWords = regionWidth * CellGrid.CellWords
+		for (row in 0 until regionHeight) {
+			val start = ((y + row) * width + x) * CellGrid.CellWords
+			cells.copyInto(destination, row * rowWords, start, start + rowWords)
+		}
+	}
+
+	/**
+	 * Replace the cells of the [regionWidth] by [regionHeight] area at [x], [y] with [source], as
+	 * previously read by [readRegion]. The area counts as accessed.
+	 */
+	fun writeRegion(x: Int, y: Int, regionWidth: Int, regionHeight: Int, source: IntArray) {
+		val rowWords = regionWidth * CellGrid.CellWords
+		for (row in 0 until regionHeight) {
+			val start = ((y + row) * width + x) * CellGrid.CellWords
+			source.copyInto(cells, start, row * rowWords, (row + 1) * rowWords)
+		}
+		includeAccessedBounds(x, y, x + regionWidth, y + regionHeight)
+	}
+
+	/** Whether the cells of the [regionWidth] by [regionHeight] area at [x], [y] match [other]. */
+	fun regionEquals(x: Int, y: Int, regionWidth: Int, regionHeight: Int, other: IntArray): Boolean {
+		val rowWords = regionWidth * CellGrid.CellWords
+		for (row in 0 until regionHeight) {
+			val start = ((y + row) * width + x) * CellGrid.CellWords
+			val otherStart = row * rowWords
+			for (i in 0 until rowWords) {
+				if (cells[start + i] != other[otherStart + i]) return false
+			}
+		}
+		return true
+	}
+
+	/** Reset every cell to a blank space and remove any translation. */
+	fun clear() {
+		translationX = 0
+		translationY = 0
+		resetAccessedBounds()
+		for (index in cells.indices step CellGrid.CellWords) {
+			cells[index + codePointWord] = ' '.code
+			cells[index + foregroundWord] = UnspecifiedColor
+			cells[index + backgroundWord] = UnspecifiedColor
+			cells[index + textStyleWord] = EmptyTextStyle
+		}
+	}
+
+	/**
+	 * Append the cells of [row] from [startColumn] until [endColumn] to [appendable]. Attributes
+	 * are assumed to be reset at the start, and are reset again at the end if any were set.
+	 */
+	fun appendRowTo(
+		appendable: Appendable,
+		row: Int,
+		startColumn: Int = 0,
+		endColumn: Int = width,
+	) {
 		// Reused heap allocation for building ANSI attributes inside the loop.
 		val attributes = mutableIntListOf()
 
-		var lastPixel = blankPixel
+		var lastForeground = Color.Unspecified
+		var lastBackground = Color.Unspecified
+		var lastTextStyle = TextStyle.Empty
 
-		val rowStart = row * width
-		val rowStop = rowStart + width
-		for (columnIndex in rowStart until rowStop) {
-			val pixel = cells[columnIndex]
+		val rowStart = (row * width + startColumn) * CellGrid.CellWords
+		val rowStop = (row * width + endColumn) * CellGrid.CellWords
+		for (index in rowStart until rowStop step CellGrid.CellWords) {
+			val foreground = Color(cells[index + foregroundWord])
+			val background = Color(cells[index + backgroundWord])
+			val textStyle = TextStyle(cells[index + textStyleWord])
 
 			if (ansiLevel != AnsiLevel.NONE) {
-				if (pixel.foreground != lastPixel.foreground) {
+				if (foreground != lastForeground) {
 					attributes.addColor(
-						pixel.foreground,
+						foreground,
 						ansiLevel,
 						ansiFgColorSelector,
 						ansiFgColorReset,
 						ansiFgColorOffset,
 					)
 				}
-				if (pixel.background != lastPixel.background) {
+				if (background != lastBackground) {
 					attributes.addColor(
-						pixel.background,
+						background,
 						ansiLevel,
 						ansiBgColorSelector,
 						ansiBgColorReset,
@@ -77,15 +208,15 @@ internal class TextSurface(
 				}
 
 				fun maybeToggleStyle(style: TextStyle, on: Int, off: Int) {
-					if (style in pixel.textStyle) {
-						if (style !in lastPixel.textStyle) {
+					if (style in textStyle) {
+						if (style !in lastTextStyle) {
 							attributes += on
 						}
-					} else if (style in lastPixel.textStyle) {
+					} else if (style in lastTextStyle) {
 						attributes += off
 					}
 				}
-				if (pixel.textStyle != lastPixel.textStyle) {
+				if (textStyle != lastTextStyle) {
 					maybeToggleStyle(Bold, 1, 22)
 					maybeToggleStyle(Dim, 2, 22)
 					maybeToggleStyle(Italic, 3, 23)
@@ -106,13 +237,18 @@ internal class TextSurface(
 				}
 			}
 
-			appendable.appendCodePoint(pixel.codePoint)
-			lastPixel = pixel
+			val codePoint = cells[index + codePointWord]
+			if (codePoint != CellGrid.WideContinuation) {
+				appendable.appendCodePoint(codePoint)
+			}
+			lastForeground = foreground
+			lastBackground = background
+			lastTextStyle = textStyle
 		}
 
-		if (lastPixel.background.isSpecifiedColor ||
-			lastPixel.foreground.isSpecifiedColor ||
-			lastPixel.textStyle.isNotEmptyTextStyle
+		if (lastBackground.isSpecifiedColor ||
+			lastForeground.isSpecifiedColor ||
+			lastTextStyle.isNotEmptyTextStyle
 		) {
 			appendable.append(ansiReset)
 			appendable.append(ansiClosingCharacter)
@@ -155,6 +291,19 @@ internal class TextSurface(
 		}
 	}
 
+	/**
+	 * Encode the cells of [row] from [startColumn] until [endColumn] into [output] with
+	 * [CellGrid.encodeRow]. The text is the same as [appendRowTo] produces.
+	 */
+	fun encodeRowTo(
+		output: Utf8Builder,
+		row: Int,
+		startColumn: Int = 0,
+		endColumn: Int = width,
+	) {
+		output.appendCells(cells, row * width + startColumn, endColumn - startColumn, colorLevel)
+	}
+
 	fun render(): String = buildString {
 		for (rowIndex in 0 until height) {
 			if (rowIndex > 0) {
@@ -165,12 +314,65 @@ internal class TextSurface(
 	}
 }
 
-internal class TextPixel(var codePoint: Int) {
-	var background: Color = Color.Unspecified
-	var foreground: Color = Color.Unspecified
-	var textStyle: TextStyle = TextStyle.Empty
+/**
+ * Recycles [TextSurface]s so that painting frames of an unchanging size does not allocate.
+ * Only surfaces of the most recently requested size are retained.
+ */
+internal class TextSurfacePool(
+	private val ansiLevel: AnsiLevel,
+) {
+	private val surfaces = mutableObjectListOf<TextSurface>()
 
-	constructor(char: Char) : this(char.code)
+	/** Return a cleared surface of the requested size, reusing a released one when possible. */
+	fun acquire(width: Int, height: Int): TextSurface {
+		if (surfaces.isNotEmpty()) {
+			val surface = surfaces.removeAt(surfaces.lastIndex)
+			if (surface.width == width && surface.height == height) {
+				surface.clear()
+				return surface
+			}
+			// The size changed, so none of the retained surfaces can be reused.
+			surfaces.clear()
+		}
+		return TextSurface(width, height, ansiLevel)
+	}
+
+	/** Return [surface] to the pool. It must not be used again by the caller. */
+	fun release(surface: TextSurface) {
+		surfaces += surface
+	}
+}
+
+/**
+ * A view of a single cell of a [TextSurface]. The instance is shared by every cell of its surface
+ * and is only valid until the next call to [TextSurface.get].
+ */
+internal class TextPixel(private val cells: IntArray) {
+	internal var index = 0
+
+	var codePoint: Int
+		get() = cells[index + codePointWord]
+		set(value) {
+			cells[index + codePointWord] = value
+		}
+
+	var background: Color
+		get() = Color(cells[index + backgroundWord])
+		set(value) {
+			cells[index + backgroundWord] = value.value
+		}
+
+	var foreground: Color
+		get() = Color(cells[index + foregroundWord])
+		set(value) {
+			cells[index + foregroundWord] = value.value
+		}
+
+	var textStyle: TextStyle
+		get() = TextStyle(cells[index + textStyleWord])
+		set(value) {
+			cells[index + textStyleWord] = value.bits
+		}
 
 	override fun toString() = buildString {
 		append("TextPixel(\"")
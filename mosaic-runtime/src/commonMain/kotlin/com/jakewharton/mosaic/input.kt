@@ -0,0 +1,92 @@
+package com.jakewharton.mosaic
+
+import com.jakewharton.mosaic.layout.KeyEvent
+import com.jakewharton.mosaic.layout.PasteEvent
+import com.jakewharton.mosaic.terminal.InputEvent
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyBackspace
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyCodePoint
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyDelete
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyDown
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyEnd
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyEnter
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyEscape
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyF1
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyHome
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyInsert
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyLeft
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyPageDown
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyPageUp
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyRight
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyTab
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyUp
+
+/** Strings for each ASCII character so that the common case of a typed key does not allocate. */
+private val asciiKeys = Array(128) { it.toChar().toString() }
+
+private val functionKeys = Array(12) { "F${it + 1}" }
+
+/**
+ * Convert a decoded native input event into a [KeyEvent]. Key names match those previously
+ * produced by Mordant, which themselves follow the web's `KeyboardEvent.key` values.
+ */
+internal fun InputEvent.toKeyEvent(): KeyEvent {
+	val key = when (val key = key) {
+		KeyCodePoint -> {
+			val codePoint = codePoint
+			if (codePoint < 128) {
+				asciiKeys[codePoint]
+			} else if (codePoint < 0x10000) {
+				codePoint.toChar().toString()
+			} else {
+				val offset = codePoint - 0x10000
+				charArrayOf(
+					(0xD800 + (offset shr 10)).toChar(),
+					(0xDC00 + (offset and 0x3FF)).toChar(),
+				).concatToString()
+			}
+		}
+		KeyEnter -> "Enter"
+		KeyTab -> "Tab"
+		KeyBackspace -> "Backspace"
+		KeyEscape -> "Escape"
+		KeyUp -> "ArrowUp"
+		KeyDown -> "ArrowDown"
+		KeyLeft -> "ArrowLeft"
+		KeyRight -> "ArrowRight"
+		KeyHome -> "Home"
+		KeyEnd -> "End"
+		KeyInsert -> "Insert"
+		KeyDelete -> "Delete"
+		KeyPageUp -> "PageUp"
+		KeyPageDown -> "PageDown"
+		in KeyF1 until KeyF1 + functionKeys.size -> functionKeys[key - KeyF1]
+		else -> "Unidentified"
+	}
+	return KeyEvent(key = key, alt = alt, ctrl = ctrl, shift = shift)
+}
+
+/** Split pasted text into the key events which would have been produced by typing it. */
+internal fun PasteEvent.toKeyEvents(): Sequence<KeyEvent> = sequence {
+	val text = text
+	var index = 0
+	while (index < text.length) {
+		val char = text[index]
+		val key = when {
+			char == '\r' -> {
+				// Treat CRLF as a single line break.
+				if (index + 1 < text.length && text[index + 1] == '\n') index++
+				"Enter"
+			}
+			char == '\n' -> "Enter"
+			char == '\t' -> "Tab"
+			char.code < 128 -> asciiKeys[char.code]
+			char.isHighSurrogate() && index + 1 < text.length && text[index + 1].isLowSurrogate() -> {
+				index++
+				text.substring(index - 1, index + 1)
+			}
+			else -> char.toString()
+		}
+		yield(KeyEvent(key))
+		index++
+	}
+}
@@ -23,9 +23,10 @@ import com.jakewharton.mosaic.TextPixel
 import com.jakewharton.mosaic.UnspecifiedCodePoint
 import com.jakewharton.mosaic.isSpecifiedCodePoint
 import com.jakewharton.mosaic.isUnspecifiedCodePoint
+import com.jakewharton.mosaic.terminal.CellGrid.WideContinuation
+import com.jakewharton.mosaic.terminal.UnicodeWidth
 import com.jakewharton.mosaic.text.AnnotatedString
-import com.jakewharton.mosaic.text.SpanStyle
-import com.jakewharton.mosaic.text.getLocalRawSpanStyles
+import com.jakewharton.mosaic.text.SpanStyleIndex
 import com.jakewharton.mosaic.ui.Color
 import com.jakewharton.mosaic.ui.TextStyle
 import com.jakewharton.mosaic.ui.isSpecifiedColor
@@ -107,6 +108,36 @@ public interface DrawScope {
 		textStyle: TextStyle = TextStyle.Unspecified,
 	)
 
+	/**
+	 * Draws the characters of [string] from [start] (inclusive) until [end] (exclusive) without
+	 * creating a substring.
+	 */
+	public fun drawText(
+		row: Int,
+		column: Int,
+		string: String,
+		start: Int,
+		end: Int,
+		foreground: Color = Color.Unspecified,
+		background: Color = Color.Unspecified,
+		textStyle: TextStyle = TextStyle.Unspecified,
+	)
+
+	/**
+	 * Draws the characters of [string] from [start] (inclusive) until [end] (exclusive) without
+	 * creating a substring. Span styles apply at their offsets within the whole [string].
+	 */
+	public fun drawText(
+		row: Int,
+		column: Int,
+		string: AnnotatedString,
+		start: Int,
+		end: Int,
+		foreground: Color = Color.Unspecified,
+		background: Color = Color.Unspecified,
+		textStyle: TextStyle = TextStyle.Unspecified,
+	)
+
 	/**
 	 * Helper method to offset the provided size with the offset in box width and height
 	 */
@@ -228,7 +259,7 @@ internal open class TextCanvasDrawScope(
 		background: Color,
 		textStyle: TextStyle,
 	) {
-		drawText(row, column, string, foreground, background, textStyle, null)
+		drawText(row, column, string, 0, string.length, foreground, background, textStyle, null)
 	}
 
 	override fun drawText(
@@ -239,34 +270,107 @@ internal open class TextCanvasDrawScope(
 		background: Color,
 		textStyle: TextStyle,
 	) {
-		drawText(row, column, string.text, foreground, background, textStyle) { start, end ->
-			string.getLocalRawSpanStyles(start, end)
-		}
+		drawText(row, column, string, 0, string.length, foreground, background, textStyle)
+	}
+
+	override fun drawText(
+		row: Int,
+		column: Int,
+		string: String,
+		start: Int,
+		end: Int,
+		foreground: Color,
+		background: Color,
+		textStyle: TextStyle,
+	) {
+		drawText(row, column, string, start, end, foreground, background, textStyle, null)
+	}
+
+	override fun drawText(
+		row: Int,
+		column: Int,
+		string: AnnotatedString,
+		start: Int,
+		end: Int,
+		foreground: Color,
+		background: Color,
+		textStyle: TextStyle,
+	) {
+		drawText(
+			row,
+			column,
+			string.text,
+			start,
+			end,
+			foreground,
+			background,
+			textStyle,
+			string.spanStyleIndex,
+		)
 	}
 
 	private fun drawText(
 		row: Int,
 		column: Int,
 		text: String,
+		start: Int,
+		end: Int,
 		foreground: Color,
 		background: Color,
 		textStyle: TextStyle,
-		spanStylesProvider: ((start: Int, end: Int) -> List<SpanStyle>)?,
+		spanStyles: SpanStyleIndex?,
 	) {
-		var pixelIndex = 0
+		require(start in 0..end && end <= text.length) {
+			"start ($start) and end ($end) must be within 0 and length (${text.length})"
+		}
+		var pixelIndex = start
+		var spanSegment = spanStyles?.segmentAt(start) ?: 0
 		var characterColumn = column
-		while (pixelIndex < text.length) {
-			val character = canvas[row, characterColumn++]
-
+		while (pixelIndex < end) {
 			val pixelEnd = if (text[pixelIndex].isHighSurrogate()) {
 				pixelIndex + 2
 			} else {
 				pixelIndex + 1
 			}
 
-			character.updateTextPixel(text.codePointAt(pixelIndex), foreground, background, textStyle)
-			spanStylesProvider?.invoke(pixelIndex, pixelEnd)?.forEach {
-				character.updateTextPixel(UnspecifiedCodePoint, it.color, it.background, it.textStyle)
+			val codePoint = text.codePointAt(pixelIndex)
+			val codePointWidth = if (codePoint < 0x80) 1 else UnicodeWidth.of(codePoint)
+			// Zero-width code points cannot be combined into the single code point of a cell.
+			if (codePointWidth > 0) {
+				// A wide character with no room for its right half at the edge of the canvas is drawn
+				// as a space, as a terminal would leave that column blank.
+				val fits = codePointWidth == 1 || canvas.translationX + characterColumn + 1 < canvas.width
+				breakWidePair(row, characterColumn)
+				val character = canvas[row, characterColumn]
+				character.updateTextPixel(
+					if (fits) codePoint else ' '.code,
+					foreground,
+					background,
+					textStyle,
+				)
+				if (spanStyles != null) {
+					spanSegment = spanStyles.seek(pixelIndex, spanSegment)
+					character.updateTextPixel(
+						UnspecifiedCodePoint,
+						spanStyles.color(spanSegment, pixelEnd),
+						spanStyles.background(spanSegment, pixelEnd),
+						spanStyles.textStyle(spanSegment, pixelEnd),
+					)
+				}
+				if (codePointWidth == 2 && fits) {
+					// The terminal draws the right half of the character into the next cell. Match its
+					// attributes so that none are emitted for it.
+					val characterForeground = character.foreground
+					val characterBackground = character.background
+					val characterTextStyle = character.textStyle
+					breakWidePair(row, characterColumn + 1)
+					val continuation = canvas[row, characterColumn + 1]
+					continuation.codePoint = WideContinuation
+					continuation.foreground = characterForeground
+					continuation.background = characterBackground
+					continuation.textStyle = characterTextStyle
+				}
+				characterColumn += codePointWidth
 			}
 
 			pixelIndex = pixelEnd
@@ -281,9 +385,28 @@ internal open class TextCanvasDrawScope(
 		background: Color = Color.Unspecified,
 		textStyle: TextStyle = TextStyle.Unspecified,
 	) {
+		if (codePoint.isSpecifiedCodePoint) {
+			breakWidePair(y, x)
+		}
 		canvas[y, x].updateTextPixel(codePoint, foreground, background, textStyle)
 	}
 
+	/**
+	 * Prepare for the code point of the cell at [row], [column] to be replaced. A wide character
+	 * occupies its cell and a [WideContinuation] cell after it, so replacing either half resets the
+	 * other half to a space. Otherwise, an orphaned continuation would render as nothing and a lone
+	 * wide character would overlap its neighbor, shifting the rest of the row either way.
+	 */
+	private fun breakWidePair(row: Int, column: Int) {
+		val x = canvas.translationX + column
+		if (x > 0 && canvas.codePointAt(row, column) == WideContinuation) {
+			canvas[row, column - 1].codePoint = ' '.code
+		}
+		if (x + 1 < canvas.width && canvas.codePointAt(row, column + 1) == WideContinuation) {
+			canvas[row, column + 1].codePoint = ' '.code
+		}
+	}
+
 	private inline fun TextPixel.updateTextPixel(
 		codePoint: Int,
 		foreground: Color,
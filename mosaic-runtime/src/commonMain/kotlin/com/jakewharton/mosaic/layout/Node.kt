@@ -1,18 +1,21 @@
 package com.jakewharton.mosaic.layout
 
 import androidx.collection.MutableObjectList
-import com.jakewharton.mosaic.TextCanvas
 import com.jakewharton.mosaic.TextSurface
+import com.jakewharton.mosaic.TextSurfacePool
 import com.jakewharton.mosaic.layout.Placeable.PlacementScope
 import com.jakewharton.mosaic.modifier.Modifier
+import com.jakewharton.mosaic.terminal.CellGrid
 import com.jakewharton.mosaic.ui.AnsiLevel
 import com.jakewharton.mosaic.ui.unit.Constraints
+import kotlin.concurrent.Volatile
 
 internal fun interface DebugPolicy {
 	fun MosaicNode.renderDebug(): String
 }
 
 internal abstract class MosaicNodeLayer(
+	val owner: MosaicNode,
 	private val isStatic: Boolean,
 ) : Placeable(),
 	Measurable,
@@ -21,14 +24,31 @@ internal abstract class MosaicNodeLayer(
 	abstract val next: MosaicNodeLayer?
 
 	private var measureResult: MeasureResult = NotMeasured
+	private var measuredConstraints = Constraints()
+
+	/** Set when [measureResult] changes, forcing the next [placeAt] to place children again. */
+	private var placementInvalid = true
 
 	final override var parentData: Any? = null
 
 	final override val width get() = measureResult.width
 	final override val height get() = measureResult.height
 
-	override fun measure(constraints: Constraints): Placeable = apply {
-		measureResult = doMeasure(constraints)
+	override fun measure(constraints: Constraints): Placeable {
+		if (!owner.measuringInvalidLayout && measureResult !== NotMeasured && constraints == measuredConstraints) {
+			// Nothing read by the previous measure has changed, so its result still holds.
+			return this
+		}
+		val observer = owner.stateObserver
+		if (observer != null) {
+			observer.observeMeasure(this) { measureResult = doMeasure(constraints) }
+		} else {
+			measureResult = doMeasure(constraints)
+		}
+		measuredConstraints = constraints
+		placementInvalid = true
+		owner.invalidateDraw()
+		return this
 	}
 
 	protected open fun doMeasure(constraints: Constraints): MeasureResult {
@@ -48,7 +68,17 @@ internal abstract class MosaicNodeLayer(
 	final override var y = 0
 		private set
 
+	private var placedX = 0
+	private var placedY = 0
+
 	final override fun placeAt(x: Int, y: Int) {
+		if (!placementInvalid && x == placedX && y == placedY) {
+			// Neither this layer nor anything below it has changed since it was last placed here.
+			return
+		}
+		placedX = x
+		placedY = y
+
 		// If this layer belongs to a static node, ignore the placement coordinates from the parent.
 		// We reset the coordinate system to draw at 0,0 since static drawing will be on a canvas
 		// sized to this node's width and height.
@@ -56,10 +86,17 @@ internal abstract class MosaicNodeLayer(
 			this.x = x
 			this.y = y
 		}
-		measureResult.placeChildren()
+		val observer = owner.stateObserver
+		if (observer != null) {
+			observer.observePlacement(this) { measureResult.placeChildren() }
+		} else {
+			measureResult.placeChildren()
+		}
+		placementInvalid = false
+		owner.invalidateDraw()
 	}
 
-	open fun drawTo(canvas: TextCanvas) {
+	open fun drawTo(canvas: TextSurface) {
 		next?.drawTo(canvas)
 	}
 
@@ -67,6 +104,10 @@ internal abstract class MosaicNodeLayer(
 		return next?.sendKeyEvent(keyEvent) ?: false
 	}
 
+	open fun sendPasteEvent(pasteEvent: PasteEvent): Boolean {
+		return next?.sendPasteEvent(pasteEvent) ?: false
+	}
+
 	override fun minIntrinsicWidth(height: Int): Int {
 		return next?.minIntrinsicWidth(height) ?: 0
 	}
@@ -91,13 +132,60 @@ internal object NotMeasured : MeasureResult {
 }
 
 internal class MosaicNode(
-	var measurePolicy: MeasurePolicy,
+	measurePolicy: MeasurePolicy,
 	var debugPolicy: DebugPolicy,
 	val onStaticDraw: (() -> Unit)?,
 ) : Measurable {
 	val isStatic get() = onStaticDraw != null
 	val children = ArrayList<MosaicNode>()
 
+	var parent: MosaicNode? = null
+		private set
+
+	var measurePolicy: MeasurePolicy = measurePolicy
+		set(value) {
+			field = value
+			invalidateLayout()
+		}
+
+	/**
+	 * Records the state read by this node while measuring, placing, and drawing. Set on the root
+	 * node and copied down to each child as it is measured.
+	 */
+	var stateObserver: NodeStateObserver? = null
+
+	/**
+	 * True when this node or one of its descendants must be measured again, even if given the
+	 * same constraints as last time.
+	 */
+	@Volatile
+	var layoutInvalid = true
+		private set
+
+	/**
+	 * The value of [layoutInvalid] when the current measure began. [layoutInvalid] itself is
+	 * cleared beforehand so that an invalidation which arrives while measuring, such as from a
+	 * snapshot applied on another thread, is kept for the next measure rather than lost.
+	 */
+	var measuringInvalidLayout = true
+		private set
+
+	/** True when this node or one of its descendants must be drawn again. */
+	@Volatile
+	private var drawInvalid = true
+
+	/**
+	 * The cells of this node's area immediately before and after it was last drawn. When the cells
+	 * before drawing match and nothing has invalidated the drawing, the cells after are copied
+	 * rather than drawing again. Null when the last drawing touched cells outside of this node.
+	 */
+	private var cellsBeforeDraw: IntArray? = null
+	private var cellsAfterDraw: IntArray? = null
+	private var drawnX = 0
+	private var drawnY = 0
+	private var drawnWidth = 0
+	private var drawnHeight = 0
+
 	private val bottomLayer: MosaicNodeLayer = BottomLayer(this)
 	var topLayer: MosaicNodeLayer = bottomLayer
 		private set
@@ -106,13 +194,16 @@ internal class MosaicNode(
 		private set
 
 	fun setModifier(modifier: Modifier) {
+		clearLayoutObservations()
 		topLayer = modifier.foldOut(bottomLayer) { element, nextLayer ->
 			when (element) {
-				is LayoutModifier -> LayoutLayer(element, nextLayer)
+				is LayoutModifier -> LayoutLayer(this, element, nextLayer)
 
-				is DrawModifier -> DrawLayer(element, nextLayer)
+				is DrawModifier -> DrawLayer(this, element, nextLayer)
 
-				is KeyModifier -> KeyLayer(element, nextLayer)
+				is KeyModifier -> KeyLayer(this, element, nextLayer)
+
+				is PasteModifier -> PasteLayer(this, element, nextLayer)
 
 				is ParentDataModifier -> {
 					parentData = element.modifyParentData(parentData)
@@ -122,10 +213,70 @@ internal class MosaicNode(
 				else -> nextLayer
 			}
 		}
+		invalidateLayout()
+	}
+
+	fun insertChild(index: Int, child: MosaicNode) {
+		children.add(index, child)
+		child.parent = this
+		invalidateLayout()
+	}
+
+	fun removeChildren(index: Int, count: Int) {
+		for (i in index until index + count) {
+			children[i].detach()
+		}
+		children.subList(index, index + count).clear()
+		invalidateLayout()
+	}
+
+	private fun detach() {
+		clearLayoutObservations()
+		stateObserver?.clear(this)
+		stateObserver = null
+		parent = null
+		for (child in children) {
+			child.detach()
+		}
 	}
 
-	override fun measure(constraints: Constraints): Placeable =
-		topLayer.apply { measure(constraints) }
+	private fun clearLayoutObservations() {
+		val observer = stateObserver ?: return
+		var layer: MosaicNodeLayer? = topLayer
+		while (layer != null) {
+			observer.clear(layer)
+			layer = layer.next
+		}
+	}
+
+	/**
+	 * Force this node to be measured again along with its ancestors, whose sizes and placements
+	 * may depend on it. Sibling subtrees keep their cached measurements.
+	 */
+	fun invalidateLayout() {
+		var node: MosaicNode? = this
+		while (node != null) {
+			node.layoutInvalid = true
+			node = node.parent
+		}
+	}
+
+	/** Force this node to be drawn again along with its ancestors, whose cells include its own. */
+	fun invalidateDraw() {
+		var node: MosaicNode? = this
+		while (node != null) {
+			node.drawInvalid = true
+			node = node.parent
+		}
+	}
+
+	override fun measure(constraints: Constraints): Placeable {
+		parent?.let { stateObserver = it.stateObserver }
+		measuringInvalidLayout = layoutInvalid
+		layoutInvalid = false
+		topLayer.measure(constraints)
+		return topLayer
+	}
 
 	val width: Int get() = topLayer.width
 	val height: Int get() = topLayer.height
@@ -143,10 +294,99 @@ internal class MosaicNode(
 	 */
 	fun paint(ansiLevel: AnsiLevel): TextSurface {
 		val surface = TextSurface(width, height, ansiLevel)
-		topLayer.drawTo(surface)
+		drawTo(surface)
+		return surface
+	}
+
+	/**
+	 * Draw this node to a [TextSurface] acquired from [pool].
+	 * A call to [measureAndPlace] must precede calls to this function.
+	 */
+	fun paint(pool: TextSurfacePool): TextSurface {
+		val surface = pool.acquire(width, height)
+		drawTo(surface)
 		return surface
 	}
 
+	/**
+	 * Draw this node to [surface], or copy the cells it produced last time when neither this node
+	 * nor the cells beneath it have changed since.
+	 */
+	fun drawTo(surface: TextSurface) {
+		val x = x
+		val y = y
+		val width = width
+		val height = height
+		if (x < 0 || y < 0 || x + width > surface.width || y + height > surface.height) {
+			// Only areas entirely within the surface can be cached.
+			cellsBeforeDraw = null
+			cellsAfterDraw = null
+			observeDraw(surface)
+			return
+		}
+
+		// Cleared before drawing so that an invalidation which arrives while drawing, such as from a
+		// snapshot applied on another thread, is kept for the next draw rather than lost.
+		val drawInvalid = drawInvalid
+		this.drawInvalid = false
+
+		val cellsBeforeDraw = cellsBeforeDraw
+		val cellsAfterDraw = cellsAfterDraw
+		if (!drawInvalid &&
+			cellsBeforeDraw != null &&
+			cellsAfterDraw != null &&
+			x == drawnX &&
+			y == drawnY &&
+			width == drawnWidth &&
+			height == drawnHeight &&
+			surface.regionEquals(x, y, width, height, cellsBeforeDraw)
+		) {
+			surface.writeRegion(x, y, width, height, cellsAfterDraw)
+			return
+		}
+
+		val size = width * height * CellGrid.CellWords
+		val before = cellsBeforeDraw?.takeIf { it.size == size } ?: IntArray(size)
+		surface.readRegion(x, y, width, height, before)
+
+		// Check whether this node only touches cells within its own area, as otherwise its cells
+		// do not capture all of its drawing.
+		val outerLeft = surface.accessedLeft
+		val outerTop = surface.accessedTop
+		val outerRight = surface.accessedRight
+		val outerBottom = surface.accessedBottom
+		surface.resetAccessedBounds()
+		observeDraw(surface)
+		val contained = surface.accessedLeft >= x &&
+			surface.accessedTop >= y &&
+			surface.accessedRight <= x + width &&
+			surface.accessedBottom <= y + height
+		surface.includeAccessedBounds(outerLeft, outerTop, outerRight, outerBottom)
+
+		if (contained) {
+			val after = cellsAfterDraw?.takeIf { it.size == size } ?: IntArray(size)
+			surface.readRegion(x, y, width, height, after)
+			this.cellsBeforeDraw = before
+			this.cellsAfterDraw = after
+			drawnX = x
+			drawnY = y
+			drawnWidth = width
+			drawnHeight = height
+		} else {
+			this.cellsBeforeDraw = null
+			this.cellsAfterDraw = null
+		}
+	}
+
+	private fun observeDraw(surface: TextSurface) {
+		val observer = stateObserver
+		if (observer != null) {
+			observer.observeDraw(this) { topLayer.drawTo(surface) }
+		} else {
+			topLayer.drawTo(surface)
+		}
+	}
+
 	/**
 	 * Append any static [TextSurfaces][TextSurface] to [statics].
 	 * A call to [measureAndPlace] must precede calls to this function.
@@ -166,6 +406,10 @@ internal class MosaicNode(
 		return topLayer.sendKeyEvent(keyEvent)
 	}
 
+	fun sendPasteEvent(pasteEvent: PasteEvent): Boolean {
+		return topLayer.sendPasteEvent(pasteEvent)
+	}
+
 	override fun minIntrinsicWidth(height: Int): Int {
 		return topLayer.minIntrinsicWidth(height)
 	}
@@ -187,17 +431,17 @@ internal class MosaicNode(
 
 private class BottomLayer(
 	private val node: MosaicNode,
-) : MosaicNodeLayer(node.isStatic) {
+) : MosaicNodeLayer(node, node.isStatic) {
 	override val next: MosaicNodeLayer? get() = null
 
 	override fun doMeasure(constraints: Constraints): MeasureResult {
 		return node.measurePolicy.run { measure(node.children, constraints) }
 	}
 
-	override fun drawTo(canvas: TextCanvas) {
+	override fun drawTo(canvas: TextSurface) {
 		for (child in node.children) {
 			if (child.width != 0 && child.height != 0) {
-				child.topLayer.drawTo(canvas)
+				child.drawTo(canvas)
 			}
 		}
 	}
@@ -211,6 +455,15 @@ private class BottomLayer(
 		return false
 	}
 
+	override fun sendPasteEvent(pasteEvent: PasteEvent): Boolean {
+		for (child in node.children) {
+			if (child.sendPasteEvent(pasteEvent)) {
+				return true
+			}
+		}
+		return false
+	}
+
 	override fun minIntrinsicWidth(height: Int): Int {
 		return node.measurePolicy.run { minIntrinsicWidth(node.children, height) }
 	}
@@ -229,9 +482,10 @@ private class BottomLayer(
 }
 
 private class LayoutLayer(
+	owner: MosaicNode,
 	private val element: LayoutModifier,
 	override val next: MosaicNodeLayer,
-) : MosaicNodeLayer(false) {
+) : MosaicNodeLayer(owner, false) {
 	override fun doMeasure(constraints: Constraints): MeasureResult {
 		return element.run { measure(next, constraints) }
 	}
@@ -254,10 +508,11 @@ private class LayoutLayer(
 }
 
 private class DrawLayer(
+	owner: MosaicNode,
 	private val element: DrawModifier,
 	override val next: MosaicNodeLayer,
-) : MosaicNodeLayer(false) {
-	override fun drawTo(canvas: TextCanvas) {
+) : MosaicNodeLayer(owner, false) {
+	override fun drawTo(canvas: TextSurface) {
 		val oldX = canvas.translationX
 		val oldY = canvas.translationY
 		canvas.translationX = x
@@ -274,11 +529,22 @@ private class DrawLayer(
 }
 
 private class KeyLayer(
+	owner: MosaicNode,
 	private val element: KeyModifier,
 	override val next: MosaicNodeLayer,
-) : MosaicNodeLayer(false) {
+) : MosaicNodeLayer(owner, false) {
 	override fun sendKeyEvent(keyEvent: KeyEvent) =
 		element.onPreKeyEvent(keyEvent) ||
 			next.sendKeyEvent(keyEvent) ||
 			element.onKeyEvent(keyEvent)
 }
+
+private class PasteLayer(
+	owner: MosaicNode,
+	private val element: PasteModifier,
+	override val next: MosaicNodeLayer,
+) : MosaicNodeLayer(owner, false) {
+	override fun sendPasteEvent(pasteEvent: PasteEvent) =
+		next.sendPasteEvent(pasteEvent) ||
+			element.onPasteEvent(pasteEvent)
+}
@@ -0,0 +1,58 @@
+package com.jakewharton.mosaic.layout
+
+import androidx.compose.runtime.snapshots.SnapshotStateObserver
+
+/**
+ * Tracks the snapshot state read by each [MosaicNodeLayer] while it measures and places, and by
+ * each [MosaicNode] while it draws. When any of that state changes, the node and its ancestors
+ * are invalidated so that only they are measured or drawn again, and [onLayoutInvalidated] or
+ * [onDrawInvalidated] is called to request a frame.
+ */
+internal class NodeStateObserver(
+	private val onLayoutInvalidated: () -> Unit,
+	private val onDrawInvalidated: () -> Unit,
+) {
+	// Notifications are delivered synchronously so that nodes are invalidated before the layout
+	// which follows a recomposition or a snapshot apply.
+	private val observer = SnapshotStateObserver { it() }
+
+	// Measure and placement reads need separate callback instances. The observer tracks reads for
+	// each callback separately, and observing a scope drops its reads from the last observation.
+	private val onMeasureChanged: (MosaicNodeLayer) -> Unit = { invalidateLayout(it) }
+	private val onPlacementChanged: (MosaicNodeLayer) -> Unit = { invalidateLayout(it) }
+	private val onDrawChanged: (MosaicNode) -> Unit = { node ->
+		node.invalidateDraw()
+		onDrawInvalidated()
+	}
+
+	private fun invalidateLayout(layer: MosaicNodeLayer) {
+		layer.owner.invalidateLayout()
+		onLayoutInvalidated()
+	}
+
+	fun start() {
+		observer.start()
+	}
+
+	fun stop() {
+		observer.stop()
+		observer.clear()
+	}
+
+	fun observeMeasure(layer: MosaicNodeLayer, block: () -> Unit) {
+		observer.observeReads(layer, onMeasureChanged, block)
+	}
+
+	fun observePlacement(layer: MosaicNodeLayer, block: () -> Unit) {
+		observer.observeReads(layer, onPlacementChanged, block)
+	}
+
+	fun observeDraw(node: MosaicNode, block: () -> Unit) {
+		observer.observeReads(node, onDrawChanged, block)
+	}
+
+	/** Stop tracking the reads of [scope], a layer or a node, which is no longer in use. */
+	fun clear(scope: Any) {
+		observer.clear(scope)
+	}
+}
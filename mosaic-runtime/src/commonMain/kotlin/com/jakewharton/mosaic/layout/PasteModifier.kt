@@ -0,0 +1,45 @@
+package com.jakewharton.mosaic.layout
+
+import androidx.compose.runtime.Immutable
+import com.jakewharton.mosaic.modifier.Modifier
+import dev.drewhamilton.poko.Poko
+
+public interface PasteModifier : Modifier.Element {
+	/**
+	 * This function is called when a [PasteEvent] is received by this node. Return true to stop
+	 * propagation of this event. If you return false, the event will be sent to this
+	 * [PasteModifier]'s parent.
+	 *
+	 * If no modifier consumes the event, each character of the pasted text is delivered as an
+	 * individual [KeyEvent] instead.
+	 */
+	public fun onPasteEvent(event: PasteEvent): Boolean
+}
+
+/**
+ * Text which was pasted into the terminal as a single unit, regardless of its length.
+ *
+ * Paste events are only delivered by terminals which support bracketed paste mode.
+ */
+@[Immutable Poko]
+public class PasteEvent(
+	public val text: String,
+)
+
+/**
+ * Adding this [modifier][Modifier] to the [modifier][Modifier] parameter of a component will allow
+ * it to intercept paste events.
+ *
+ * @param onPasteEvent This callback is invoked when the user pastes text into the terminal.
+ *   While implementing this callback, return true to stop propagation of this event. If you return
+ *   false, the paste event will be sent to this [onPasteEvent]'s parent.
+ */
+public fun Modifier.onPasteEvent(
+	onPasteEvent: (event: PasteEvent) -> Boolean,
+): Modifier = this then PasteModifierElement(onPasteEvent)
+
+private class PasteModifierElement(
+	val onEvent: (PasteEvent) -> Boolean,
+) : PasteModifier {
+	override fun onPasteEvent(event: PasteEvent) = onEvent(event)
+}
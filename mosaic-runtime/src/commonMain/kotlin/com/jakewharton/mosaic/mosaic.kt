@@ -13,27 +13,28 @@ import androidx.compose.runtime.mutableStateOf
 import androidx.compose.runtime.snapshots.ObserverHandle
 import androidx.compose.runtime.snapshots.Snapshot
 import androidx.compose.runtime.withFrameNanos
-import com.github.ajalt.mordant.input.RawModeScope
-import com.github.ajalt.mordant.input.enterRawMode
 import com.github.ajalt.mordant.platform.MultiplatformSystem
 import com.github.ajalt.mordant.terminal.Terminal as MordantTerminal
 import com.jakewharton.finalization.withFinalizationHook
 import com.jakewharton.mosaic.layout.KeyEvent
 import com.jakewharton.mosaic.layout.MosaicNode
+import com.jakewharton.mosaic.layout.NodeStateObserver
+import com.jakewharton.mosaic.layout.PasteEvent
+import com.jakewharton.mosaic.terminal.InputEvent
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyPaste
+import com.jakewharton.mosaic.terminal.Tty
 import com.jakewharton.mosaic.ui.AnsiLevel
 import com.jakewharton.mosaic.ui.BoxMeasurePolicy
 import com.jakewharton.mosaic.ui.unit.IntSize
 import kotlin.concurrent.Volatile
 import kotlin.coroutines.CoroutineContext
 import kotlin.coroutines.EmptyCoroutineContext
-import kotlin.time.Duration.Companion.milliseconds
 import kotlin.time.ExperimentalTime
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.CoroutineStart
-import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.IO
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.channels.Channel.Factory.CONFLATED
 import kotlinx.coroutines.channels.Channel.Factory.UNLIMITED
 import kotlinx.coroutines.channels.ReceiveChannel
 import kotlinx.coroutines.channels.consumeEach
@@ -41,6 +42,8 @@ import kotlinx.coroutines.delay
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.selects.select
+import kotlinx.coroutines.withTimeoutOrNull
 
 /**
  * True for a debug-like output that renders each "frame" on its own with a timestamp delta.
@@ -52,7 +55,7 @@ internal fun renderMosaicNode(content: @Composable () -> Unit): MosaicNode {
 	val mosaicComposition = MosaicComposition(
 		coroutineScope = CoroutineScope(EmptyCoroutineContext),
 		terminalState = MordantTerminal().toMutableState(),
-		keyEvents = Channel(),
+		inputEvents = Channel(),
 		onDraw = {},
 	)
 	mosaicComposition.setContent(content)
@@ -78,35 +81,45 @@ internal suspend fun runMosaic(enterRawMode: Boolean, content: @Composable () ->
 	val mordantTerminal = MordantTerminal()
 	val rendering = createRendering(mordantTerminal.terminalInfo.ansiLevel.toMosaicAnsiLevel())
 	val terminalState = mordantTerminal.toMutableState()
-	val keyEvents = Channel<KeyEvent>(UNLIMITED)
+	val inputEvents = Channel<Any>(UNLIMITED)
+	val stdout = Tty.stdoutWriter()
 
 	val rawMode = if (enterRawMode && MultiplatformSystem.readEnvironmentVariable("MOSAIC_RAW_MODE") != "false") {
 		// In theory this call could fail, so perform it before any additional control sequences.
-		mordantTerminal.enterRawMode()
+		Tty.enableRawMode()
 	} else {
 		null
 	}
 
-	platformDisplay(cursorHide)
+	stdout.write(cursorHide)
 
 	withFinalizationHook(
 		hook = {
-			platformDisplay(cursorShow)
+			stdout.write(cursorShow)
 			rawMode?.close()
+			// Closed last as it restores any console state saved before raw mode was entered. This also
+			// waits for the writes above to complete.
+			stdout.close()
 		},
 		block = {
 			val mosaicComposition = MosaicComposition(
 				coroutineScope = this,
 				terminalState = terminalState,
-				keyEvents = keyEvents,
+				inputEvents = inputEvents,
+				maxFps = readPositiveEnvironmentVariable("MOSAIC_MAX_FPS")
+					?.toIntOrNull()
+					?.coerceIn(1, maxMaxFps)
+					?: defaultMaxFps,
+				frameCoalesceMillis = readPositiveEnvironmentVariable("MOSAIC_FRAME_COALESCE_MS")
+					?: defaultFrameCoalesceMillis,
 				onDraw = { rootNode ->
-					platformDisplay(rendering.render(rootNode))
+					rendering.renderTo(rootNode, stdout)
 				},
 			)
 			mosaicComposition.sendFrames()
-			mosaicComposition.scope.updateTerminalInfo(mordantTerminal, terminalState)
-			rawMode?.let { rawMode ->
-				mosaicComposition.scope.readRawModeKeys(rawMode, keyEvents)
+			mosaicComposition.scope.updateTerminalInfo(terminalState)
+			if (rawMode != null) {
+				mosaicComposition.scope.readRawModeInput(inputEvents)
 			}
 			mosaicComposition.setContent(content)
 			mosaicComposition.awaitComplete()
@@ -125,48 +138,120 @@ private fun createRendering(ansiLevel: AnsiLevel = AnsiLevel.TRUECOLOR): Renderi
 		@OptIn(ExperimentalTime::class) // Not used in production.
 		DebugRendering(ansiLevel = ansiLevel)
 	} else {
-		AnsiRendering(ansiLevel = ansiLevel)
+		DiffRendering(ansiLevel = ansiLevel)
 	}
 }
 
-private fun CoroutineScope.updateTerminalInfo(terminal: MordantTerminal, terminalInfo: MutableState<Terminal>) {
+private fun CoroutineScope.updateTerminalInfo(terminalInfo: MutableState<Terminal>) {
+	val notifier = Tty.resizeNotifier()
+
+	// Waiting suspends rather than blocking a thread, and stops when this scope is canceled. The
+	// notifier's signal is waited on by the same native event loop thread as stdin.
 	launch {
-		while (true) {
-			val currentTerminalInfo = terminalInfo.value
-			val newSize = terminal.updateSize()
-			if (currentTerminalInfo.size.width != newSize.width ||
-				currentTerminalInfo.size.height != newSize.height
-			) {
-				terminalInfo.value = Terminal(size = IntSize(newSize.width, newSize.height))
+		try {
+			while (isActive) {
+				if (notifier.awaitResize()) {
+					terminalInfo.value = Terminal(size = IntSize(notifier.columns, notifier.rows))
+				}
 			}
-			delay(50L)
+		} finally {
+			notifier.close()
 		}
 	}
 }
 
-private fun CoroutineScope.readRawModeKeys(rawMode: RawModeScope, keyEvents: Channel<KeyEvent>) {
-	launch(Dispatchers.IO) {
-		while (isActive) {
-			val keyboardEvent = rawMode.readKeyOrNull(10.milliseconds) ?: continue
-			val keyEvent = KeyEvent(
-				key = keyboardEvent.key,
-				alt = keyboardEvent.alt,
-				ctrl = keyboardEvent.ctrl,
-				shift = keyboardEvent.shift,
-			)
-			keyEvents.trySend(keyEvent)
+/**
+ * How long to wait for more input after an escape byte before treating it as the escape key.
+ * This matches the default `ESCDELAY` of ncurses.
+ */
+private const val escapeTimeoutMillis = 25L
+
+private fun CoroutineScope.readRawModeInput(inputEvents: Channel<Any>) {
+	val reader = Tty.stdinReader()
+	val parser = Tty.inputParser()
+
+	// The reader suspends rather than blocking a thread, and stops when this scope is canceled.
+	// Stdin is waited on by the same native event loop thread as resizes.
+	launch {
+		val buffer = ByteArray(8 * 1024)
+		val events = LongArray(buffer.size + 1)
+		try {
+			while (isActive) {
+				val read = if (parser.hasPending) {
+					withTimeoutOrNull(escapeTimeoutMillis) {
+						reader.awaitRead(buffer, 0, buffer.size)
+					} ?: 0
+				} else {
+					reader.awaitRead(buffer, 0, buffer.size)
+				}
+				val count = if (read > 0) {
+					parser.parse(buffer, 0, read, events)
+				} else if (parser.hasPending) {
+					// Timeout (or interrupt or EOF) with a partial sequence. Resolve what we have.
+					parser.flush(events)
+				} else {
+					0
+				}
+				var pasteOffset = 0
+				for (i in 0 until count) {
+					val event = InputEvent(events[i])
+					if (event.key == KeyPaste) {
+						val length = event.codePoint
+						inputEvents.trySend(PasteEvent(parser.pasteText(pasteOffset, length)))
+						pasteOffset += length
+					} else {
+						inputEvents.trySend(event.toKeyEvent())
+					}
+				}
+				if (read == -1) break
+			}
+		} finally {
+			parser.close()
+			reader.close()
 		}
 	}
 }
 
+private val ctrlC = KeyEvent("c", ctrl = true)
+
+/** The default for `MOSAIC_MAX_FPS`. */
+internal const val defaultMaxFps = 60
+
+/** The largest accepted `MOSAIC_MAX_FPS`. Larger values are clamped to it. */
+private const val maxMaxFps = 1_000
+
+/** The default for `MOSAIC_FRAME_COALESCE_MS`. */
+internal const val defaultFrameCoalesceMillis = 4L
+
+private fun readPositiveEnvironmentVariable(name: String): Long? {
+	return MultiplatformSystem.readEnvironmentVariable(name)?.toLongOrNull()?.takeIf { it > 0 }
+}
+
 internal class MosaicComposition(
 	coroutineScope: CoroutineScope,
 	private val terminalState: State<Terminal>,
-	private val keyEvents: ReceiveChannel<KeyEvent>,
+	/** Receives instances of [KeyEvent] and [PasteEvent] in the order they occurred. */
+	private val inputEvents: ReceiveChannel<Any>,
+	/** Frames are sent no more often than this many times per second. */
+	maxFps: Int = defaultMaxFps,
+	/**
+	 * How long to wait after a frame is requested before sending it, so that changes which arrive
+	 * together are rendered together.
+	 */
+	private val frameCoalesceMillis: Long = defaultFrameCoalesceMillis,
 	private val onDraw: (MosaicNode) -> Unit,
 ) {
+	init {
+		require(maxFps > 0) { "maxFps must be greater than zero: $maxFps" }
+	}
+
+	private val frameIntervalMillis = 1_000L / maxFps
+
+	/** Receives an element when the clock gains awaiters after having none. */
+	private val frameRequests = Channel<Unit>(CONFLATED)
+
 	private val job = Job(coroutineScope.coroutineContext[Job])
-	private val clock = BroadcastFrameClock()
+	private val clock = BroadcastFrameClock(onNewAwaiters = { frameRequests.trySend(Unit) })
 	private val composeContext: CoroutineContext = coroutineScope.coroutineContext + job + clock
 	val scope = CoroutineScope(composeContext)
 
@@ -177,10 +262,18 @@ internal class MosaicComposition(
 
 	private val applyObserverHandle: ObserverHandle
 
-	private val readingStatesOnLayout = mutableScatterSetOf<Any>()
 	private val readingStatesOnDraw = mutableScatterSetOf<Any>()
 
-	private val layoutBlockStateReadObserver: (Any) -> Unit = { readingStatesOnLayout.add(it) }
+	private val stateObserver = NodeStateObserver(
+		onLayoutInvalidated = {
+			needLayout = true
+			layoutOrDrawInvalidations.trySend(Unit)
+		},
+		onDrawInvalidated = {
+			needDraw = true
+			layoutOrDrawInvalidations.trySend(Unit)
+		},
+	)
 	private val drawBlockStateReadObserver: (Any) -> Unit = { readingStatesOnDraw.add(it) }
 
 	@Volatile
@@ -189,18 +282,20 @@ internal class MosaicComposition(
 	@Volatile
 	private var needDraw = false
 
+	private val layoutOrDrawInvalidations = Channel<Unit>(CONFLATED)
+
 	init {
 		GlobalSnapshotManager().ensureStarted(scope)
 		startRecomposer()
 		applyObserverHandle = registerSnapshotApplyObserver()
+		rootNode.stateObserver = stateObserver
+		stateObserver.start()
 		startListeningToNeedToLayoutOrDraw()
 	}
 
 	private fun performLayout(rootNode: MosaicNode) {
 		needLayout = false
-		Snapshot.observe(readObserver = layoutBlockStateReadObserver) {
-			rootNode.measureAndPlace()
-		}
+		rootNode.measureAndPlace()
 		performDraw(rootNode)
 	}
 
@@ -213,15 +308,13 @@ internal class MosaicComposition(
 
 	private fun registerSnapshotApplyObserver(): ObserverHandle {
 		return Snapshot.registerApplyObserver { changedStates, _ ->
+			// Nodes are invalidated by the state observer. This also catches state read while
+			// drawing outside of any node, such as by static content.
 			for (state in changedStates) {
-				if (needLayout && needDraw) {
-					break
-				}
-				if (!needLayout && readingStatesOnLayout.contains(state)) {
-					needLayout = true
-				}
 				if (!needDraw && readingStatesOnDraw.contains(state)) {
 					needDraw = true
+					layoutOrDrawInvalidations.trySend(Unit)
+					break
 				}
 			}
 		}
@@ -230,6 +323,11 @@ internal class MosaicComposition(
 	private fun startListeningToNeedToLayoutOrDraw() {
 		scope.launch {
 			while (true) {
+				if (!needLayout && !needDraw) {
+					// Only await a frame when there is work to do, otherwise an idle app would be
+					// continuously requesting frames.
+					layoutOrDrawInvalidations.receive()
+				}
 				withFrameNanos {
 					when {
 						recomposer.currentState.value != Recomposer.State.Idle -> return@withFrameNanos
@@ -247,26 +345,73 @@ internal class MosaicComposition(
 		}
 	}
 
+	/**
+	 * Send frames to the clock as they are requested. Nothing runs while no frames are requested
+	 * and no input arrives. Input is dispatched as soon as it is received.
+	 */
 	fun sendFrames(): Job {
 		return scope.launch {
-			val ctrlC = KeyEvent("c", ctrl = true)
+			// Completes once the minimum interval since the last frame has elapsed.
+			var frameInterval: Job? = null
 
 			while (true) {
-				// Drain any pending key events before triggering the frame.
-				while (true) {
-					val keyEvent = keyEvents.tryReceive().getOrNull() ?: break
-					val keyHandled = rootNode.sendKeyEvent(keyEvent)
-					if (!keyHandled && keyEvent == ctrlC) {
-						cancel()
+				if (!clock.hasAwaiters) {
+					val inputEvent = select<Any?> {
+						inputEvents.onReceive { it }
+						frameRequests.onReceive { null }
+					}
+					if (inputEvent != null) {
+						// The input may or may not change state which then requests a frame.
+						dispatchInputEvent(inputEvent)
+						continue
 					}
 				}
 
+				val lastFrameInterval = frameInterval
+				val frameDelay = launch {
+					delay(frameCoalesceMillis)
+					lastFrameInterval?.join()
+				}
+				while (true) {
+					val inputEvent = select<Any?> {
+						frameDelay.onJoin { null }
+						inputEvents.onReceive { it }
+					} ?: break
+					dispatchInputEvent(inputEvent)
+				}
+
+				frameInterval = launch { delay(frameIntervalMillis) }
 				clock.sendFrame(nanoTime())
-				delay(50L)
+
+				if (!clock.hasAwaiters) {
+					// Awaiters which arrived while we were delaying were just resumed. Drop their request.
+					frameRequests.tryReceive()
+				}
 			}
 		}
 	}
 
+	private fun CoroutineScope.dispatchInputEvent(inputEvent: Any) {
+		when (inputEvent) {
+			is KeyEvent -> sendKeyEvent(inputEvent)
+			is PasteEvent -> {
+				if (!rootNode.sendPasteEvent(inputEvent)) {
+					// Fall back to individual key events for content unaware of pastes.
+					for (keyEvent in inputEvent.toKeyEvents()) {
+						sendKeyEvent(keyEvent)
+					}
+				}
+			}
+		}
+	}
+
+	private fun CoroutineScope.sendKeyEvent(keyEvent: KeyEvent) {
+		val keyHandled = rootNode.sendKeyEvent(keyEvent)
+		if (!keyHandled && keyEvent == ctrlC) {
+			cancel()
+		}
+	}
+
 	fun setContent(content: @Composable () -> Unit) {
 		composition.setContent {
 			CompositionLocalProvider(LocalTerminal provides terminalState.value) {
@@ -287,17 +432,20 @@ internal class MosaicComposition(
 			if (needLayout || needDraw) {
 				awaitFrame()
 			}
+			stateObserver.stop()
 
 			recomposer.close()
 			recomposer.join()
 		} finally {
 			applyObserverHandle.dispose() // if canceled before dispose in the try block
+			stateObserver.stop()
 			job.cancel()
 		}
 	}
 
 	fun cancel() {
 		applyObserverHandle.dispose()
+		stateObserver.stop()
 		recomposer.cancel()
 		job.cancel()
 	}
@@ -325,15 +473,16 @@ internal class MosaicNodeApplier(
 	}
 
 	override fun insertBottomUp(index: Int, instance: MosaicNode) {
-		current.children.add(index, instance)
+		current.insertChild(index, instance)
 	}
 
 	override fun remove(index: Int, count: Int) {
-		current.children.remove(index, count)
+		current.removeChildren(index, count)
 	}
 
 	override fun move(from: Int, to: Int, count: Int) {
 		current.children.move(from, to, count)
+		current.invalidateLayout()
 	}
 
 	override fun onClear() {}
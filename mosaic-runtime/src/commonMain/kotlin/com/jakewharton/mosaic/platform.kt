@@ -1,7 +1,5 @@
 package com.jakewharton.mosaic
 
-internal expect fun platformDisplay(chars: CharSequence)
-
 internal expect class AtomicBoolean
 
 internal expect inline fun AtomicBoolean.set(value: Boolean)
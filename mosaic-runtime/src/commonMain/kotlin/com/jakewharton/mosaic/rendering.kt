@@ -1,7 +1,10 @@
 package com.jakewharton.mosaic
 
+import androidx.collection.ObjectList
 import androidx.collection.mutableObjectListOf
 import com.jakewharton.mosaic.layout.MosaicNode
+import com.jakewharton.mosaic.terminal.CellGrid
+import com.jakewharton.mosaic.terminal.StdoutWriter
 import com.jakewharton.mosaic.ui.AnsiLevel
 import kotlin.time.ExperimentalTime
 import kotlin.time.TimeMark
@@ -15,6 +18,14 @@ internal interface Rendering {
 	 * as implementations are free to reuse buffers across invocations.
 	 */
 	fun render(node: MosaicNode): CharSequence
+
+	/**
+	 * Render [node] and write it to [stdout]. Implementations which produce UTF-8 directly override
+	 * this to skip building a [CharSequence] which would then be encoded again.
+	 */
+	fun renderTo(node: MosaicNode, stdout: StdoutWriter) {
+		stdout.write(render(node))
+	}
 }
 
 @ExperimentalTime
@@ -73,6 +84,7 @@ internal class AnsiRendering(
 ) : Rendering {
 	private val stringBuilder = StringBuilder(100)
 	private val staticSurfaces = mutableObjectListOf<TextSurface>()
+	private val surfacePool = TextSurfacePool(ansiLevel)
 	private var lastHeight = 0
 
 	override fun render(node: MosaicNode): CharSequence {
@@ -81,51 +93,366 @@ internal class AnsiRendering(
 
 			append(ansiBeginSynchronizedUpdate)
 
-			var staleLines = lastHeight
-			repeat(staleLines) {
-				append(cursorUp)
+			node.paintStatics(staticSurfaces, ansiLevel)
+			val surface = node.paint(surfacePool)
+			appendFullFrame(staticSurfaces, surface, lastHeight) { canvas, row ->
+				canvas.appendRowTo(this, row)
 			}
+			staticSurfaces.clear()
 
-			fun appendSurface(canvas: TextSurface) {
-				for (row in 0 until canvas.height) {
-					canvas.appendRowTo(this, row)
-					if (staleLines-- > 0) {
-						// We have previously drawn on this line. Clear the rest to be safe.
-						append(clearLine)
-					}
-					append("\r\n")
+			append(ansiEndSynchronizedUpdate)
+
+			lastHeight = surface.height
+			surfacePool.release(surface)
+		}
+	}
+}
+
+/**
+ * A [Rendering] which retains the cells of the previous frame and, when neither its size changed
+ * nor any static content was emitted, only rewrites the cells which differ.
+ *
+ * When the rows of a frame are those of the previous frame moved up, such as when tailing a log,
+ * the old rows are deleted from the top with a single escape sequence and only the new rows at
+ * the bottom are written.
+ *
+ * Frames are assembled as UTF-8 with rows encoded natively by [CellGrid.encodeRow], and written
+ * to stdout from those bytes by [renderTo].
+ */
+internal class DiffRendering(
+	private val ansiLevel: AnsiLevel = AnsiLevel.TRUECOLOR,
+) : Rendering {
+	private val output = Utf8Builder()
+	private val staticSurfaces = mutableObjectListOf<TextSurface>()
+	private val surfacePool = TextSurfacePool(ansiLevel)
+	private var lastSurface: TextSurface? = null
+	private var scrolledSurface: TextSurface? = null
+	private var runs = IntArray(0)
+	private var lastRowHashes = IntArray(0)
+	private var rowHashes = IntArray(0)
+
+	override fun render(node: MosaicNode): CharSequence {
+		return renderFrame(node).toString()
+	}
+
+	override fun renderTo(node: MosaicNode, stdout: StdoutWriter) {
+		val output = renderFrame(node)
+		stdout.write(output.bytes, 0, output.size)
+	}
+
+	/** Render [node] into a buffer which is only valid until the next call. */
+	fun renderFrame(node: MosaicNode): Utf8Builder {
+		return output.apply {
+			clear()
+
+			append(ansiBeginSynchronizedUpdate)
+
+			node.paintStatics(staticSurfaces, ansiLevel)
+			val surface = node.paint(surfacePool)
+
+			val lastSurface = lastSurface
+			if (lastSurface != null &&
+				staticSurfaces.isEmpty() &&
+				surface.width == lastSurface.width &&
+				surface.height == lastSurface.height
+			) {
+				appendChangedCells(lastSurface, surface)
+			} else {
+				appendFullFrame(staticSurfaces, surface, lastSurface?.height ?: 0) { canvas, row ->
+					canvas.encodeRowTo(this, row)
 				}
+				staticSurfaces.clear()
 			}
 
-			staticSurfaces.let { staticSurfaces ->
-				node.paintStatics(staticSurfaces, ansiLevel)
-				if (staticSurfaces.isNotEmpty()) {
-					staticSurfaces.forEach { staticSurface ->
-						appendSurface(staticSurface)
+			append(ansiEndSynchronizedUpdate)
+
+			if (lastSurface != null) {
+				surfacePool.release(lastSurface)
+			}
+			this@DiffRendering.lastSurface = surface
+		}
+	}
+
+	private fun Utf8Builder.appendChangedCells(lastSurface: TextSurface, surface: TextSurface) {
+		val width = surface.width
+		val height = surface.height
+
+		val runsSize = CellGrid.runsSize(width, height)
+		if (runs.size < runsSize) {
+			runs = IntArray(runsSize)
+		}
+		var runCount = CellGrid.diff(lastSurface.cells, surface.cells, width, height, diffMergeGap, runs)
+		if (runCount == 0) return
+
+		// The cursor rests at the start of the line below the previous output.
+		var cursorRow = height
+
+		// Scrolling only helps when it leaves fewer rows to rewrite than the diff already found.
+		val scroll = scrollAmount(lastSurface, surface, maxScroll = changedRowCount(runCount) - 1)
+		if (scroll > 0) {
+			// Deleting lines at the top of the output moves the lines below up and inserts blank lines
+			// at the bottom of the screen. Compare against what the terminal will show afterward.
+			val scrolledSurface = scrolledSurface(lastSurface, scroll)
+			runCount = CellGrid.diff(scrolledSurface.cells, surface.cells, width, height, diffMergeGap, runs)
+
+			appendCursorMove(height, cursorUpCode)
+			appendCursorMove(scroll, deleteLinesCode)
+			cursorRow = 0
+		}
+
+		for (i in 0 until runCount) {
+			val row = runs[i * 3]
+			var startColumn = runs[i * 3 + 1]
+			val endColumn = runs[i * 3 + 2]
+			// The right half of a wide character cannot be written on its own.
+			if (startColumn > 0 &&
+				surface.cells[(row * width + startColumn) * CellGrid.CellWords] == CellGrid.WideContinuation
+			) {
+				startColumn--
+			}
+
+			if (row < cursorRow) {
+				appendCursorMove(cursorRow - row, cursorUpCode)
+			} else if (row > cursorRow) {
+				appendCursorMove(row - cursorRow, cursorDownCode)
+			}
+			appendCursorMove(startColumn + 1, cursorColumnCode)
+			surface.encodeRowTo(this, row, startColumn, endColumn)
+			cursorRow = row
+		}
+
+		appendCursorMove(height - cursorRow, cursorDownCode)
+		append('\r')
+	}
+
+	private fun Utf8Builder.appendCursorMove(amount: Int, code: Char) {
+		append(CSI)
+		append(amount)
+		append(code)
+	}
+
+	/** The number of distinct rows among the first [runCount] entries of [runs]. */
+	private fun changedRowCount(runCount: Int): Int {
+		var count = 0
+		var lastRow = -1
+		for (i in 0 until runCount) {
+			val row = runs[i * 3]
+			if (row != lastRow) {
+				count++
+				lastRow = row
+			}
+		}
+		return count
+	}
+
+	/**
+	 * The smallest number of rows, at most [maxScroll], by which [lastSurface] moved up to produce
+	 * the top rows of [surface], or 0 if it did not.
+	 *
+	 * Candidates are compared by row hash so that each costs one pass over the rows rather than
+	 * over the cells. Only a candidate whose hashes all match has its cells compared.
+	 */
+	private fun scrollAmount(lastSurface: TextSurface, surface: TextSurface, maxScroll: Int): Int {
+		if (maxScroll <= 0) return 0
+
+		val height = surface.height
+		val rowWords = surface.width * CellGrid.CellWords
+		if (rowHashes.size < height) {
+			lastRowHashes = IntArray(height)
+			rowHashes = IntArray(height)
+		}
+		val lastRowHashes = lastRowHashes
+		val rowHashes = rowHashes
+		for (row in 0 until height) {
+			lastRowHashes[row] = rowHash(lastSurface.cells, row, rowWords)
+			rowHashes[row] = rowHash(surface.cells, row, rowWords)
+		}
+
+		for (scroll in 1..minOf(maxScroll, height - 1)) {
+			var matches = true
+			for (row in 0 until height - scroll) {
+				if (rowHashes[row] != lastRowHashes[row + scroll]) {
+					matches = false
+					break
+				}
+			}
+			if (matches) {
+				for (row in 0 until height - scroll) {
+					if (!rowEquals(surface.cells, row, lastSurface.cells, row + scroll, rowWords)) {
+						matches = false
+						break
 					}
-					staticSurfaces.clear()
+				}
+				if (matches) {
+					return scroll
 				}
 			}
+		}
+		return 0
+	}
 
-			val surface = node.paint(ansiLevel)
-			appendSurface(surface)
+	private fun rowHash(cells: IntArray, row: Int, rowWords: Int): Int {
+		val start = row * rowWords
+		var hash = 0
+		for (i in start until start + rowWords) {
+			hash = 31 * hash + cells[i]
+		}
+		return hash
+	}
 
-			// If the new output contains fewer lines than the last output, clear those old lines.
-			for (i in 0 until staleLines) {
-				if (i > 0) {
-					append("\r\n")
-				}
+	private fun rowEquals(
+		cells: IntArray,
+		row: Int,
+		otherCells: IntArray,
+		otherRow: Int,
+		rowWords: Int,
+	): Boolean {
+		val start = row * rowWords
+		val otherStart = otherRow * rowWords
+		for (i in 0 until rowWords) {
+			if (cells[start + i] != otherCells[otherStart + i]) return false
+		}
+		return true
+	}
+
+	/** The cells of [lastSurface] moved up by [scroll] rows with blank rows below. */
+	private fun scrolledSurface(lastSurface: TextSurface, scroll: Int): TextSurface {
+		val width = lastSurface.width
+		val height = lastSurface.height
+		val surface = scrolledSurface
+			?.takeIf { it.width == width && it.height == height }
+			?.apply { clear() }
+			?: TextSurface(width, height, ansiLevel).also { scrolledSurface = it }
+		val rowWords = width * CellGrid.CellWords
+		lastSurface.cells.copyInto(surface.cells, 0, scroll * rowWords, height * rowWords)
+		return surface
+	}
+}
+
+/**
+ * Unchanged cells between two changed cells on the same row are rewritten rather than skipped
+ * when the gap is at most this wide. A cursor move costs about as many bytes.
+ */
+private const val diffMergeGap = 4
+
+private fun <T : Appendable> T.appendFullFrame(
+	staticSurfaces: ObjectList<TextSurface>,
+	surface: TextSurface,
+	lastHeight: Int,
+	appendRow: T.(canvas: TextSurface, row: Int) -> Unit,
+) {
+	var staleLines = lastHeight
+	repeat(staleLines) {
+		append(cursorUp)
+	}
+
+	fun appendSurface(canvas: TextSurface) {
+		for (row in 0 until canvas.height) {
+			appendRow(canvas, row)
+			if (staleLines-- > 0) {
+				// We have previously drawn on this line. Clear the rest to be safe.
 				append(clearLine)
 			}
+			append("\r\n")
+		}
+	}
 
-			// Move cursor back up to end of the new output.
-			repeat(staleLines - 1) {
-				append(cursorUp)
-			}
+	staticSurfaces.forEach { staticSurface ->
+		appendSurface(staticSurface)
+	}
 
-			append(ansiEndSynchronizedUpdate)
+	appendSurface(surface)
 
-			lastHeight = surface.height
+	// If the new output contains fewer lines than the last output, clear those old lines.
+	for (i in 0 until staleLines) {
+		if (i > 0) {
+			append("\r\n")
+		}
+		append(clearLine)
+	}
+
+	// Move cursor back up to end of the new output.
+	repeat(staleLines - 1) {
+		append(cursorUp)
+	}
+}
+
+/**
+ * A reusable buffer of UTF-8 bytes which frames are assembled into, so that rows encoded natively
+ * by [CellGrid.encodeRow] reach stdout without being decoded to UTF-16 and encoded again.
+ */
+internal class Utf8Builder : Appendable {
+	var bytes = ByteArray(1024)
+		private set
+
+	/** The number of bytes of [bytes] which have been written. */
+	var size = 0
+		private set
+
+	fun clear() {
+		size = 0
+	}
+
+	private fun ensureCapacity(count: Int) {
+		val required = size + count
+		if (required > bytes.size) {
+			bytes = bytes.copyOf(maxOf(required, bytes.size * 2))
+		}
+	}
+
+	/** Encode [count] cells of [cells] starting at cell [offset] with [CellGrid.encodeRow]. */
+	fun appendCells(cells: IntArray, offset: Int, count: Int, colorLevel: Int) {
+		ensureCapacity(CellGrid.encodedRowCapacity(count))
+		size += CellGrid.encodeRow(cells, offset, count, colorLevel, bytes, size)
+	}
+
+	fun append(value: Int): Utf8Builder {
+		return append(value.toString())
+	}
+
+	override fun append(value: Char): Utf8Builder {
+		// Each UTF-16 char encodes to at most three UTF-8 bytes.
+		ensureCapacity(3)
+		val code = value.code
+		if (code < 0x80) {
+			bytes[size++] = code.toByte()
+		} else if (code < 0x800) {
+			bytes[size++] = (0xC0 or (code shr 6)).toByte()
+			bytes[size++] = (0x80 or (code and 0x3F)).toByte()
+		} else if (value.isSurrogate()) {
+			// Pairs are combined by the CharSequence overloads. Match the JVM encoder's replacement.
+			bytes[size++] = '?'.code.toByte()
+		} else {
+			bytes[size++] = (0xE0 or (code shr 12)).toByte()
+			bytes[size++] = (0x80 or ((code shr 6) and 0x3F)).toByte()
+			bytes[size++] = (0x80 or (code and 0x3F)).toByte()
 		}
+		return this
 	}
+
+	override fun append(value: CharSequence?): Utf8Builder {
+		val chars = value ?: "null"
+		return append(chars, 0, chars.length)
+	}
+
+	override fun append(value: CharSequence?, startIndex: Int, endIndex: Int): Utf8Builder {
+		val chars = value ?: "null"
+		var index = startIndex
+		while (index < endIndex) {
+			val char = chars[index++]
+			if (char.isHighSurrogate() && index < endIndex && chars[index].isLowSurrogate()) {
+				val codePoint = ((char.code - 0xD800) shl 10) + (chars[index++].code - 0xDC00) + 0x10000
+				ensureCapacity(4)
+				bytes[size++] = (0xF0 or (codePoint shr 18)).toByte()
+				bytes[size++] = (0x80 or ((codePoint shr 12) and 0x3F)).toByte()
+				bytes[size++] = (0x80 or ((codePoint shr 6) and 0x3F)).toByte()
+				bytes[size++] = (0x80 or (codePoint and 0x3F)).toByte()
+			} else {
+				append(char)
+			}
+		}
+		return this
+	}
+
+	override fun toString(): String = bytes.decodeToString(0, size)
 }
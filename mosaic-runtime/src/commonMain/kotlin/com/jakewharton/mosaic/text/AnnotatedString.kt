@@ -21,6 +21,9 @@ public class AnnotatedString internal constructor(
 	public val spanStyles: List<Range<SpanStyle>>
 		get() = spanStylesOrNull ?: emptyList()
 
+	/** Resolves the styles of each character when drawing without filtering [spanStyles]. */
+	internal val spanStyleIndex: SpanStyleIndex? = spanStylesOrNull?.let(::SpanStyleIndex)
+
 	override val length: Int
 		get() = text.length
 
@@ -344,60 +347,6 @@ private fun <T> filterRanges(
 	}.ifEmpty { null }
 }
 
-/**
- * Helper function used to find the [SpanStyle]s in the given range.
- *
- * @param start The start index of the range, inclusive
- * @param end The end index of the range, exclusive
- * @return The list of [SpanStyle]s in the given range
- */
-internal fun AnnotatedString.getLocalRawSpanStyles(
-	start: Int,
-	end: Int,
-): List<SpanStyle> {
-	require(start <= end) { "start ($start) should be less than or equal to end ($end)" }
-	val nonNullRange = spanStylesOrNull ?: return emptyList()
-
-	return nonNullRange.filter { intersect(start, end, it.start, it.end) }.map { it.item }
-}
-
-/**
- * Splits this [AnnotatedString] to a list of [AnnotatedString]s around occurrences
- * of the specified [delimiter].
- * This is specialized version of split which receives single non-empty delimiter
- * and offers better performance.
- *
- * @param delimiter String used as delimiter
- * @param ignoreCase `true` to ignore character case when matching a delimiter. By default `false`.
- * @param limit The maximum number of substrings to return.
- */
-internal fun AnnotatedString.split(
-	delimiter: String,
-	ignoreCase: Boolean = false,
-	limit: Int = 0,
-): List<AnnotatedString> {
-	require(limit >= 0) { "Limit must be non-negative, but was $limit" }
-
-	var currentOffset = 0
-	var nextIndex = indexOf(delimiter, currentOffset, ignoreCase)
-	if (nextIndex == -1 || limit == 1) {
-		return listOf(this)
-	}
-
-	val isLimited = limit > 0
-	val result = ArrayList<AnnotatedString>(if (isLimited) limit.coerceAtMost(10) else 10)
-	do {
-		result.add(subSequence(currentOffset, nextIndex))
-		currentOffset = nextIndex + delimiter.length
-		// Do not search for next occurrence if we're reaching limit
-		if (isLimited && result.size == limit - 1) break
-		nextIndex = indexOf(delimiter, currentOffset, ignoreCase)
-	} while (nextIndex != -1)
-
-	result.add(subSequence(currentOffset, length))
-	return result
-}
-
 /**
  * Pushes [style] to the [AnnotatedString.Builder], executes [block] and then pops the [style].
  *
@@ -0,0 +1,140 @@
+package com.jakewharton.mosaic.text
+
+import com.jakewharton.mosaic.ui.Color
+import com.jakewharton.mosaic.ui.TextStyle
+import com.jakewharton.mosaic.ui.isSpecifiedColor
+import com.jakewharton.mosaic.ui.isSpecifiedTextStyle
+
+/**
+ * Resolves the [SpanStyle] attributes which apply to a range of an [AnnotatedString] without
+ * filtering its span list.
+ *
+ * The starts and ends of all spans split the text into segments within which the same spans
+ * apply. Later spans take precedence over earlier ones, so for each segment only the index of the
+ * last span specifying each attribute is kept.
+ *
+ * Ranges are expected to be queried in increasing order. The first is found with [segmentAt] and
+ * each query returns a segment from which the next one can resume, so a line is resolved in a
+ * single pass no matter how far into the text it starts.
+ */
+internal class SpanStyleIndex(
+	private val spans: List<AnnotatedString.Range<SpanStyle>>,
+) {
+	/** Sorted distinct offsets. Segment `n` covers `boundaries[n]` until `boundaries[n + 1]`. */
+	private val boundaries: IntArray
+
+	/** For each segment, the index of the last span specifying a color, background, and text style. */
+	private val segmentSpans: IntArray
+
+	/** The number of segments. */
+	private val segmentCount: Int
+
+	init {
+		val offsets = IntArray(spans.size * 2)
+		spans.forEachIndexed { index, span ->
+			offsets[index * 2] = span.start
+			offsets[index * 2 + 1] = span.coveredEnd
+		}
+		offsets.sort()
+		var count = 0
+		for (offset in offsets) {
+			if (count == 0 || offsets[count - 1] != offset) {
+				offsets[count++] = offset
+			}
+		}
+		boundaries = offsets.copyOf(count)
+		segmentCount = maxOf(count - 1, 0)
+
+		segmentSpans = IntArray(segmentCount * segmentWords) { noSpan }
+		spans.forEachIndexed { index, span ->
+			val style = span.item
+			var segment = boundaryIndex(span.start)
+			val end = span.coveredEnd
+			while (boundaries[segment] < end) {
+				val word = segment * segmentWords
+				if (style.color.isSpecifiedColor) {
+					segmentSpans[word + colorWord] = index
+				}
+				if (style.background.isSpecifiedColor) {
+					segmentSpans[word + backgroundWord] = index
+				}
+				if (style.textStyle.isSpecifiedTextStyle) {
+					segmentSpans[word + textStyleWord] = index
+				}
+				segment++
+			}
+		}
+	}
+
+	/**
+	 * Returns the first segment at or after [segment] which ends after [offset]. Pass the result to
+	 * [color], [background], and [textStyle] to resolve a range starting at [offset].
+	 */
+	fun seek(offset: Int, segment: Int): Int {
+		var current = segment
+		while (current < segmentCount && boundaries[current + 1] <= offset) {
+			current++
+		}
+		return current
+	}
+
+	/** Returns the segment which ends after [offset]. Equivalent to `seek(offset, 0)`. */
+	fun segmentAt(offset: Int): Int {
+		if (segmentCount == 0 || offset < boundaries[0]) return 0
+		if (offset >= boundaries[segmentCount]) return segmentCount
+		// The boundary before the first one after offset starts the segment.
+		return boundaryIndex(offset + 1) - 1
+	}
+
+	/** The color of the last span covering any of [segment] until [end]. */
+	fun color(segment: Int, end: Int): Color {
+		val span = lastSpan(segment, end, colorWord)
+		return if (span == noSpan) Color.Unspecified else spans[span].item.color
+	}
+
+	/** The background of the last span covering any of [segment] until [end]. */
+	fun background(segment: Int, end: Int): Color {
+		val span = lastSpan(segment, end, backgroundWord)
+		return if (span == noSpan) Color.Unspecified else spans[span].item.background
+	}
+
+	/** The text style of the last span covering any of [segment] until [end]. */
+	fun textStyle(segment: Int, end: Int): TextStyle {
+		val span = lastSpan(segment, end, textStyleWord)
+		return if (span == noSpan) TextStyle.Unspecified else spans[span].item.textStyle
+	}
+
+	private fun lastSpan(segment: Int, end: Int, word: Int): Int {
+		var span = noSpan
+		var current = segment
+		while (current < segmentCount && boundaries[current] < end) {
+			span = maxOf(span, segmentSpans[current * segmentWords + word])
+			current++
+		}
+		return span
+	}
+
+	private fun boundaryIndex(offset: Int): Int {
+		var low = 0
+		var high = boundaries.size - 1
+		while (low < high) {
+			val middle = (low + high) ushr 1
+			if (boundaries[middle] < offset) {
+				low = middle + 1
+			} else {
+				high = middle
+			}
+		}
+		return low
+	}
+}
+
+private const val noSpan = -1
+private const val segmentWords = 3
+private const val colorWord = 0
+private const val backgroundWord = 1
+private const val textStyleWord = 2
+
+/** An empty span still applies to the character at its start. */
+private val AnnotatedString.Range<*>.coveredEnd: Int
+	get() = if (start == end) start + 1 else end
@@ -1,7 +1,14 @@
 package com.jakewharton.mosaic.text
 
-import de.cketti.codepoints.codePointCount
+import com.jakewharton.mosaic.terminal.UnicodeWidth
 
+/**
+ * Splits a value into lines and measures them in terminal cells.
+ *
+ * Lines are not copied out of the value. Instead, their offsets are recorded and are available
+ * through [lineStart] and [lineEnd]. When a new value only appends to the previously-measured one,
+ * only its last line and the appended text are measured again.
+ */
 internal abstract class TextLayout<T : CharSequence>(initialValue: T) {
 
 	var value: T = initialValue
@@ -12,47 +19,82 @@ internal abstract class TextLayout<T : CharSequence>(initialValue: T) {
 			}
 		}
 
-	var width: Int = -1
-		private set
+	val width: Int
 		get() {
 			check(!dirty) { "Missing call to measure()" }
-			return field
+			return measuredWidth
 		}
 
-	var height: Int = -1
-		private set
+	val height: Int
 		get() {
 			check(!dirty) { "Missing call to measure()" }
-			return field
-		}
-
-	var lines: List<T> = emptyList()
-		private set
-		get() {
-			check(!dirty) { "Missing call to measure()" }
-			return field
+			return measuredHeight
 		}
 
 	private var dirty = true
 
+	/** The text of the value for which [lineStarts] were computed. */
+	private var measuredText: String? = null
+	private var measuredWidth = -1
+	private var measuredHeight = -1
+	private var lineStarts = IntArray(1)
+
+	/** The inclusive offset in [value] at which [line] starts. */
+	fun lineStart(line: Int): Int {
+		check(!dirty) { "Missing call to measure()" }
+		return lineStarts[line]
+	}
+
+	/** The exclusive offset in [value] at which [line] ends, not including its line break. */
+	fun lineEnd(line: Int): Int {
+		check(!dirty) { "Missing call to measure()" }
+		return if (line + 1 < measuredHeight) lineStarts[line + 1] - 1 else measuredText!!.length
+	}
+
 	fun measure() {
 		if (!dirty) return
 
-		val lines = value.splitByLines()
-		width = lines.maxOf { it.codePointCount(0, it.length) }
-		height = lines.size
-		this.lines = lines
+		val text = value.string
+		val previousText = measuredText
+		if (previousText != null && text.startsWith(previousText)) {
+			// The last line may have grown, so measure from its start. Since lines only grow when
+			// appending, the previous maximum width remains a lower bound.
+			measureFrom(text, line = measuredHeight - 1, maxWidth = measuredWidth)
+		} else {
+			measureFrom(text, line = 0, maxWidth = 0)
+		}
+		measuredText = text
 		dirty = false
 	}
 
-	protected abstract fun T.splitByLines(): List<T>
+	private fun measureFrom(text: String, line: Int, maxWidth: Int) {
+		var currentLine = line
+		var currentMaxWidth = maxWidth
+		var lineStart = lineStarts[line]
+		while (true) {
+			val lineBreak = text.indexOf('\n', lineStart)
+			val lineEnd = if (lineBreak == -1) text.length else lineBreak
+			currentMaxWidth = maxOf(currentMaxWidth, UnicodeWidth.of(text, lineStart, lineEnd))
+			if (lineBreak == -1) break
+
+			lineStart = lineBreak + 1
+			currentLine++
+			if (currentLine == lineStarts.size) {
+				lineStarts = lineStarts.copyOf(currentLine * 2)
+			}
+			lineStarts[currentLine] = lineStart
+		}
+		measuredWidth = currentMaxWidth
+		measuredHeight = currentLine + 1
+	}
+
+	protected abstract val T.string: String
 }
 
 internal class StringTextLayout : TextLayout<String>(initialValue = "") {
 
-	override fun String.splitByLines(): List<String> {
-		return this.split("\n")
-	}
+	override val String.string: String
+		get() = this
 }
 
 internal class AnnotatedStringTextLayout :
@@ -60,7 +102,6 @@ internal class AnnotatedStringTextLayout :
 		initialValue = emptyAnnotatedString(),
 	) {
 
-	override fun AnnotatedString.splitByLines(): List<AnnotatedString> {
-		return this.split("\n")
-	}
+	override val AnnotatedString.string: String
+		get() = text
 }
@@ -32,8 +32,11 @@ public fun Text(
 			layout(layout.width, layout.height)
 		},
 		modifier = modifier.drawBehind {
-			layout.lines.forEachIndexed { row, line ->
-				drawText(row, 0, line, color, background, textStyle)
+			val string = layout.value
+			for (row in 0 until layout.height) {
+				val start = layout.lineStart(row)
+				val end = layout.lineEnd(row)
+				drawText(row, 0, string, start, end, color, background, textStyle)
 			}
 		},
 	)
@@ -60,8 +63,11 @@ public fun Text(
 			layout(layout.width, layout.height)
 		},
 		modifier = modifier.drawBehind {
-			layout.lines.forEachIndexed { row, line ->
-				drawText(row, 0, line, color, background, textStyle)
+			val string = layout.value
+			for (row in 0 until layout.height) {
+				val start = layout.lineStart(row)
+				val end = layout.lineEnd(row)
+				drawText(row, 0, string, start, end, color, background, textStyle)
 			}
 		},
 	)
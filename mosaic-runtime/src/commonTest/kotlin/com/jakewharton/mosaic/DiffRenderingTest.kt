@@ -0,0 +1,185 @@
+package com.jakewharton.mosaic
+
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.ui.Column
+import com.jakewharton.mosaic.ui.Static
+import com.jakewharton.mosaic.ui.Text
+import kotlin.test.Test
+
+class DiffRenderingTest {
+	private val rendering = DiffRendering()
+
+	@Test fun firstRender() {
+		val rootNode = renderMosaicNode {
+			Column {
+				Text("Hello")
+				Text("World!")
+			}
+		}
+
+		assertThat(rendering.render(rootNode).toString()).isEqualTo(
+			"""
+			|Hello$s
+			|World!
+			|
+			""".trimMargin().wrapWithAnsiSynchronizedUpdate().replaceLineEndingsWithCRLF(),
+		)
+	}
+
+	@Test fun identicalRenderWritesNothing() {
+		val firstRootNode = renderMosaicNode {
+			Text("Hello")
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Text("Hello")
+		}
+		assertThat(rendering.render(secondRootNode).toString())
+			.isEqualTo("".wrapWithAnsiSynchronizedUpdate())
+	}
+
+	@Test fun onlyChangedCellsRewritten() {
+		val firstRootNode = renderMosaicNode {
+			Column {
+				Text("The count is: 9")
+				Text("Unchanged")
+			}
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Column {
+				Text("The count is: 8")
+				Text("Unchanged")
+			}
+		}
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"${CSI}2A${CSI}15G8${CSI}2B\r".wrapWithAnsiSynchronizedUpdate(),
+		)
+	}
+
+	@Test fun nearbyChangesMerged() {
+		val firstRootNode = renderMosaicNode {
+			Text("a-b--------c")
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Text("A-B--------C")
+		}
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"${CSI}1A${CSI}1GA-B${CSI}12GC${CSI}1B\r".wrapWithAnsiSynchronizedUpdate(),
+		)
+	}
+
+	@Test fun changesOnMultipleRows() {
+		val firstRootNode = renderMosaicNode {
+			Column {
+				Text("One 1")
+				Text("Two 2")
+				Text("Six 3")
+			}
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Column {
+				Text("One 4")
+				Text("Two 2")
+				Text("Six 6")
+			}
+		}
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"${CSI}3A${CSI}5G4${CSI}2B${CSI}5G6${CSI}1B\r".wrapWithAnsiSynchronizedUpdate(),
+		)
+	}
+
+	@Test fun rowsMovedUpAreScrolled() {
+		val firstRootNode = renderMosaicNode {
+			Column {
+				Text("one")
+				Text("two")
+				Text("six")
+			}
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Column {
+				Text("two")
+				Text("six")
+				Text("ten")
+			}
+		}
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"${CSI}3A${CSI}1M${CSI}2B${CSI}1Gten${CSI}1B\r".wrapWithAnsiSynchronizedUpdate(),
+		)
+	}
+
+	@Test fun scrollingNotUsedWhenFewerRowsChange() {
+		val firstRootNode = renderMosaicNode {
+			Column {
+				Text("a")
+				Text("a")
+				Text("a")
+			}
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Column {
+				Text("a")
+				Text("a")
+				Text("b")
+			}
+		}
+		// Scrolling by one row would also need one row written.
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"${CSI}1A${CSI}1Gb${CSI}1B\r".wrapWithAnsiSynchronizedUpdate(),
+		)
+	}
+
+	@Test fun sizeChangeRedrawsEverything() {
+		val firstRootNode = renderMosaicNode {
+			Text("Hello")
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Column {
+				Text("Hello")
+				Text("World!")
+			}
+		}
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"""
+			|${cursorUp}Hello $clearLine
+			|World!
+			|
+			""".trimMargin().wrapWithAnsiSynchronizedUpdate().replaceLineEndingsWithCRLF(),
+		)
+	}
+
+	@Test fun staticRedrawsEverything() {
+		val firstRootNode = renderMosaicNode {
+			Text("Two")
+		}
+		rendering.render(firstRootNode)
+
+		val secondRootNode = renderMosaicNode {
+			Static(snapshotStateListOf("One")) {
+				Text(it)
+			}
+			Text("Two")
+		}
+		assertThat(rendering.render(secondRootNode).toString()).isEqualTo(
+			"""
+			|${cursorUp}One$clearLine
+			|Two
+			|
+			""".trimMargin().wrapWithAnsiSynchronizedUpdate().replaceLineEndingsWithCRLF(),
+		)
+	}
+}
@@ -0,0 +1,94 @@
+package com.jakewharton.mosaic
+
+import androidx.compose.runtime.LaunchedEffect
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableIntStateOf
+import androidx.compose.runtime.remember
+import androidx.compose.runtime.setValue
+import androidx.compose.runtime.withFrameNanos
+import assertk.assertFailure
+import assertk.assertThat
+import assertk.assertions.containsExactly
+import assertk.assertions.isEqualTo
+import assertk.assertions.isInstanceOf
+import com.jakewharton.mosaic.layout.KeyEvent
+import com.jakewharton.mosaic.layout.onKeyEvent
+import com.jakewharton.mosaic.modifier.Modifier
+import com.jakewharton.mosaic.ui.Text
+import kotlin.test.Test
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.channels.Channel.Factory.UNLIMITED
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.advanceUntilIdle
+import kotlinx.coroutines.test.currentTime
+import kotlinx.coroutines.test.runTest
+
+@OptIn(ExperimentalCoroutinesApi::class)
+class FrameSchedulingTest {
+	private val inputEvents = Channel<Any>(UNLIMITED)
+	private val drawTimes = mutableListOf<Long>()
+
+	private fun TestScope.createComposition(): MosaicComposition {
+		return createTestComposition(
+			inputEvents = inputEvents,
+			maxFps = 10,
+			frameCoalesceMillis = 4,
+			onDraw = { drawTimes += currentTime },
+		)
+	}
+
+	@Test fun idleContentSchedulesNothing() = runTest {
+		val composition = createComposition()
+		composition.setContent {
+			Text("Hello")
+		}
+		composition.sendFrames()
+
+		advanceUntilIdle()
+		assertThat(currentTime).isEqualTo(0L)
+		assertThat(drawTimes).containsExactly(0L)
+	}
+
+	@Test fun framesCoalescedAndLimitedToMaxFps() = runTest {
+		val composition = createComposition()
+		val frameTimes = mutableListOf<Long>()
+		composition.setContent {
+			LaunchedEffect(Unit) {
+				repeat(3) {
+					withFrameNanos { frameTimes += currentTime }
+				}
+			}
+		}
+		composition.sendFrames()
+
+		advanceUntilIdle()
+		assertThat(frameTimes).containsExactly(4L, 104L, 204L)
+	}
+
+	@Test fun inputRendersAfterCoalesceDelay() = runTest {
+		val composition = createComposition()
+		composition.setContent {
+			var count by remember { mutableIntStateOf(0) }
+			Text(
+				"count: $count",
+				modifier = Modifier.onKeyEvent {
+					count++
+					true
+				},
+			)
+		}
+		composition.sendFrames()
+		advanceUntilIdle()
+
+		inputEvents.trySend(KeyEvent("a"))
+		advanceUntilIdle()
+		assertThat(drawTimes).containsExactly(0L, 4L)
+	}
+
+	@Test fun maxFpsMustBePositive() = runTest {
+		assertFailure {
+			createTestComposition(maxFps = 0)
+		}.isInstanceOf<IllegalArgumentException>()
+	}
+}
@@ -0,0 +1,40 @@
+package com.jakewharton.mosaic
+
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.layout.KeyEvent
+import com.jakewharton.mosaic.terminal.InputEvent
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyCodePoint
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyF1
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyUp
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.ModifierCtrl
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.ModifierShift
+import kotlin.test.Test
+
+class InputTest {
+	private fun inputEvent(key: Int, modifiers: Int = 0, codePoint: Int = 0): InputEvent {
+		return InputEvent(key.toLong() or (modifiers.toLong() shl 16) or (codePoint.toLong() shl 32))
+	}
+
+	@Test fun ascii() {
+		assertThat(inputEvent(KeyCodePoint, codePoint = 'q'.code).toKeyEvent())
+			.isEqualTo(KeyEvent("q"))
+	}
+
+	@Test fun ctrlC() {
+		assertThat(inputEvent(KeyCodePoint, ModifierCtrl, 'c'.code).toKeyEvent())
+			.isEqualTo(KeyEvent("c", ctrl = true))
+	}
+
+	@Test fun supplementaryCodePoint() {
+		assertThat(inputEvent(KeyCodePoint, codePoint = 0x1F600).toKeyEvent())
+			.isEqualTo(KeyEvent("😀"))
+	}
+
+	@Test fun namedKeys() {
+		assertThat(inputEvent(KeyUp, ModifierShift).toKeyEvent())
+			.isEqualTo(KeyEvent("ArrowUp", shift = true))
+		assertThat(inputEvent(KeyF1 + 11).toKeyEvent())
+			.isEqualTo(KeyEvent("F12"))
+	}
+}
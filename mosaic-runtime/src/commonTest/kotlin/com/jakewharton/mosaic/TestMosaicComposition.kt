@@ -5,6 +5,7 @@ import androidx.compose.runtime.MutableState
 import androidx.compose.runtime.mutableStateOf
 import com.jakewharton.mosaic.layout.KeyEvent
 import com.jakewharton.mosaic.layout.MosaicNode
+import com.jakewharton.mosaic.layout.PasteEvent
 import com.jakewharton.mosaic.ui.AnsiLevel
 import com.jakewharton.mosaic.ui.unit.IntSize
 import kotlin.time.Duration
@@ -12,7 +13,9 @@ import kotlin.time.Duration.Companion.seconds
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.channels.Channel.Factory.UNLIMITED
+import kotlinx.coroutines.channels.ReceiveChannel
 import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.test.TestScope
 import kotlinx.coroutines.withTimeout
 
 private val DefaultTestTerminalSize = IntSize(80, 20)
@@ -33,6 +36,27 @@ internal suspend fun runMosaicTest(
 	}
 }
 
+/**
+ * Create a [MosaicComposition] in the [backgroundScope][TestScope.backgroundScope] of a test using
+ * virtual time. Unlike [runMosaicTest], no frames are sent until [MosaicComposition.sendFrames] is
+ * called, so tests can control and observe exactly when work happens.
+ */
+internal fun TestScope.createTestComposition(
+	inputEvents: ReceiveChannel<Any> = Channel(),
+	maxFps: Int = defaultMaxFps,
+	frameCoalesceMillis: Long = defaultFrameCoalesceMillis,
+	onDraw: (MosaicNode) -> Unit = {},
+): MosaicComposition {
+	return MosaicComposition(
+		coroutineScope = backgroundScope,
+		terminalState = mutableStateOf(Terminal(size = DefaultTestTerminalSize)),
+		inputEvents = inputEvents,
+		maxFps = maxFps,
+		frameCoalesceMillis = frameCoalesceMillis,
+		onDraw = onDraw,
+	)
+}
+
 internal interface TestMosaicComposition {
 	fun setContent(content: @Composable () -> Unit)
 
@@ -40,6 +64,8 @@ internal interface TestMosaicComposition {
 
 	fun sendKeyEvent(keyEvent: KeyEvent)
 
+	fun sendPasteEvent(pasteEvent: PasteEvent)
+
 	suspend fun awaitNodeSnapshot(duration: Duration = 1.seconds): MosaicNode
 
 	suspend fun awaitRenderSnapshot(duration: Duration = 1.seconds): String
@@ -71,9 +97,9 @@ private class RealTestMosaicComposition(
 		Terminal(size = initialTerminalSize),
 	)
 
-	private val keyEvents = Channel<KeyEvent>(UNLIMITED)
+	private val inputEvents = Channel<Any>(UNLIMITED)
 
-	val mosaicComposition = MosaicComposition(coroutineScope, terminalState, keyEvents) { rootNode ->
+	val mosaicComposition = MosaicComposition(coroutineScope, terminalState, inputEvents) { rootNode ->
 		nodeSnapshots.trySend(rootNode)
 		val stringRender = if (withAnsi) {
 			rendering.render(rootNode).toString()
@@ -98,7 +124,11 @@ private class RealTestMosaicComposition(
 	}
 
 	override fun sendKeyEvent(keyEvent: KeyEvent) {
-		keyEvents.trySend(keyEvent)
+		inputEvents.trySend(keyEvent)
+	}
+
+	override fun sendPasteEvent(pasteEvent: PasteEvent) {
+		inputEvents.trySend(pasteEvent)
 	}
 
 	override suspend fun awaitNodeSnapshot(duration: Duration): MosaicNode {
@@ -0,0 +1,82 @@
+package com.jakewharton.mosaic
+
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import assertk.assertions.isNotSameInstanceAs
+import assertk.assertions.isSameInstanceAs
+import com.jakewharton.mosaic.ui.AnsiLevel
+import com.jakewharton.mosaic.ui.Color
+import com.jakewharton.mosaic.ui.TextStyle
+import kotlin.test.Test
+
+class TextSurfaceTest {
+	@Test fun accessorWritesCells() {
+		val surface = TextSurface(3, 2, AnsiLevel.NONE)
+		surface[0, 1].codePoint = 'a'.code
+		surface.translationX = 1
+		surface.translationY = 1
+		surface[0, 1].codePoint = 'b'.code
+
+		assertThat(surface.render()).isEqualTo(" a \r\n  b")
+	}
+
+	@Test fun accessorReadsAttributes() {
+		val surface = TextSurface(2, 1, AnsiLevel.TRUECOLOR)
+		surface[0, 0].apply {
+			foreground = Color.Red
+			background = Color.Blue
+			textStyle = TextStyle.Bold
+		}
+
+		val pixel = surface[0, 0]
+		assertThat(pixel.foreground).isEqualTo(Color.Red)
+		assertThat(pixel.background).isEqualTo(Color.Blue)
+		assertThat(pixel.textStyle).isEqualTo(TextStyle.Bold)
+		assertThat(surface[0, 1].foreground).isEqualTo(Color.Unspecified)
+	}
+
+	@Test fun poolReusesSameSizeCleared() {
+		val pool = TextSurfacePool(AnsiLevel.NONE)
+		val first = pool.acquire(2, 1)
+		first[0, 0].codePoint = 'a'.code
+		first.translationX = 1
+		pool.release(first)
+
+		val second = pool.acquire(2, 1)
+		assertThat(second).isSameInstanceAs(first)
+		assertThat(second.translationX).isEqualTo(0)
+		assertThat(second.render()).isEqualTo("  ")
+	}
+
+	@Test fun poolDropsOtherSizes() {
+		val pool = TextSurfacePool(AnsiLevel.NONE)
+		val first = pool.acquire(2, 1)
+		pool.release(first)
+
+		val second = pool.acquire(3, 1)
+		assertThat(second).isNotSameInstanceAs(first)
+		pool.release(second)
+
+		assertThat(pool.acquire(2, 1)).isNotSameInstanceAs(first)
+	}
+
+	@Test fun encodeRowToMatchesAppendRowTo() {
+		val surface = TextSurface(4, 1, AnsiLevel.TRUECOLOR)
+		surface[0, 0].codePoint = 'a'.code
+		surface[0, 1].apply {
+			codePoint = 'é'.code
+			foreground = Color.Red
+			textStyle = TextStyle.Bold
+		}
+		surface[0, 2].codePoint = 0x1F600
+
+		val output = Utf8Builder()
+		output.append("x\uD83D\uDE00")
+		surface.encodeRowTo(output, 0, startColumn = 1)
+
+		val expected = StringBuilder("x\uD83D\uDE00")
+		surface.appendRowTo(expected, 0, startColumn = 1)
+		assertThat(output.toString()).isEqualTo(expected.toString())
+		assertThat(output.size).isEqualTo(expected.toString().encodeToByteArray().size)
+	}
+}
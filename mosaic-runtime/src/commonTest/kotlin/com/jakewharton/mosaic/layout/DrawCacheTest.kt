@@ -0,0 +1,89 @@
+package com.jakewharton.mosaic.layout
+
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableStateOf
+import androidx.compose.runtime.setValue
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.createTestComposition
+import com.jakewharton.mosaic.modifier.Modifier
+import com.jakewharton.mosaic.ui.AnsiLevel
+import com.jakewharton.mosaic.ui.Box
+import com.jakewharton.mosaic.ui.Column
+import com.jakewharton.mosaic.ui.Layout
+import kotlin.test.Test
+import kotlinx.coroutines.test.advanceUntilIdle
+import kotlinx.coroutines.test.runTest
+
+class DrawCacheTest {
+	private var output = ""
+
+	private fun renderOutput(rootNode: MosaicNode) {
+		output = rootNode.paint(AnsiLevel.NONE).render()
+	}
+
+	@Test fun stateReadInDrawOnlyDrawsItsNodeAgain() = runTest {
+		var value by mutableStateOf("a")
+		var tickerDraws = 0
+		var siblingDraws = 0
+
+		val composition = createTestComposition(onDraw = ::renderOutput)
+		composition.setContent {
+			Column {
+				Layout(
+					modifier = Modifier.drawBehind {
+						siblingDraws++
+						drawText(0, 0, "s")
+					},
+					measurePolicy = { layout(1, 1) },
+				)
+				Layout(
+					modifier = Modifier.drawBehind {
+						tickerDraws++
+						drawText(0, 0, value)
+					},
+					measurePolicy = { layout(1, 1) },
+				)
+			}
+		}
+		composition.sendFrames()
+		advanceUntilIdle()
+		assertThat(output).isEqualTo("s\r\na")
+
+		value = "b"
+		advanceUntilIdle()
+		assertThat(output).isEqualTo("s\r\nb")
+		assertThat(tickerDraws).isEqualTo(2)
+		assertThat(siblingDraws).isEqualTo(1)
+	}
+
+	@Test fun changedCellsBeneathDrawAgain() = runTest {
+		var value by mutableStateOf("a")
+		var childDraws = 0
+
+		val composition = createTestComposition(onDraw = ::renderOutput)
+		composition.setContent {
+			Box(
+				modifier = Modifier.drawBehind {
+					drawText(0, 1, value)
+				},
+			) {
+				Layout(
+					modifier = Modifier.drawBehind {
+						childDraws++
+						drawText(0, 0, "x")
+					},
+					measurePolicy = { layout(2, 1) },
+				)
+			}
+		}
+		composition.sendFrames()
+		advanceUntilIdle()
+		assertThat(output).isEqualTo("xa")
+
+		value = "b"
+		advanceUntilIdle()
+		assertThat(output).isEqualTo("xb")
+		assertThat(childDraws).isEqualTo(2)
+	}
+}
@@ -0,0 +1,69 @@
+package com.jakewharton.mosaic.layout
+
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableIntStateOf
+import androidx.compose.runtime.setValue
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.createTestComposition
+import com.jakewharton.mosaic.ui.Column
+import com.jakewharton.mosaic.ui.Layout
+import kotlin.test.Test
+import kotlinx.coroutines.test.advanceUntilIdle
+import kotlinx.coroutines.test.runTest
+
+class MeasureCacheTest {
+	@Test fun stateReadInMeasureOnlyMeasuresItsNodeAgain() = runTest {
+		var width by mutableIntStateOf(1)
+		var tickerMeasures = 0
+		var siblingMeasures = 0
+
+		val composition = createTestComposition()
+		composition.setContent {
+			Column {
+				Layout(measurePolicy = {
+					siblingMeasures++
+					layout(2, 1)
+				})
+				Layout(measurePolicy = {
+					tickerMeasures++
+					layout(width, 1)
+				})
+			}
+		}
+		composition.sendFrames()
+		advanceUntilIdle()
+		assertThat(tickerMeasures).isEqualTo(1)
+		assertThat(siblingMeasures).isEqualTo(1)
+
+		width = 5
+		advanceUntilIdle()
+		assertThat(tickerMeasures).isEqualTo(2)
+		assertThat(siblingMeasures).isEqualTo(1)
+		assertThat(composition.rootNode.width).isEqualTo(5)
+	}
+
+	@Test fun unchangedConstraintsReuseMeasurement() = runTest {
+		var height by mutableIntStateOf(1)
+		var childMeasures = 0
+
+		val composition = createTestComposition()
+		composition.setContent {
+			Column {
+				Layout(measurePolicy = {
+					childMeasures++
+					layout(2, 1)
+				})
+				Layout(measurePolicy = { layout(1, height) })
+			}
+		}
+		composition.sendFrames()
+		advanceUntilIdle()
+
+		// The column measures again but gives its first child the same constraints.
+		height = 3
+		advanceUntilIdle()
+		assertThat(childMeasures).isEqualTo(1)
+		assertThat(composition.rootNode.height).isEqualTo(4)
+	}
+}
@@ -0,0 +1,53 @@
+package com.jakewharton.mosaic.layout
+
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableStateOf
+import androidx.compose.runtime.remember
+import androidx.compose.runtime.setValue
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.modifier.Modifier
+import com.jakewharton.mosaic.runMosaicTest
+import com.jakewharton.mosaic.ui.Text
+import kotlin.test.Test
+import kotlinx.coroutines.test.runTest
+
+class PasteTest {
+	@Test fun pasteDeliveredAsSingleEvent() = runTest {
+		runMosaicTest {
+			setContent {
+				var text by remember { mutableStateOf("empty") }
+				Text(
+					text,
+					modifier = Modifier.onPasteEvent {
+						text = it.text
+						true
+					},
+				)
+			}
+			assertThat(awaitRenderSnapshot()).isEqualTo("empty")
+
+			sendPasteEvent(PasteEvent("x".repeat(1_000)))
+			assertThat(awaitRenderSnapshot()).isEqualTo("x".repeat(1_000))
+		}
+	}
+
+	@Test fun unhandledPasteFallsBackToKeyEvents() = runTest {
+		runMosaicTest {
+			setContent {
+				var text by remember { mutableStateOf("") }
+				Text(
+					"keys:$text",
+					modifier = Modifier.onKeyEvent {
+						text += if (it.key == "Enter") "⏎" else it.key
+						true
+					},
+				)
+			}
+			assertThat(awaitRenderSnapshot()).isEqualTo("keys:")
+
+			sendPasteEvent(PasteEvent("ab\r\nc"))
+			assertThat(awaitRenderSnapshot()).isEqualTo("keys:ab⏎c")
+		}
+	}
+}
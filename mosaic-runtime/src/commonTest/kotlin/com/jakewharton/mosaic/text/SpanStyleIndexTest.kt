@@ -0,0 +1,84 @@
+package com.jakewharton.mosaic.text
+
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.ui.Color
+import com.jakewharton.mosaic.ui.TextStyle
+import kotlin.test.Test
+
+class SpanStyleIndexTest {
+	@Test fun noSpans() {
+		val index = SpanStyleIndex(emptyList())
+		assertThat(index.resolve(0, 1)).isEqualTo(SpanStyle())
+	}
+
+	@Test fun laterSpansTakePrecedence() {
+		val index = SpanStyleIndex(
+			listOf(
+				AnnotatedString.Range(SpanStyle(color = Color.Red, textStyle = TextStyle.Bold), 0, 6),
+				AnnotatedString.Range(SpanStyle(color = Color.Blue), 2, 4),
+			),
+		)
+		assertThat(index.resolve(1, 2)).isEqualTo(SpanStyle(color = Color.Red, textStyle = TextStyle.Bold))
+		assertThat(index.resolve(2, 3)).isEqualTo(SpanStyle(color = Color.Blue, textStyle = TextStyle.Bold))
+		assertThat(index.resolve(4, 5)).isEqualTo(SpanStyle(color = Color.Red, textStyle = TextStyle.Bold))
+		assertThat(index.resolve(6, 7)).isEqualTo(SpanStyle())
+	}
+
+	@Test fun gapBetweenSpans() {
+		val index = SpanStyleIndex(
+			listOf(
+				AnnotatedString.Range(SpanStyle(background = Color.Red), 0, 1),
+				AnnotatedString.Range(SpanStyle(background = Color.Blue), 3, 4),
+			),
+		)
+		assertThat(index.resolve(0, 1)).isEqualTo(SpanStyle(background = Color.Red))
+		assertThat(index.resolve(1, 2)).isEqualTo(SpanStyle())
+		assertThat(index.resolve(3, 4)).isEqualTo(SpanStyle(background = Color.Blue))
+	}
+
+	@Test fun emptySpanAppliesToCharacterAtItsStart() {
+		val index = SpanStyleIndex(
+			listOf(
+				AnnotatedString.Range(SpanStyle(color = Color.Red), 2, 2),
+			),
+		)
+		assertThat(index.resolve(1, 2)).isEqualTo(SpanStyle())
+		assertThat(index.resolve(2, 3)).isEqualTo(SpanStyle(color = Color.Red))
+		assertThat(index.resolve(3, 4)).isEqualTo(SpanStyle())
+	}
+
+	@Test fun rangeCoveringMultipleSegments() {
+		// A surrogate pair spans two offsets which may fall into different segments.
+		val index = SpanStyleIndex(
+			listOf(
+				AnnotatedString.Range(SpanStyle(color = Color.Blue), 0, 1),
+				AnnotatedString.Range(SpanStyle(color = Color.Red, background = Color.Green), 1, 2),
+			),
+		)
+		assertThat(index.resolve(0, 2)).isEqualTo(SpanStyle(color = Color.Red, background = Color.Green))
+	}
+
+	@Test fun segmentAtMatchesSeekFromStart() {
+		val index = SpanStyleIndex(
+			listOf(
+				AnnotatedString.Range(SpanStyle(color = Color.Red), 2, 5),
+				AnnotatedString.Range(SpanStyle(background = Color.Blue), 4, 4),
+				AnnotatedString.Range(SpanStyle(textStyle = TextStyle.Bold), 7, 9),
+			),
+		)
+		for (offset in 0..10) {
+			assertThat(index.segmentAt(offset), name = "offset $offset").isEqualTo(index.seek(offset, 0))
+		}
+		assertThat(SpanStyleIndex(emptyList()).segmentAt(3)).isEqualTo(0)
+	}
+
+	private fun SpanStyleIndex.resolve(start: Int, end: Int): SpanStyle {
+		val segment = segmentAt(start)
+		return SpanStyle(
+			color = color(segment, end),
+			textStyle = textStyle(segment, end),
+			background = background(segment, end),
+		)
+	}
+}
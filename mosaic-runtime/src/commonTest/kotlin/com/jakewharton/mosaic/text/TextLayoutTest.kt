@@ -0,0 +1,63 @@
+package com.jakewharton.mosaic.text
+
+import assertk.assertThat
+import assertk.assertions.containsExactly
+import assertk.assertions.isEqualTo
+import kotlin.test.Test
+
+class TextLayoutTest {
+	private val layout = StringTextLayout()
+
+	@Test fun empty() {
+		layout.measure()
+		assertThat(layout.width).isEqualTo(0)
+		assertThat(layout.height).isEqualTo(1)
+		assertThat(layout.lines()).containsExactly("")
+	}
+
+	@Test fun multipleLines() {
+		layout.value = "one\n\nthree 🙂\n"
+		layout.measure()
+		assertThat(layout.width).isEqualTo(8)
+		assertThat(layout.height).isEqualTo(4)
+		assertThat(layout.lines()).containsExactly("one", "", "three 🙂", "")
+	}
+
+	@Test fun appendExtendsLastLine() {
+		layout.value = "long line\nab"
+		layout.measure()
+		layout.value = "long line\nabc\nd"
+		layout.measure()
+		assertThat(layout.width).isEqualTo(9)
+		assertThat(layout.height).isEqualTo(3)
+		assertThat(layout.lines()).containsExactly("long line", "abc", "d")
+
+		layout.value = "long line\nabc\ndefghijklmnop"
+		layout.measure()
+		assertThat(layout.width).isEqualTo(13)
+		assertThat(layout.height).isEqualTo(3)
+		assertThat(layout.lines()).containsExactly("long line", "abc", "defghijklmnop")
+	}
+
+	@Test fun replacementMeasuresAgain() {
+		layout.value = "long line\nab"
+		layout.measure()
+		layout.value = "a\nbc"
+		layout.measure()
+		assertThat(layout.width).isEqualTo(2)
+		assertThat(layout.height).isEqualTo(2)
+		assertThat(layout.lines()).containsExactly("a", "bc")
+	}
+
+	@Test fun annotatedLinesAreOffsetsIntoValue() {
+		val layout = AnnotatedStringTextLayout()
+		layout.value = AnnotatedString("ab\ncd")
+		layout.measure()
+		assertThat(layout.lineStart(1)).isEqualTo(3)
+		assertThat(layout.lineEnd(1)).isEqualTo(5)
+	}
+
+	private fun TextLayout<String>.lines(): List<String> {
+		return List(height) { value.substring(lineStart(it), lineEnd(it)) }
+	}
+}
@@ -0,0 +1,109 @@
+package com.jakewharton.mosaic.ui
+
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import com.jakewharton.mosaic.TextSurface
+import com.jakewharton.mosaic.layout.TextCanvasDrawScope
+import com.jakewharton.mosaic.layout.drawBehind
+import com.jakewharton.mosaic.layout.width
+import com.jakewharton.mosaic.modifier.Modifier
+import com.jakewharton.mosaic.runMosaicTest
+import com.jakewharton.mosaic.s
+import com.jakewharton.mosaic.text.SpanStyle
+import com.jakewharton.mosaic.text.buildAnnotatedString
+import com.jakewharton.mosaic.text.withStyle
+import kotlin.test.Test
+import kotlinx.coroutines.test.runTest
+
+class TextTest {
+	@Test fun wideCharactersOccupyTwoCells() = runTest {
+		runMosaicTest {
+			setContent {
+				Column {
+					Text("中文")
+					Text("abc")
+				}
+			}
+			assertThat(awaitRenderSnapshot()).isEqualTo(
+				"""
+				|中文
+				|abc$s
+				""".trimMargin(),
+			)
+		}
+	}
+
+	@Test fun replacingHalfOfWideCharacterResetsOtherHalf() = runTest {
+		runMosaicTest {
+			setContent {
+				Layout(
+					modifier = Modifier.drawBehind {
+						// Replace the first half.
+						drawText(0, 0, "中文")
+						drawText(0, 0, "x")
+						// Replace the second half.
+						drawText(1, 0, "中文")
+						drawText(1, 1, "y")
+						// Replace the second half of one and the first half of another.
+						drawText(2, 0, "中文")
+						drawText(2, 1, "字")
+					},
+				) {
+					layout(4, 3)
+				}
+			}
+			assertThat(awaitRenderSnapshot()).isEqualTo(
+				"""
+				|x 文
+				| y文
+				| 字$s
+				""".trimMargin(),
+			)
+		}
+	}
+
+	@Test fun wideCharacterInLastColumnIsDrawnAsSpace() = runTest {
+		runMosaicTest {
+			setContent {
+				Text("a日", modifier = Modifier.width(2))
+			}
+			assertThat(awaitRenderSnapshot()).isEqualTo("a$s")
+		}
+	}
+
+	@Test fun lateLineOfManySpanStringResolvesItsSpans() {
+		val lineCount = 1_000
+		val string = buildAnnotatedString {
+			repeat(lineCount) { line ->
+				withStyle(SpanStyle(color = if (line % 2 == 0) Color.Red else Color.Blue)) {
+					append("line")
+				}
+				append('\n')
+			}
+		}
+		val surface = TextSurface(4, 1, AnsiLevel.TRUECOLOR)
+		val start = (lineCount - 1) * 5
+		TextCanvasDrawScope(surface, 4, 1).drawText(0, 0, string, start, start + 4)
+
+		assertThat(surface[0, 0].codePoint).isEqualTo('l'.code)
+		assertThat(surface[0, 0].foreground).isEqualTo(Color.Blue)
+		assertThat(surface[0, 3].foreground).isEqualTo(Color.Blue)
+	}
+
+	@Test fun zeroWidthCodePointsOccupyNoCells() = runTest {
+		runMosaicTest {
+			setContent {
+				Column {
+					Text("a\u200Bb")
+					Text("cd")
+				}
+			}
+			assertThat(awaitRenderSnapshot()).isEqualTo(
+				"""
+				|ab
+				|cd
+				""".trimMargin(),
+			)
+		}
+	}
+}
@@ -0,0 +1,68 @@
+package com.jakewharton.mosaic
+
+import androidx.compose.runtime.Composable
+import androidx.compose.runtime.mutableStateOf
+import androidx.compose.runtime.snapshots.Snapshot
+import com.jakewharton.mosaic.ui.AnsiLevel
+import com.jakewharton.mosaic.ui.unit.IntSize
+import kotlin.coroutines.CoroutineContext
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Runnable
+import kotlinx.coroutines.channels.Channel
+
+/**
+ * Drives a [MosaicComposition] synchronously on the calling thread so that a benchmark operation
+ * covers exactly one frame: recomposition, layout, drawing, and rendering with [DiffRendering].
+ */
+internal class BenchmarkComposition(
+	size: IntSize,
+	content: @Composable () -> Unit,
+) {
+	private val tasks = ArrayDeque<Runnable>()
+	private val dispatcher = object : CoroutineDispatcher() {
+		override fun dispatch(context: CoroutineContext, block: Runnable) {
+			tasks.addLast(block)
+		}
+	}
+
+	private val rendering = DiffRendering(AnsiLevel.TRUECOLOR)
+
+	/** The number of UTF-8 bytes written by the most recent frame. */
+	var lastOutputLength = 0
+		private set
+
+	private val composition = MosaicComposition(
+		coroutineScope = CoroutineScope(dispatcher),
+		terminalState = mutableStateOf(Terminal(size = size)),
+		inputEvents = Channel(),
+		// Without any delay between frames, every frame is sent from runUntilIdle.
+		maxFps = Int.MAX_VALUE,
+		frameCoalesceMillis = 0,
+		onDraw = { rootNode ->
+			lastOutputLength = rendering.renderFrame(rootNode).size
+		},
+	)
+
+	val rootNode get() = composition.rootNode
+
+	init {
+		composition.sendFrames()
+		composition.setContent(content)
+		runUntilIdle()
+	}
+
+	/** Deliver snapshot changes and run every task they cause, including any resulting frame. */
+	fun runUntilIdle() {
+		Snapshot.sendApplyNotifications()
+		while (true) {
+			val task = tasks.removeFirstOrNull() ?: break
+			task.run()
+		}
+	}
+
+	fun close() {
+		composition.cancel()
+		runUntilIdle()
+	}
+}
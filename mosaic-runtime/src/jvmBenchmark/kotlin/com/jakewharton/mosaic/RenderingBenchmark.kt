@@ -0,0 +1,117 @@
+package com.jakewharton.mosaic
+
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableIntStateOf
+import androidx.compose.runtime.setValue
+import androidx.compose.runtime.snapshots.SnapshotStateList
+import com.jakewharton.mosaic.layout.MosaicNode
+import com.jakewharton.mosaic.ui.AnsiLevel
+import com.jakewharton.mosaic.ui.unit.IntSize
+import kotlinx.benchmark.Benchmark
+import kotlinx.benchmark.Param
+import kotlinx.benchmark.Scope
+import kotlinx.benchmark.Setup
+import kotlinx.benchmark.State
+import kotlinx.benchmark.TearDown
+import org.openjdk.jmh.annotations.AuxCounters
+import org.openjdk.jmh.annotations.Level
+
+/**
+ * Measures each phase of rendering a frame of [scenario] separately, as well as whole frames.
+ *
+ * Run with the `gc` profiler, which the benchmark configuration enables, to also report
+ * allocations per operation.
+ */
+@State(Scope.Benchmark)
+public class RenderingBenchmark {
+	@Param("table", "staticLog", "nested", "styledText")
+	public var scenario: String = ""
+
+	private var tick by mutableIntStateOf(0)
+	private val staticLines = SnapshotStateList<String>()
+
+	private lateinit var composition: BenchmarkComposition
+	private lateinit var surfacePool: TextSurfacePool
+	private lateinit var surface: TextSurface
+	private val output = StringBuilder()
+
+	@Setup
+	public fun setup() {
+		composition = BenchmarkComposition(IntSize(120, 60)) {
+			when (scenario) {
+				"table" -> TableScenario(tick)
+				"staticLog" -> StaticLogScenario(staticLines, tick)
+				"nested" -> NestedScenario(tick)
+				"styledText" -> StyledTextScenario(tick)
+				else -> throw IllegalArgumentException("Unknown scenario: $scenario")
+			}
+		}
+		surfacePool = TextSurfacePool(AnsiLevel.TRUECOLOR)
+		surface = composition.rootNode.paint(AnsiLevel.TRUECOLOR)
+	}
+
+	@TearDown
+	public fun tearDown() {
+		composition.close()
+	}
+
+	/** A whole frame following a state change: recomposition, layout, drawing, and output. */
+	@Benchmark
+	public fun frame(counters: OutputCounters) {
+		if (scenario == "staticLog") {
+			staticLines += "Line $tick: the quick brown fox jumps over the lazy dog"
+		}
+		tick++
+		composition.runUntilIdle()
+		counters.frames++
+		counters.outputBytes += composition.lastOutputLength
+	}
+
+	/** Measure and place every node, none of which reuse their previous measurement. */
+	@Benchmark
+	public fun layout() {
+		val rootNode = composition.rootNode
+		rootNode.forEachNode { it.invalidateLayout() }
+		rootNode.measureAndPlace()
+	}
+
+	/** Draw every node, none of which reuse their previously-drawn cells. */
+	@Benchmark
+	public fun draw() {
+		val rootNode = composition.rootNode
+		rootNode.forEachNode { it.invalidateDraw() }
+		surfacePool.release(rootNode.paint(surfacePool))
+	}
+
+	/** Encode every row of a drawn frame to text with ANSI escapes. */
+	@Benchmark
+	public fun serialize(): Int {
+		output.clear()
+		for (row in 0 until surface.height) {
+			surface.appendRowTo(output, row)
+		}
+		return output.length
+	}
+
+	private fun MosaicNode.forEachNode(block: (MosaicNode) -> Unit) {
+		block(this)
+		for (child in children) {
+			child.forEachNode(block)
+		}
+	}
+
+	/** The characters written to the terminal, reported alongside the frame count. */
+	@AuxCounters(AuxCounters.Type.EVENTS)
+	@State(Scope.Thread)
+	public class OutputCounters {
+		@JvmField public var frames: Long = 0
+
+		@JvmField public var outputBytes: Long = 0
+
+		@Setup(Level.Iteration)
+		public fun reset() {
+			frames = 0
+			outputBytes = 0
+		}
+	}
+}
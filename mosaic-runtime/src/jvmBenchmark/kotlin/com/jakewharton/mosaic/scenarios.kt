@@ -0,0 +1,84 @@
+package com.jakewharton.mosaic
+
+import androidx.compose.runtime.Composable
+import androidx.compose.runtime.snapshots.SnapshotStateList
+import com.jakewharton.mosaic.layout.padding
+import com.jakewharton.mosaic.modifier.Modifier
+import com.jakewharton.mosaic.text.SpanStyle
+import com.jakewharton.mosaic.text.buildAnnotatedString
+import com.jakewharton.mosaic.text.withStyle
+import com.jakewharton.mosaic.ui.Color
+import com.jakewharton.mosaic.ui.Column
+import com.jakewharton.mosaic.ui.Row
+import com.jakewharton.mosaic.ui.Static
+import com.jakewharton.mosaic.ui.Text
+import com.jakewharton.mosaic.ui.TextStyle
+
+/** A process table, like `top`, where some usage columns change every frame. */
+@Composable
+internal fun TableScenario(tick: Int) {
+	Column {
+		Text("  PID  NAME                CPU%   MEM%", textStyle = TextStyle.Bold)
+		for (row in 0 until 40) {
+			val cpu = (row * 31 + tick * 17) % 1000
+			val memory = (row * 7 + tick) % 1000
+			Row {
+				Text((1000 + row).toString().padStart(5), modifier = Modifier.padding(right = 2))
+				Text("process-$row".padEnd(18), modifier = Modifier.padding(right = 2))
+				Text(
+					"${cpu / 10}.${cpu % 10}".padStart(5),
+					modifier = Modifier.padding(right = 2),
+					color = if (cpu > 800) Color.Red else Color.Unspecified,
+				)
+				Text("${memory / 10}.${memory % 10}".padStart(5))
+			}
+		}
+	}
+}
+
+/** A log which emits one static line per frame above a status line. */
+@Composable
+internal fun StaticLogScenario(lines: SnapshotStateList<String>, tick: Int) {
+	Static(lines) { line ->
+		Text(line)
+	}
+	Text("Processed $tick lines", textStyle = TextStyle.Italic)
+}
+
+/** Rows and columns nested [depth] deep with a changing leaf at the bottom. */
+@Composable
+internal fun NestedScenario(tick: Int, depth: Int = 24) {
+	if (depth == 0) {
+		Text("tick $tick")
+		return
+	}
+	val content = @Composable {
+		Text("$depth")
+		NestedScenario(tick, depth - 1)
+	}
+	if (depth % 2 == 0) {
+		Row(modifier = Modifier.padding(left = 1)) { content() }
+	} else {
+		Column { content() }
+	}
+}
+
+/** Lines of text where every word carries its own style. */
+@Composable
+internal fun StyledTextScenario(tick: Int) {
+	val string = buildAnnotatedString {
+		for (line in 0 until 30) {
+			if (line > 0) append('\n')
+			for (word in 0 until 12) {
+				val color = colors[(line + word + tick) % colors.size]
+				withStyle(SpanStyle(color = color, textStyle = TextStyle.Bold)) {
+					append("word")
+				}
+				append(' ')
+			}
+		}
+	}
+	Text(string)
+}
+
+private val colors = listOf(Color.Red, Color.Green, Color.Blue, Color.Yellow, Color.Cyan)
@@ -0,0 +1,48 @@
+package com.jakewharton.mosaic.text
+
+import com.jakewharton.mosaic.TextSurface
+import com.jakewharton.mosaic.layout.TextCanvasDrawScope
+import com.jakewharton.mosaic.ui.AnsiLevel
+import com.jakewharton.mosaic.ui.Color
+import com.jakewharton.mosaic.ui.TextStyle
+import kotlinx.benchmark.Benchmark
+import kotlinx.benchmark.Param
+import kotlinx.benchmark.Scope
+import kotlinx.benchmark.Setup
+import kotlinx.benchmark.State
+
+/**
+ * Measures drawing a line of [length] characters carrying [spans] evenly spaced highlight spans
+ * on top of one span covering the whole line.
+ */
+@State(Scope.Benchmark)
+public class AnnotatedStringDrawBenchmark {
+	@Param("200")
+	public var length: Int = 0
+
+	@Param("0", "10", "100", "500")
+	public var spans: Int = 0
+
+	private lateinit var string: AnnotatedString
+	private lateinit var drawScope: TextCanvasDrawScope
+
+	@Setup
+	public fun setup() {
+		string = buildAnnotatedString {
+			append("a".repeat(length))
+			addStyle(SpanStyle(color = Color.White), 0, length)
+			for (span in 0 until spans) {
+				val start = span * length / spans
+				val end = minOf(start + 3, length)
+				addStyle(SpanStyle(color = Color.Red, textStyle = TextStyle.Bold), start, end)
+			}
+		}
+		val surface = TextSurface(length, 1, AnsiLevel.TRUECOLOR)
+		drawScope = TextCanvasDrawScope(surface, length, 1)
+	}
+
+	@Benchmark
+	public fun drawText() {
+		drawScope.drawText(0, 0, string)
+	}
+}
@@ -2,10 +2,6 @@ package com.jakewharton.mosaic
 
 import kotlin.concurrent.AtomicInt
 
-internal actual fun platformDisplay(chars: CharSequence) {
-	print(chars.toString())
-}
-
 internal actual typealias AtomicBoolean = AtomicInt
 
 @Suppress("NOTHING_TO_INLINE")
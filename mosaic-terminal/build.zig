@@ -5,23 +5,91 @@ pub fn build(b: *std.Build) !void {
 	const deleteLib = b.addRemoveDirTree(b.getInstallPath(.prefix, "lib"));
 	b.getInstallStep().dependOn(&deleteLib.step);
 
-	setupMosaicTarget(b, &deleteLib.step, .linux, .aarch64, "arm64");
-	setupMosaicTarget(b, &deleteLib.step, .linux, .riscv64, "riscv");
-	setupMosaicTarget(b, &deleteLib.step, .linux, .x86_64, "x86_64");
-	setupMosaicTarget(b, &deleteLib.step, .macos, .aarch64, "aarch64");
-	setupMosaicTarget(b, &deleteLib.step, .macos, .x86_64, "x86_64");
-	setupMosaicTarget(b, &deleteLib.step, .windows, .aarch64, "arm64");
-	setupMosaicTarget(b, &deleteLib.step, .windows, .x86_64, "x86_64");
+	const fast = b.option(bool, "fast", "Also build the ReleaseFast 'mosaic-fast' libraries (default: true)") orelse true;
+
+	const variants: []const Variant = if (fast) &.{ .small, .fast } else &.{.small};
+	for (variants) |variant| {
+		setupMosaicTarget(b, &deleteLib.step, .linux, .aarch64, "arm64", variant);
+		setupMosaicTarget(b, &deleteLib.step, .linux, .riscv64, "riscv", variant);
+		setupMosaicTarget(b, &deleteLib.step, .linux, .x86_64, "x86_64", variant);
+		setupMosaicTarget(b, &deleteLib.step, .macos, .aarch64, "aarch64", variant);
+		setupMosaicTarget(b, &deleteLib.step, .macos, .x86_64, "x86_64", variant);
+		setupMosaicTarget(b, &deleteLib.step, .windows, .aarch64, "arm64", variant);
+		setupMosaicTarget(b, &deleteLib.step, .windows, .x86_64, "x86_64", variant);
+	}
+
+	const bench = b.step("bench", "Run the native benchmarks for the host");
+	if (b.host.result.os.tag != .windows) {
+		setupBenchmark(b, bench, "mosaic-stdin-benchmark", &.{
+			"src/cBenchmark/mosaic-stdin-benchmark.c",
+			"src/c/mosaic-eventLoop-posix.c",
+			"src/c/mosaic-resize-posix.c",
+			"src/c/mosaic-stdin-posix.c",
+			"src/c/mosaic-uring-linux.c",
+		});
+		setupBenchmark(b, bench, "mosaic-frame-benchmark", &.{
+			"src/cBenchmark/mosaic-frame-benchmark.c",
+			"src/c/mosaic-eventLoop-posix.c",
+			"src/c/mosaic-resize-posix.c",
+			"src/c/mosaic-stdin-posix.c",
+			"src/c/mosaic-stdout-posix.c",
+			"src/c/mosaic-uring-linux.c",
+		});
+	}
 }
 
-fn setupMosaicTarget(b: *std.Build, step: *std.Build.Step, tag: std.Target.Os.Tag, arch: std.Target.Cpu.Arch, dir: []const u8) void {
+fn setupBenchmark(b: *std.Build, step: *std.Build.Step, name: []const u8, files: []const []const u8) void {
+	const exe = b.addExecutable(.{
+		.name = name,
+		.target = b.host,
+		.optimize = .ReleaseFast,
+	});
+
+	exe.linkLibC();
+
+	exe.addIncludePath(b.path("src/c"));
+
+	exe.addCSourceFiles(.{
+		.files = files,
+		.flags = &.{
+			"-std=gnu99",
+		},
+	});
+
+	const run = b.addRunArtifact(exe);
+	step.dependOn(&run.step);
+}
+
+const Variant = enum {
+	/// The default library, optimized for size and able to run on any CPU of its architecture.
+	small,
+	/// An optional library optimized for speed. On x86_64 it requires a CPU supporting x86-64-v3
+	/// (AVX2, BMI2, FMA, etc.). The JVM loads it instead of the small library when the host CPU
+	/// is known to support it.
+	fast,
+};
+
+fn setupMosaicTarget(b: *std.Build, step: *std.Build.Step, tag: std.Target.Os.Tag, arch: std.Target.Cpu.Arch, dir: []const u8, variant: Variant) void {
 	const lib = b.addSharedLibrary(.{
-		.name = "mosaic",
+		.name = switch (variant) {
+			.small => "mosaic",
+			.fast => "mosaic-fast",
+		},
 		.target = b.resolveTargetQuery(.{
 			.cpu_arch = arch,
 			.os_tag = tag,
+			.cpu_model = switch (variant) {
+				.small => .determined_by_arch_os,
+				.fast => switch (arch) {
+					.x86_64 => .{ .explicit = &std.Target.x86.cpu.x86_64_v3 },
+					else => .determined_by_arch_os,
+				},
+			},
 		}),
-		.optimize = .ReleaseSmall,
+		.optimize = switch (variant) {
+			.small => .ReleaseSmall,
+			.fast => .ReleaseFast,
+		},
 	});
 
 	lib.linkLibC();
@@ -38,10 +106,21 @@ fn setupMosaicTarget(b: *std.Build, step: *std.Build.Step, tag: std.Target.Os.Ta
 	// TODO Tree-walk these two dirs for all C files.
 	lib.addCSourceFiles(.{
 		.files = &.{
+			"src/c/mosaic-cells.c",
+			"src/c/mosaic-eventLoop-posix.c",
+			"src/c/mosaic-eventLoop-windows.c",
+			"src/c/mosaic-input.c",
 			"src/c/mosaic-rawMode-posix.c",
 			"src/c/mosaic-rawMode-windows.c",
+			"src/c/mosaic-resize-posix.c",
+			"src/c/mosaic-resize-windows.c",
+			"src/c/mosaic-sgr.c",
 			"src/c/mosaic-stdin-posix.c",
 			"src/c/mosaic-stdin-windows.c",
+			"src/c/mosaic-stdout-posix.c",
+			"src/c/mosaic-stdout-windows.c",
+			"src/c/mosaic-uring-linux.c",
+			"src/c/mosaic-width.c",
 			"src/jvmMain/jni/mosaic-jni.c",
 		},
 		.flags = &.{
@@ -0,0 +1,67 @@
+#include "mosaic.h"
+
+#include "cutils.h"
+#include <string.h>
+
+static inline int cellEquals(const uint32_t *a, const uint32_t *b) {
+	// Compare each 16-byte cell as two 64-bit words. memcpy keeps this free of alignment
+	// assumptions and compiles down to plain loads.
+	uint64_t a0, a1, b0, b1;
+	memcpy(&a0, a, 8);
+	memcpy(&a1, a + 2, 8);
+	memcpy(&b0, b, 8);
+	memcpy(&b1, b + 2, 8);
+	return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+}
+
+int cellGrid_diff(
+	const uint32_t *previous,
+	const uint32_t *next,
+	int width,
+	int height,
+	int mergeGap,
+	int32_t *runs
+) {
+	int count = 0;
+	size_t rowWords = (size_t) width * cellGrid_cellWords;
+	size_t rowBytes = rowWords * sizeof(uint32_t);
+
+	for (int row = 0; row < height; row++) {
+		const uint32_t *previousRow = previous + row * rowWords;
+		const uint32_t *nextRow = next + row * rowWords;
+
+		// Most rows of a typical frame are untouched. The libc memcmp is vectorized on every
+		// platform we target, so checking the whole row first is faster than walking its cells.
+		if (likely(memcmp(previousRow, nextRow, rowBytes) == 0)) {
+			continue;
+		}
+
+		int runStart = -1;
+		int runEnd = 0;
+		for (int column = 0; column < width; column++) {
+			size_t offset = (size_t) column * cellGrid_cellWords;
+			if (cellEquals(previousRow + offset, nextRow + offset)) {
+				continue;
+			}
+			if (runStart >= 0 && column - runEnd <= mergeGap) {
+				runEnd = column + 1;
+				continue;
+			}
+			if (runStart >= 0) {
+				runs[count * 3] = row;
+				runs[count * 3 + 1] = runStart;
+				runs[count * 3 + 2] = runEnd;
+				count++;
+			}
+			runStart = column;
+			runEnd = column + 1;
+		}
+		// The memcmp above guarantees at least one changed cell.
+		runs[count * 3] = row;
+		runs[count * 3 + 1] = runStart;
+		runs[count * 3 + 2] = runEnd;
+		count++;
+	}
+
+	return count;
+}
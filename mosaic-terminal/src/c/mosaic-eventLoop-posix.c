@@ -0,0 +1,473 @@
+#include "mosaic.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+
+#include "cutils.h"
+#include "mosaic-internal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+
+/** The most events retrieved from the kernel by a single wait. */
+#define maxReadyEvents 64
+
+typedef struct eventLoopImpl {
+	int stdinFd;
+	/** Non-NULL when watching resizes. */
+	resizeNotifier *notifier;
+	// Index 0 is read and index 1 is written to interrupt. On Linux both are the same eventfd whose
+	// counter coalesces interrupts. Elsewhere they are the ends of a non-blocking pipe.
+	int interrupt[2];
+#if defined(__linux__)
+	int epollFd;
+	/** A monotonic timerfd which becomes readable when the timeout elapses. */
+	int timerFd;
+	/** Non-zero when stdinFd cannot be added to epoll (e.g., a regular file) and is always readable. */
+	int stdinAlwaysReady;
+	/** Alternates whether an always-ready stdin is reported before or after the epoll events. */
+	int stdinReportedFirst;
+#else
+	/** The absolute monotonic time of the timeout in nanoseconds, or -1 for none. */
+	int64_t deadlineNanos;
+	// Index 0 is stdinFd, index 1 is the resize signal pipe (or -1 which poll ignores), index 2 is
+	// interrupt[0], and registered file descriptors follow.
+	struct pollfd *fds;
+	int fdCount;
+	int fdCapacity;
+	/** The index at which to start reporting ready fds so that none are starved by 'capacity'. */
+	int scanStart;
+#endif
+} eventLoopImpl;
+
+#if defined(__linux__)
+
+static int eventLoop_register(eventLoop *loop, int fd, uint32_t type) {
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.u64 = type | ((uint64_t) (uint32_t) fd << 32);
+	return epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &event);
+}
+
+eventLoopResult eventLoop_initWithFd(int stdinFd, int watchResize) {
+	eventLoopResult result = {};
+
+	eventLoopImpl *loop = calloc(1, sizeof(eventLoopImpl));
+	if (unlikely(loop == NULL)) {
+		// result.loop is set to 0 which will trigger OOM.
+		goto ret;
+	}
+	loop->stdinFd = stdinFd;
+	loop->interrupt[0] = -1;
+	loop->interrupt[1] = -1;
+	loop->timerFd = -1;
+
+	loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (unlikely(loop->epollFd == -1)) {
+		goto err;
+	}
+
+	int interruptFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (unlikely(interruptFd == -1)) {
+		goto err;
+	}
+	loop->interrupt[0] = interruptFd;
+	loop->interrupt[1] = interruptFd;
+	if (unlikely(eventLoop_register(loop, interruptFd, eventLoopEvent_interrupt) != 0)) {
+		goto err;
+	}
+
+	loop->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+	if (unlikely(loop->timerFd == -1)) {
+		goto err;
+	}
+	if (unlikely(eventLoop_register(loop, loop->timerFd, eventLoopEvent_timeout) != 0)) {
+		goto err;
+	}
+
+	if (stdinFd != -1 && unlikely(eventLoop_register(loop, stdinFd, eventLoopEvent_stdin) != 0)) {
+		if (errno != EPERM) {
+			goto err;
+		}
+		// Files which do not support polling cannot be added to an epoll instance. They are always
+		// readable, just as poll reports them.
+		loop->stdinAlwaysReady = 1;
+	}
+
+	if (watchResize) {
+		resizeNotifierResult notifierResult = resizeNotifier_init();
+		if (unlikely(notifierResult.error)) {
+			result.error = notifierResult.error;
+			goto errFree;
+		}
+		if (unlikely(notifierResult.notifier == NULL)) {
+			goto errFree;
+		}
+		loop->notifier = notifierResult.notifier;
+		int signalFd = resizeNotifier_signalFd(loop->notifier);
+		if (unlikely(eventLoop_register(loop, signalFd, eventLoopEvent_resize) != 0)) {
+			goto err;
+		}
+	}
+
+	result.loop = loop;
+
+	ret:
+	return result;
+
+	err:
+	result.error = errno;
+
+	errFree:
+	eventLoop_free(loop);
+	goto ret;
+}
+
+platformError eventLoop_addFd(eventLoop *loop, int fd) {
+	return likely(eventLoop_register(loop, fd, eventLoopEvent_fd) == 0)
+		? 0
+		: errno;
+}
+
+platformError eventLoop_removeFd(eventLoop *loop, int fd) {
+	if (fd == loop->stdinFd && loop->stdinAlwaysReady) {
+		loop->stdinAlwaysReady = 0;
+		return 0;
+	}
+	return likely(epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, fd, NULL) == 0)
+		? 0
+		: errno;
+}
+
+platformError eventLoop_setTimeout(eventLoop *loop, int64_t timeoutNanos) {
+	// Zero values disarm the timer. Setting the timer also discards any unread expiration.
+	struct itimerspec spec = {};
+	if (timeoutNanos >= 0) {
+		// An immediate timeout still needs to arm the timer, so use the smallest non-zero value.
+		if (timeoutNanos == 0) {
+			timeoutNanos = 1;
+		}
+		spec.it_value.tv_sec = timeoutNanos / 1000000000;
+		spec.it_value.tv_nsec = timeoutNanos % 1000000000;
+	}
+	return likely(timerfd_settime(loop->timerFd, 0, &spec, NULL) == 0)
+		? 0
+		: errno;
+}
+
+eventLoopWait eventLoop_wait(eventLoop *loop, eventLoopEvent *events, int capacity) {
+	eventLoopWait result = {};
+	if (unlikely(capacity <= 0)) {
+		result.error = EINVAL;
+		return result;
+	}
+
+	int count = 0;
+	if (unlikely(loop->stdinAlwaysReady)) {
+		// Neither stdin nor the epoll events can be starved when they do not all fit.
+		loop->stdinReportedFirst = !loop->stdinReportedFirst;
+		if (loop->stdinReportedFirst) {
+			events[count].type = eventLoopEvent_stdin;
+			events[count].fd = 0;
+			count++;
+		}
+	}
+
+	int max = capacity - count;
+	if (max > maxReadyEvents) {
+		max = maxReadyEvents;
+	}
+	if (max > 0) {
+		struct epoll_event ready[maxReadyEvents];
+		// Only block when stdin will not be reported.
+		int timeout = loop->stdinAlwaysReady ? 0 : -1;
+		int readyCount;
+		// Signals such as SIGWINCH interrupt the wait even when their handler uses SA_RESTART.
+		while (unlikely((readyCount = epoll_wait(loop->epollFd, ready, max, timeout)) == -1)) {
+			if (errno != EINTR) {
+				result.error = errno;
+				return result;
+			}
+		}
+
+		for (int i = 0; i < readyCount; i++) {
+			uint32_t type = (uint32_t) ready[i].data.u64;
+			int fd = (int) (ready[i].data.u64 >> 32);
+			uint64_t value;
+			switch (type) {
+				case eventLoopEvent_resize:
+					resizeNotifier_drainSignal(loop->notifier);
+					break;
+				case eventLoopEvent_timeout:
+				case eventLoopEvent_interrupt:
+					// Reading returns the number of expirations or interrupts and resets it to zero.
+					while (unlikely(read(fd, &value, sizeof(value)) == -1) && errno == EINTR) {
+						// Retry.
+					}
+					break;
+			}
+			events[count].type = type;
+			events[count].fd = type == eventLoopEvent_fd ? fd : 0;
+			count++;
+		}
+	}
+	if (unlikely(loop->stdinAlwaysReady) && !loop->stdinReportedFirst && count < capacity) {
+		events[count].type = eventLoopEvent_stdin;
+		events[count].fd = 0;
+		count++;
+	}
+
+	result.count = count;
+	return result;
+}
+
+#else
+
+/** The monotonic time in nanoseconds. */
+static int64_t nowNanos() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static int setNonBlocking(int fd) {
+	int flags = fcntl(fd, F_GETFL);
+	return flags == -1 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static void drain(int fd) {
+	char buffer[16];
+	while (read(fd, buffer, sizeof(buffer)) > 0) {
+		// Keep reading until EAGAIN.
+	}
+}
+
+eventLoopResult eventLoop_initWithFd(int stdinFd, int watchResize) {
+	eventLoopResult result = {};
+
+	eventLoopImpl *loop = calloc(1, sizeof(eventLoopImpl));
+	if (unlikely(loop == NULL)) {
+		// result.loop is set to 0 which will trigger OOM.
+		goto ret;
+	}
+	loop->stdinFd = stdinFd;
+	loop->interrupt[0] = -1;
+	loop->interrupt[1] = -1;
+	loop->deadlineNanos = -1;
+
+	loop->fdCapacity = 8;
+	loop->fds = calloc(loop->fdCapacity, sizeof(struct pollfd));
+	if (unlikely(loop->fds == NULL)) {
+		// result.loop is set to 0 which will trigger OOM.
+		goto errFree;
+	}
+
+	if (unlikely(pipe(loop->interrupt) != 0)) {
+		loop->interrupt[0] = -1;
+		loop->interrupt[1] = -1;
+		goto err;
+	}
+	if (unlikely(setNonBlocking(loop->interrupt[0]) != 0)
+		|| unlikely(setNonBlocking(loop->interrupt[1]) != 0)) {
+		goto err;
+	}
+
+	int signalFd = -1;
+	if (watchResize) {
+		resizeNotifierResult notifierResult = resizeNotifier_init();
+		if (unlikely(notifierResult.error)) {
+			result.error = notifierResult.error;
+			goto errFree;
+		}
+		if (unlikely(notifierResult.notifier == NULL)) {
+			goto errFree;
+		}
+		loop->notifier = notifierResult.notifier;
+		signalFd = resizeNotifier_signalFd(loop->notifier);
+	}
+
+	loop->fds[0].fd = stdinFd;
+	loop->fds[0].events = POLLIN;
+	loop->fds[1].fd = signalFd;
+	loop->fds[1].events = POLLIN;
+	loop->fds[2].fd = loop->interrupt[0];
+	loop->fds[2].events = POLLIN;
+	loop->fdCount = 3;
+
+	result.loop = loop;
+
+	ret:
+	return result;
+
+	err:
+	result.error = errno;
+
+	errFree:
+	eventLoop_free(loop);
+	goto ret;
+}
+
+platformError eventLoop_addFd(eventLoop *loop, int fd) {
+	for (int i = 0; i < loop->fdCount; i++) {
+		if (loop->fds[i].fd == fd) {
+			return EEXIST;
+		}
+	}
+	if (loop->fdCount == loop->fdCapacity) {
+		int capacity = loop->fdCapacity * 2;
+		struct pollfd *fds = realloc(loop->fds, capacity * sizeof(struct pollfd));
+		if (unlikely(fds == NULL)) {
+			return ENOMEM;
+		}
+		loop->fds = fds;
+		loop->fdCapacity = capacity;
+	}
+	loop->fds[loop->fdCount].fd = fd;
+	loop->fds[loop->fdCount].events = POLLIN;
+	loop->fdCount++;
+	return 0;
+}
+
+platformError eventLoop_removeFd(eventLoop *loop, int fd) {
+	if (fd == loop->fds[0].fd) {
+		// Negative file descriptors are ignored by poll.
+		loop->fds[0].fd = -1;
+		return 0;
+	}
+	for (int i = 3; i < loop->fdCount; i++) {
+		if (loop->fds[i].fd == fd) {
+			loop->fdCount--;
+			loop->fds[i] = loop->fds[loop->fdCount];
+			loop->scanStart = 0;
+			return 0;
+		}
+	}
+	return ENOENT;
+}
+
+platformError eventLoop_setTimeout(eventLoop *loop, int64_t timeoutNanos) {
+	loop->deadlineNanos = timeoutNanos < 0 ? -1 : nowNanos() + timeoutNanos;
+	return 0;
+}
+
+eventLoopWait eventLoop_wait(eventLoop *loop, eventLoopEvent *events, int capacity) {
+	eventLoopWait result = {};
+	if (unlikely(capacity <= 0)) {
+		result.error = EINVAL;
+		return result;
+	}
+
+	int count = 0;
+	while (count == 0) {
+		int timeoutMillis = -1;
+		if (loop->deadlineNanos != -1) {
+			int64_t remainingNanos = loop->deadlineNanos - nowNanos();
+			// Round up so that the deadline has passed when poll times out.
+			int64_t remainingMillis = remainingNanos <= 0 ? 0 : (remainingNanos + 999999) / 1000000;
+			timeoutMillis = remainingMillis > INT32_MAX ? INT32_MAX : (int) remainingMillis;
+		}
+
+		// Signals such as SIGWINCH interrupt the wait even when their handler uses SA_RESTART.
+		if (unlikely(poll(loop->fds, loop->fdCount, timeoutMillis) == -1)) {
+			if (errno == EINTR) {
+				continue;
+			}
+			result.error = errno;
+			return result;
+		}
+
+		// The timeout is only reported once, so report it first.
+		if (loop->deadlineNanos != -1 && nowNanos() >= loop->deadlineNanos) {
+			loop->deadlineNanos = -1;
+			events[count].type = eventLoopEvent_timeout;
+			events[count].fd = 0;
+			count++;
+		}
+
+		// Any event (including POLLHUP and POLLERR) means a read will not block.
+		int fdCount = loop->fdCount;
+		int scanStart = loop->scanStart;
+		for (int n = 0; n < fdCount && count < capacity; n++) {
+			int i = (scanStart + n) % fdCount;
+			if (loop->fds[i].revents == 0) {
+				continue;
+			}
+			loop->scanStart = (i + 1) % fdCount;
+			events[count].fd = 0;
+			if (i == 0) {
+				events[count].type = eventLoopEvent_stdin;
+			} else if (i == 1) {
+				resizeNotifier_drainSignal(loop->notifier);
+				events[count].type = eventLoopEvent_resize;
+			} else if (i == 2) {
+				drain(loop->interrupt[0]);
+				events[count].type = eventLoopEvent_interrupt;
+			} else {
+				events[count].type = eventLoopEvent_fd;
+				events[count].fd = loop->fds[i].fd;
+			}
+			count++;
+		}
+	}
+
+	result.count = count;
+	return result;
+}
+
+#endif
+
+eventLoopResult eventLoop_init(int watchResize) {
+	return eventLoop_initWithFd(STDIN_FILENO, watchResize);
+}
+
+eventLoopResult eventLoop_initWithoutStdin() {
+	return eventLoop_initWithFd(-1, 0);
+}
+
+platformError eventLoop_interrupt(eventLoop *loop) {
+#if defined(__linux__)
+	uint64_t increment = 1;
+	int result = write(loop->interrupt[1], &increment, sizeof(increment));
+#else
+	int result = write(loop->interrupt[1], " ", 1);
+#endif
+	// The pipe is non-blocking. If it is full an interrupt is already pending so failure is fine.
+	return unlikely(result == -1 && errno != EAGAIN)
+		? errno
+		: 0;
+}
+
+platformError eventLoop_free(eventLoop *loop) {
+	int result = 0;
+	if (loop->notifier != NULL) {
+		result = resizeNotifier_free(loop->notifier);
+	}
+	if (loop->interrupt[0] != -1 && unlikely(close(loop->interrupt[0]) != 0 && result == 0)) {
+		result = errno;
+	}
+#if defined(__linux__)
+	if (loop->timerFd != -1 && unlikely(close(loop->timerFd) != 0 && result == 0)) {
+		result = errno;
+	}
+	if (loop->epollFd != -1 && unlikely(close(loop->epollFd) != 0 && result == 0)) {
+		result = errno;
+	}
+#else
+	if (loop->interrupt[1] != -1 && unlikely(close(loop->interrupt[1]) != 0 && result == 0)) {
+		result = errno;
+	}
+	free(loop->fds);
+#endif
+	free(loop);
+	return result;
+}
+
+#endif
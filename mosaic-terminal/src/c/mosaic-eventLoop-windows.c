@@ -0,0 +1,48 @@
+#include "mosaic.h"
+
+#if defined(WIN32)
+
+// Console input, console resizes, and waitable timers are all waitable handles which a port could
+// use with WaitForMultipleObjects. Until then, callers use a stdinReader and resizeNotifier.
+
+eventLoopResult eventLoop_init(int watchResize) {
+	eventLoopResult result = {};
+	result.error = ERROR_NOT_SUPPORTED;
+	return result;
+}
+
+eventLoopResult stdinWriter_eventLoop(stdinWriter *writer) {
+	return eventLoop_init(0);
+}
+
+eventLoopResult eventLoop_initWithoutStdin() {
+	return eventLoop_init(0);
+}
+
+platformError eventLoop_addFd(eventLoop *loop, int fd) {
+	return ERROR_NOT_SUPPORTED;
+}
+
+platformError eventLoop_removeFd(eventLoop *loop, int fd) {
+	return ERROR_NOT_SUPPORTED;
+}
+
+platformError eventLoop_setTimeout(eventLoop *loop, int64_t timeoutNanos) {
+	return ERROR_NOT_SUPPORTED;
+}
+
+eventLoopWait eventLoop_wait(eventLoop *loop, eventLoopEvent *events, int capacity) {
+	eventLoopWait result = {};
+	result.error = ERROR_NOT_SUPPORTED;
+	return result;
+}
+
+platformError eventLoop_interrupt(eventLoop *loop) {
+	return ERROR_NOT_SUPPORTED;
+}
+
+platformError eventLoop_free(eventLoop *loop) {
+	return ERROR_NOT_SUPPORTED;
+}
+
+#endif
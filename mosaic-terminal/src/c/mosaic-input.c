@@ -0,0 +1,563 @@
+#include "mosaic.h"
+
+#include "cutils.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_PARAMS 4
+#define REPLACEMENT_CHARACTER 0xFFFD
+#define PASTE_START 200
+#define PASTE_END 201
+
+static const char pasteEnd[] = "\x1b[201~";
+#define PASTE_END_LENGTH (sizeof(pasteEnd) - 1)
+
+enum state {
+	S_GROUND,
+	S_ESC,
+	S_CSI,
+	S_SS3,
+	S_UTF8,
+	S_PASTE,        // Bytes are consumed in bulk by consumePaste rather than the transition table.
+	STATE_COUNT,
+};
+
+enum byteClass {
+	C_CONTROL,      // 0x00-0x1A, 0x1C-0x1F
+	C_ESC,          // 0x1B
+	C_INTERMEDIATE, // 0x20-0x2F
+	C_PARAM,        // 0x30-0x3F
+	C_FINAL,        // 0x40-0x7E
+	C_DEL,          // 0x7F
+	C_CONTINUATION, // 0x80-0xBF
+	C_LEAD2,        // 0xC2-0xDF
+	C_LEAD3,        // 0xE0-0xEF
+	C_LEAD4,        // 0xF0-0xF4
+	C_INVALID,      // 0xC0, 0xC1, 0xF5-0xFF
+	CLASS_COUNT,
+};
+
+enum action {
+	A_NONE,
+	A_PRINT,        // Emit the byte as an ASCII character.
+	A_CONTROL,      // Emit the byte as a control key.
+	A_ESC,          // Begin a possible escape sequence.
+	A_ESC_ESC,      // Emit the first of two escapes as a key and begin again.
+	A_ALT,          // Reprocess the byte in the ground state with the alt modifier.
+	A_PARAM,        // Accumulate a CSI parameter byte.
+	A_CSI_DISPATCH,
+	A_SS3_DISPATCH,
+	A_UTF8_START,
+	A_UTF8_CONTINUE,
+	A_INVALID,      // Emit a replacement character.
+	A_ABORT,        // Emit a replacement character for the partial sequence and reprocess the byte.
+};
+
+typedef struct transition {
+	uint8_t action;
+	uint8_t next;
+} transition;
+
+static uint8_t byteClasses[256];
+
+static const transition transitions[STATE_COUNT][CLASS_COUNT] = {
+	[S_GROUND] = {
+		[C_CONTROL] = { A_CONTROL, S_GROUND },
+		[C_ESC] = { A_ESC, S_ESC },
+		[C_INTERMEDIATE] = { A_PRINT, S_GROUND },
+		[C_PARAM] = { A_PRINT, S_GROUND },
+		[C_FINAL] = { A_PRINT, S_GROUND },
+		[C_DEL] = { A_CONTROL, S_GROUND },
+		[C_CONTINUATION] = { A_INVALID, S_GROUND },
+		[C_LEAD2] = { A_UTF8_START, S_UTF8 },
+		[C_LEAD3] = { A_UTF8_START, S_UTF8 },
+		[C_LEAD4] = { A_UTF8_START, S_UTF8 },
+		[C_INVALID] = { A_INVALID, S_GROUND },
+	},
+	[S_ESC] = {
+		[C_CONTROL] = { A_ALT, S_GROUND },
+		[C_ESC] = { A_ESC_ESC, S_ESC },
+		[C_INTERMEDIATE] = { A_ALT, S_GROUND },
+		[C_PARAM] = { A_ALT, S_GROUND },
+		// '[' and 'O' are special-cased before this table is consulted.
+		[C_FINAL] = { A_ALT, S_GROUND },
+		[C_DEL] = { A_ALT, S_GROUND },
+		[C_CONTINUATION] = { A_ALT, S_GROUND },
+		[C_LEAD2] = { A_ALT, S_GROUND },
+		[C_LEAD3] = { A_ALT, S_GROUND },
+		[C_LEAD4] = { A_ALT, S_GROUND },
+		[C_INVALID] = { A_ALT, S_GROUND },
+	},
+	[S_CSI] = {
+		// Controls inside a sequence are not valid for keyboard input. Abandon the sequence.
+		[C_CONTROL] = { A_NONE, S_GROUND },
+		[C_ESC] = { A_ESC, S_ESC },
+		// Intermediates are not used by any key encoding, but they must not terminate the sequence.
+		[C_INTERMEDIATE] = { A_NONE, S_CSI },
+		[C_PARAM] = { A_PARAM, S_CSI },
+		[C_FINAL] = { A_CSI_DISPATCH, S_GROUND },
+		[C_DEL] = { A_NONE, S_GROUND },
+		[C_CONTINUATION] = { A_NONE, S_GROUND },
+		[C_LEAD2] = { A_NONE, S_GROUND },
+		[C_LEAD3] = { A_NONE, S_GROUND },
+		[C_LEAD4] = { A_NONE, S_GROUND },
+		[C_INVALID] = { A_NONE, S_GROUND },
+	},
+	[S_SS3] = {
+		[C_CONTROL] = { A_NONE, S_GROUND },
+		[C_ESC] = { A_ESC, S_ESC },
+		[C_INTERMEDIATE] = { A_NONE, S_GROUND },
+		// Some terminals send a modifier parameter, such as "ESC O 5 A".
+		[C_PARAM] = { A_PARAM, S_SS3 },
+		[C_FINAL] = { A_SS3_DISPATCH, S_GROUND },
+		[C_DEL] = { A_NONE, S_GROUND },
+		[C_CONTINUATION] = { A_NONE, S_GROUND },
+		[C_LEAD2] = { A_NONE, S_GROUND },
+		[C_LEAD3] = { A_NONE, S_GROUND },
+		[C_LEAD4] = { A_NONE, S_GROUND },
+		[C_INVALID] = { A_NONE, S_GROUND },
+	},
+	[S_UTF8] = {
+		[C_CONTROL] = { A_ABORT, S_GROUND },
+		[C_ESC] = { A_ABORT, S_GROUND },
+		[C_INTERMEDIATE] = { A_ABORT, S_GROUND },
+		[C_PARAM] = { A_ABORT, S_GROUND },
+		[C_FINAL] = { A_ABORT, S_GROUND },
+		[C_DEL] = { A_ABORT, S_GROUND },
+		[C_CONTINUATION] = { A_UTF8_CONTINUE, S_UTF8 },
+		[C_LEAD2] = { A_ABORT, S_GROUND },
+		[C_LEAD3] = { A_ABORT, S_GROUND },
+		[C_LEAD4] = { A_ABORT, S_GROUND },
+		[C_INVALID] = { A_ABORT, S_GROUND },
+	},
+};
+
+typedef struct inputParserImpl {
+	uint8_t state;
+	/** Modifiers which apply to the next emitted event, such as alt from a preceding escape. */
+	uint16_t modifiers;
+	uint8_t paramCount;
+	/** Whether the CSI sequence had a private marker ('<', '=', '>', or '?'). */
+	uint8_t privateMarker;
+	int params[MAX_PARAMS];
+	uint32_t codePoint;
+	uint8_t utf8Remaining;
+	uint8_t utf8Length;
+	/** How many bytes of pasteEnd have been matched, and withheld from the paste, so far. */
+	uint8_t pasteEndMatched;
+	char *paste;
+	int pasteLength;
+	int pasteCapacity;
+	/** Offset in 'paste' at which the in-progress paste began. */
+	int pasteStart;
+} inputParserImpl;
+
+static void initByteClasses() {
+	// Racing initializations from multiple threads all write the same values.
+	if (byteClasses[0xFF] == C_INVALID) {
+		return;
+	}
+	for (int b = 0; b < 256; b++) {
+		uint8_t class;
+		if (b == 0x1B) class = C_ESC;
+		else if (b < 0x20) class = C_CONTROL;
+		else if (b < 0x30) class = C_INTERMEDIATE;
+		else if (b < 0x40) class = C_PARAM;
+		else if (b < 0x7F) class = C_FINAL;
+		else if (b == 0x7F) class = C_DEL;
+		else if (b < 0xC0) class = C_CONTINUATION;
+		else if (b < 0xC2) class = C_INVALID;
+		else if (b < 0xE0) class = C_LEAD2;
+		else if (b < 0xF0) class = C_LEAD3;
+		else if (b < 0xF5) class = C_LEAD4;
+		else class = C_INVALID;
+		byteClasses[b] = class;
+	}
+}
+
+inputParser *inputParser_init() {
+	initByteClasses();
+	return calloc(1, sizeof(inputParserImpl));
+}
+
+static inline int emit(inputParserImpl *parser, inputEvent *event, uint16_t key, uint32_t codePoint) {
+	event->key = key;
+	event->modifiers = parser->modifiers;
+	event->codePoint = codePoint;
+	parser->modifiers = 0;
+	return 1;
+}
+
+static int emitControl(inputParserImpl *parser, inputEvent *event, uint8_t b) {
+	switch (b) {
+		case '\r':
+		case '\n':
+			return emit(parser, event, inputKey_enter, 0);
+		case '\t':
+			return emit(parser, event, inputKey_tab, 0);
+		case 0x08:
+		case 0x7F:
+			return emit(parser, event, inputKey_backspace, 0);
+		case 0x00:
+			parser->modifiers |= inputModifier_ctrl;
+			return emit(parser, event, inputKey_codePoint, ' ');
+		default:
+			parser->modifiers |= inputModifier_ctrl;
+			// 0x01-0x1A map to 'a'-'z' while 0x1C-0x1F map to '\\', ']', '^', and '_'.
+			return emit(parser, event, inputKey_codePoint, b <= 0x1A ? b + 0x60 : b + 0x40);
+	}
+}
+
+static uint16_t xtermModifiers(int param) {
+	// Encoded as 1 plus a bitmask of shift (1), alt (2), and ctrl (4). Meta (8) is treated as alt.
+	if (param <= 1) {
+		return 0;
+	}
+	int bits = param - 1;
+	uint16_t modifiers = 0;
+	if (bits & 1) modifiers |= inputModifier_shift;
+	if (bits & (2 | 8)) modifiers |= inputModifier_alt;
+	if (bits & 4) modifiers |= inputModifier_ctrl;
+	return modifiers;
+}
+
+static uint16_t letterKey(uint8_t final) {
+	switch (final) {
+		case 'A': return inputKey_up;
+		case 'B': return inputKey_down;
+		case 'C': return inputKey_right;
+		case 'D': return inputKey_left;
+		case 'H': return inputKey_home;
+		case 'F': return inputKey_end;
+		case 'P': return inputKey_f1;
+		case 'Q': return inputKey_f1 + 1;
+		case 'R': return inputKey_f1 + 2;
+		case 'S': return inputKey_f1 + 3;
+		default: return 0;
+	}
+}
+
+static uint16_t tildeKey(int param) {
+	switch (param) {
+		case 1: case 7: return inputKey_home;
+		case 2: return inputKey_insert;
+		case 3: return inputKey_delete;
+		case 4: case 8: return inputKey_end;
+		case 5: return inputKey_pageUp;
+		case 6: return inputKey_pageDown;
+		case 11: case 12: case 13: case 14: case 15: return inputKey_f1 + param - 11;
+		case 17: case 18: case 19: case 20: case 21: return inputKey_f1 + param - 12;
+		case 23: case 24: return inputKey_f1 + param - 13;
+		default: return 0;
+	}
+}
+
+static int dispatchCsi(inputParserImpl *parser, inputEvent *event, uint8_t final) {
+	if (parser->privateMarker) {
+		// Responses to queries (e.g., mouse or device attributes) are not keys.
+		return 0;
+	}
+	int *params = parser->params;
+	uint16_t key;
+	switch (final) {
+		case '~':
+			if (params[0] == PASTE_START) {
+				parser->state = S_PASTE;
+				parser->pasteStart = parser->pasteLength;
+				parser->pasteEndMatched = 0;
+				parser->modifiers = 0;
+				return 0;
+			}
+			if (params[0] == PASTE_END) {
+				// An end without a start. Nothing to do.
+				return 0;
+			}
+			key = tildeKey(params[0]);
+			break;
+		case 'u':
+			// "CSI codepoint ; modifiers u" as defined by fixterms and the kitty keyboard protocol.
+			parser->modifiers |= xtermModifiers(params[1]);
+			return params[0] == 0x1B
+				? emit(parser, event, inputKey_escape, 0)
+				: params[0] < 0x20 || params[0] == 0x7F
+					? emitControl(parser, event, params[0])
+					: emit(parser, event, inputKey_codePoint, params[0]);
+		case 'Z':
+			parser->modifiers |= inputModifier_shift;
+			return emit(parser, event, inputKey_tab, 0);
+		case 'R':
+			// "CSI row ; column R" is a cursor position report, not F3, when both are present.
+			if (parser->paramCount > 1 && params[0] != 1) {
+				return 0;
+			}
+			key = letterKey(final);
+			break;
+		default:
+			key = letterKey(final);
+			break;
+	}
+	if (key == 0) {
+		return 0;
+	}
+	parser->modifiers |= xtermModifiers(params[1]);
+	return emit(parser, event, key, 0);
+}
+
+static void resetParams(inputParserImpl *parser) {
+	parser->paramCount = 0;
+	parser->privateMarker = 0;
+	memset(parser->params, 0, sizeof(parser->params));
+}
+
+static int step(inputParserImpl *parser, uint8_t b, inputEvent *events) {
+	uint8_t state = parser->state;
+	if (state == S_ESC && (b == '[' || b == 'O')) {
+		resetParams(parser);
+		parser->state = b == '[' ? S_CSI : S_SS3;
+		return 0;
+	}
+
+	transition t = transitions[state][byteClasses[b]];
+	parser->state = t.next;
+	switch (t.action) {
+		case A_NONE:
+			return 0;
+
+		case A_PRINT:
+			return emit(parser, events, inputKey_codePoint, b);
+
+		case A_CONTROL:
+			return emitControl(parser, events, b);
+
+		case A_ESC:
+			// Any partial sequence is discarded, but a pending alt must not leak onto the next key.
+			parser->modifiers = 0;
+			return 0;
+
+		case A_ESC_ESC:
+			return emit(parser, events, inputKey_escape, 0);
+
+		case A_ALT:
+			parser->modifiers |= inputModifier_alt;
+			return step(parser, b, events);
+
+		case A_PARAM:
+			if (b == ';') {
+				if (parser->paramCount == 0) {
+					parser->paramCount = 1;
+				}
+				if (parser->paramCount < MAX_PARAMS) {
+					parser->paramCount++;
+				}
+			} else if (b >= '0' && b <= '9') {
+				if (parser->paramCount == 0) {
+					parser->paramCount = 1;
+				}
+				int *param = &parser->params[parser->paramCount - 1];
+				// Clamp to avoid overflow from hostile input. No meaningful parameter is this large.
+				if (*param < 100000) {
+					*param = *param * 10 + (b - '0');
+				}
+			} else if (b >= '<' && b <= '?') {
+				parser->privateMarker = 1;
+			}
+			// ':' sub-parameters are accepted but ignored.
+			return 0;
+
+		case A_CSI_DISPATCH:
+			return dispatchCsi(parser, events, b);
+
+		case A_SS3_DISPATCH: {
+			uint16_t key = letterKey(b);
+			if (key == 0) {
+				parser->modifiers = 0;
+				return 0;
+			}
+			parser->modifiers |= xtermModifiers(parser->params[0]);
+			return emit(parser, events, key, 0);
+		}
+
+		case A_UTF8_START:
+			if (b < 0xE0) {
+				parser->codePoint = b & 0x1F;
+				parser->utf8Length = 2;
+			} else if (b < 0xF0) {
+				parser->codePoint = b & 0x0F;
+				parser->utf8Length = 3;
+			} else {
+				parser->codePoint = b & 0x07;
+				parser->utf8Length = 4;
+			}
+			parser->utf8Remaining = parser->utf8Length - 1;
+			return 0;
+
+		case A_UTF8_CONTINUE: {
+			uint32_t codePoint = (parser->codePoint << 6) | (b & 0x3F);
+			parser->codePoint = codePoint;
+			if (--parser->utf8Remaining != 0) {
+				return 0;
+			}
+			parser->state = S_GROUND;
+			// Reject overlong encodings, surrogates, and values beyond the Unicode range.
+			if ((parser->utf8Length == 3 && codePoint < 0x800)
+				|| (parser->utf8Length == 4 && (codePoint < 0x10000 || codePoint > 0x10FFFF))
+				|| (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+				codePoint = REPLACEMENT_CHARACTER;
+			}
+			return emit(parser, events, inputKey_codePoint, codePoint);
+		}
+
+		case A_INVALID:
+			return emit(parser, events, inputKey_codePoint, REPLACEMENT_CHARACTER);
+
+		case A_ABORT: {
+			int count = emit(parser, events, inputKey_codePoint, REPLACEMENT_CHARACTER);
+			return count + step(parser, b, events + count);
+		}
+	}
+	return 0;
+}
+
+static void appendPaste(inputParserImpl *parser, const void *bytes, int count) {
+	if (count == 0) {
+		return; // The buffer might not exist yet.
+	}
+	int required = parser->pasteLength + count;
+	if (unlikely(required > parser->pasteCapacity)) {
+		int capacity = parser->pasteCapacity * 2;
+		if (capacity < required) {
+			capacity = required < 4096 ? 4096 : required;
+		}
+		char *paste = realloc(parser->paste, capacity);
+		if (unlikely(paste == NULL)) {
+			// Truncate the paste rather than fail all input.
+			return;
+		}
+		parser->paste = paste;
+		parser->pasteCapacity = capacity;
+	}
+	memcpy(parser->paste + parser->pasteLength, bytes, count);
+	parser->pasteLength = required;
+}
+
+/**
+ * Consume bytes of paste content until the end marker or the end of the buffer, returning how many
+ * were consumed. 'emitted' is set to 1 if the paste completed and an event was written.
+ */
+static int consumePaste(inputParserImpl *parser, const uint8_t *bytes, int count, inputEvent *event, int *emitted) {
+	int i = 0;
+	while (i < count) {
+		uint8_t matched = parser->pasteEndMatched;
+		if (matched == 0) {
+			// Copy everything up to the next escape, which might begin the end marker, in bulk.
+			const uint8_t *esc = memchr(bytes + i, 0x1B, count - i);
+			int run = esc == NULL ? count - i : esc - (bytes + i);
+			appendPaste(parser, bytes + i, run);
+			i += run;
+			if (esc == NULL) {
+				break;
+			}
+			parser->pasteEndMatched = 1;
+			i++;
+			continue;
+		}
+
+		if (bytes[i] == (uint8_t) pasteEnd[matched]) {
+			i++;
+			if (++parser->pasteEndMatched == PASTE_END_LENGTH) {
+				parser->pasteEndMatched = 0;
+				parser->state = S_GROUND;
+				*emitted = emit(parser, event, inputKey_paste, parser->pasteLength - parser->pasteStart);
+				parser->pasteStart = parser->pasteLength;
+				break;
+			}
+		} else {
+			// The withheld bytes were content after all. Reprocess this byte from the start.
+			appendPaste(parser, pasteEnd, matched);
+			parser->pasteEndMatched = 0;
+		}
+	}
+	return i;
+}
+
+int inputParser_parse(inputParser *parser, const char *buffer, int count, inputEvent *events) {
+	// Discard pastes from the previous call while retaining any which is still in progress.
+	if (parser->state == S_PASTE) {
+		int inProgress = parser->pasteLength - parser->pasteStart;
+		if (inProgress > 0) {
+			memmove(parser->paste, parser->paste + parser->pasteStart, inProgress);
+		}
+		parser->pasteLength = inProgress;
+	} else {
+		parser->pasteLength = 0;
+	}
+	parser->pasteStart = 0;
+
+	const uint8_t *bytes = (const uint8_t *) buffer;
+	inputEvent *event = events;
+	for (int i = 0; i < count; i++) {
+		if (unlikely(parser->state == S_PASTE)) {
+			int emitted = 0;
+			// Offset by one to account for this loop's increment.
+			i += consumePaste(parser, bytes + i, count - i, event, &emitted) - 1;
+			event += emitted;
+			continue;
+		}
+		uint8_t b = bytes[i];
+		// Fast path for the overwhelmingly common case of printable ASCII with nothing pending.
+		if (likely(parser->state == S_GROUND && b >= 0x20 && b < 0x7F)) {
+			event->key = inputKey_codePoint;
+			event->modifiers = 0;
+			event->codePoint = b;
+			event++;
+			continue;
+		}
+		event += step(parser, b, event);
+	}
+	return event - events;
+}
+
+int inputParser_hasPending(inputParser *parser) {
+	// An in-progress paste is not ambiguous. It is always completed by its end marker.
+	return parser->state != S_GROUND && parser->state != S_PASTE;
+}
+
+int inputParser_flush(inputParser *parser, inputEvent *events) {
+	uint8_t state = parser->state;
+	if (state == S_PASTE) {
+		return 0;
+	}
+	parser->state = S_GROUND;
+	switch (state) {
+		case S_ESC:
+			return emit(parser, events, inputKey_escape, 0);
+		case S_CSI:
+		case S_SS3:
+			if (parser->paramCount == 0 && !parser->privateMarker) {
+				// Nothing followed the introducer so this was really alt+'[' or alt+'O'.
+				parser->modifiers |= inputModifier_alt;
+				return emit(parser, events, inputKey_codePoint, state == S_CSI ? '[' : 'O');
+			}
+			parser->modifiers = 0;
+			return 0;
+		case S_UTF8:
+			return emit(parser, events, inputKey_codePoint, REPLACEMENT_CHARACTER);
+		default:
+			return 0;
+	}
+}
+
+const char *inputParser_paste(inputParser *parser, int offset, int length) {
+	if (unlikely(offset < 0 || length < 0 || offset > parser->pasteStart - length)) {
+		return NULL;
+	}
+	if (length == 0) {
+		return ""; // The buffer does not exist until a paste has content.
+	}
+	return parser->paste + offset;
+}
+
+void inputParser_free(inputParser *parser) {
+	free(parser->paste);
+	free(parser);
+}
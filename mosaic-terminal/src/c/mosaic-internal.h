@@ -0,0 +1,61 @@
+#ifndef MOSAIC_INTERNAL_H
+#define MOSAIC_INTERNAL_H
+
+// Functions shared between the native sources which are not part of the API in mosaic.h.
+
+#include "mosaic.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+
+/** The non-blocking read end of the self-pipe which is written when SIGWINCH is received. */
+int resizeNotifier_signalFd(resizeNotifier *notifier);
+/** Consume all pending signals from the self-pipe. */
+void resizeNotifier_drainSignal(resizeNotifier *notifier);
+
+/** Create an event loop which watches 'stdinFd' as its stdin, or no stdin when -1. */
+eventLoopResult eventLoop_initWithFd(int stdinFd, int watchResize);
+
+/** Create a writer which writes to 'stdoutFd' rather than stdout. */
+stdoutWriterResult stdoutWriter_initWithFd(int stdoutFd);
+
+#endif
+
+#if defined(__linux__)
+
+/**
+ * A minimal io_uring instance used by the stdin reader and stdout writer in place of poll when
+ * the MOSAIC_IO_URING environment variable is "1".
+ */
+typedef struct uringImpl uring;
+
+/**
+ * Create a ring with at least 'entries' submission queue entries. Returns NULL when io_uring is
+ * not enabled, when it or any of the features used are not supported by the kernel, or when it is
+ * blocked (e.g., by seccomp). Callers then fall back to poll.
+ */
+uring *uring_init(unsigned entries);
+/** Prepare a read at the current file position. Returns -1 if the submission queue is full. */
+int uring_prepRead(uring *ring, int fd, void *buffer, unsigned count, uint64_t userData);
+/** Prepare a write at the current file position. Returns -1 if the submission queue is full. */
+int uring_prepWrite(uring *ring, int fd, const void *buffer, unsigned count, uint64_t userData);
+/** Prepare a one-shot poll for 'pollEvents'. Returns -1 if the submission queue is full. */
+int uring_prepPoll(uring *ring, int fd, unsigned pollEvents, uint64_t userData);
+/**
+ * Prepare the cancellation of the request submitted with 'targetUserData'. Both that request and
+ * this one complete. Returns -1 if the submission queue is full.
+ */
+int uring_prepCancel(uring *ring, uint64_t targetUserData, uint64_t userData);
+/** Consume one completion into 'userData' and 'res'. Returns 0 if there are none. */
+int uring_peek(uring *ring, uint64_t *userData, int *res);
+/**
+ * Submit all prepared entries and wait until at least 'minComplete' completions are available or
+ * 'timeoutNanos' elapses. A negative timeout waits indefinitely. Returns ETIME on timeout and
+ * EINTR when interrupted by a signal.
+ */
+platformError uring_enter(uring *ring, unsigned minComplete, int64_t timeoutNanos);
+/** Close the ring, cancelling any requests which are still in flight. */
+void uring_free(uring *ring);
+
+#endif
+
+#endif // MOSAIC_INTERNAL_H
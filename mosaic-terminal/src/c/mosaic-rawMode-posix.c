@@ -9,6 +9,9 @@
 #include <termios.h>
 #include <unistd.h>
 
+static const char bracketedPasteEnable[] = "\x1b[?2004h";
+static const char bracketedPasteDisable[] = "\x1b[?2004l";
+
 rawModeResult enterRawMode() {
 	rawModeResult result = {};
 
@@ -43,6 +46,10 @@ rawModeResult enterRawMode() {
 		goto err;
 	}
 
+	// Ask the terminal to wrap pasted text in markers so that it can be delivered as a single event.
+	// Terminals which do not support this mode ignore the request, so the result is not checked.
+	write(STDOUT_FILENO, bracketedPasteEnable, sizeof(bracketedPasteEnable) - 1);
+
 	result.saved = saved;
 
 	ret:
@@ -54,6 +61,8 @@ rawModeResult enterRawMode() {
 }
 
 platformError exitRawMode(rawModeConfig *saved) {
+	write(STDOUT_FILENO, bracketedPasteDisable, sizeof(bracketedPasteDisable) - 1);
+
 	int result = unlikely(tcsetattr(STDIN_FILENO, TCSAFLUSH, saved) != 0)
 		? errno
 		: 0;
@@ -11,6 +11,9 @@ typedef struct rawModeConfigWindows {
 	UINT output_code_page;
 } rawModeConfigWindows;
 
+static const char bracketedPasteEnable[] = "\x1b[?2004h";
+static const char bracketedPasteDisable[] = "\x1b[?2004l";
+
 rawModeResult enterRawMode() {
 	rawModeResult result = {};
 
@@ -44,7 +47,7 @@ rawModeResult enterRawMode() {
 		goto err;
 	}
 
-	if (unlikely(SetConsoleMode(stdin, ENABLE_WINDOW_INPUT | ENABLE_MOUSE_INPUT | ENABLE_EXTENDED_FLAGS) == 0)) {
+	if (unlikely(SetConsoleMode(stdin, ENABLE_WINDOW_INPUT | ENABLE_MOUSE_INPUT | ENABLE_EXTENDED_FLAGS | ENABLE_VIRTUAL_TERMINAL_INPUT) == 0)) {
 		result.error = GetLastError();
 		goto err;
 	}
@@ -60,6 +63,11 @@ rawModeResult enterRawMode() {
 		goto err;
 	}
 
+	// Ask the terminal to wrap pasted text in markers so that it can be delivered as a single event.
+	// Terminals which do not support this mode ignore the request, so the result is not checked.
+	DWORD written;
+	WriteFile(stdout, bracketedPasteEnable, sizeof(bracketedPasteEnable) - 1, &written, NULL);
+
 	result.saved = saved;
 
 	ret:
@@ -84,6 +92,9 @@ platformError exitRawMode(rawModeConfig *saved) {
 		goto done;
 	}
 
+	DWORD written;
+	WriteFile(stdout, bracketedPasteDisable, sizeof(bracketedPasteDisable) - 1, &written, NULL);
+
 	// Try to restore all three properties even if some fail.
 	if (unlikely(SetConsoleMode(stdin, saved->input_mode) == 0)) {
 		result = GetLastError();
@@ -0,0 +1,248 @@
+#include "mosaic.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+
+#include "cutils.h"
+#include "mosaic-internal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+typedef struct resizeNotifierImpl {
+	// Index 0 is read when waiting and index 1 is written by the signal handler.
+	int signalPipe[2];
+	int interruptPipe[2];
+	// Index 0 is the signal pipe and index 1 is the interrupt pipe.
+	struct pollfd fds[2];
+	/** The index of this notifier's signal pipe in signalPipes. */
+	int slot;
+} resizeNotifierImpl;
+
+/** The most notifiers which can exist at the same time. */
+#define maxNotifiers 32
+
+// Signal handlers cannot receive context, so the write end of every notifier's self-pipe is kept
+// in a global table where unused slots are -1. Each notifier needs its own pipe since whichever
+// one drained a shared pipe would hide the resize from the others. The handler itself is shared,
+// installed by the first notifier and replaced by the previous handler when the last is freed.
+static int signalPipes[maxNotifiers] = { [0 ... maxNotifiers - 1] = -1 };
+/** The number of signal handlers which are currently writing to signalPipes. */
+static int runningHandlers = 0;
+
+/** Guards notifierCount, savedAction, and changes to signalPipes. */
+static pthread_mutex_t notifiersLock = PTHREAD_MUTEX_INITIALIZER;
+static int notifierCount = 0;
+static struct sigaction savedAction;
+
+static void resizeNotifier_onSignal(int signal) {
+	(void) signal;
+	int savedErrno = errno;
+	__atomic_add_fetch(&runningHandlers, 1, __ATOMIC_SEQ_CST);
+	for (int i = 0; i < maxNotifiers; i++) {
+		int fd = __atomic_load_n(&signalPipes[i], __ATOMIC_SEQ_CST);
+		if (fd != -1) {
+			// The pipe is non-blocking. If it is full a wakeup is already pending so failure is fine.
+			write(fd, " ", 1);
+		}
+	}
+	__atomic_sub_fetch(&runningHandlers, 1, __ATOMIC_SEQ_CST);
+	errno = savedErrno;
+}
+
+/** Create a non-blocking pipe whose ends are not inherited by child processes. */
+static int openPipe(int fds[2]) {
+	// macOS has no pipe2, so the flags are set after creation on every platform.
+	if (unlikely(pipe(fds) != 0)) {
+		return -1;
+	}
+	for (int i = 0; i < 2; i++) {
+		int flags = fcntl(fds[i], F_GETFL);
+		if (unlikely(flags == -1)
+			|| unlikely(fcntl(fds[i], F_SETFL, flags | O_NONBLOCK) == -1)
+			|| unlikely(fcntl(fds[i], F_SETFD, FD_CLOEXEC) == -1)) {
+			int savedErrno = errno;
+			close(fds[0]);
+			close(fds[1]);
+			errno = savedErrno;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void drain(int fd) {
+	char buffer[16];
+	while (read(fd, buffer, sizeof(buffer)) > 0) {
+		// Keep reading until EAGAIN.
+	}
+}
+
+terminalSize getTerminalSize() {
+	terminalSize result = {};
+
+	struct winsize size;
+	// Prefer stdout since that is where the output is being rendered, but it may be redirected.
+	if (likely(ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0)
+		|| ioctl(STDIN_FILENO, TIOCGWINSZ, &size) == 0) {
+		result.columns = size.ws_col;
+		result.rows = size.ws_row;
+	} else {
+		result.error = errno;
+	}
+
+	return result;
+}
+
+resizeNotifierResult resizeNotifier_init() {
+	resizeNotifierResult result = {};
+
+	resizeNotifierImpl *notifier = calloc(1, sizeof(resizeNotifierImpl));
+	if (unlikely(notifier == NULL)) {
+		// result.notifier is set to 0 which will trigger OOM.
+		goto ret;
+	}
+
+	if (unlikely(openPipe(notifier->signalPipe) != 0)) {
+		result.error = errno;
+		goto err;
+	}
+	if (unlikely(openPipe(notifier->interruptPipe) != 0)) {
+		result.error = errno;
+		goto errSignalPipe;
+	}
+
+	notifier->fds[0].fd = notifier->signalPipe[0];
+	notifier->fds[0].events = POLLIN;
+	notifier->fds[1].fd = notifier->interruptPipe[0];
+	notifier->fds[1].events = POLLIN;
+
+	pthread_mutex_lock(&notifiersLock);
+
+	notifier->slot = -1;
+	for (int i = 0; i < maxNotifiers; i++) {
+		if (signalPipes[i] == -1) {
+			notifier->slot = i;
+			break;
+		}
+	}
+	if (unlikely(notifier->slot == -1)) {
+		result.error = EBUSY;
+		goto errUnlock;
+	}
+
+	if (notifierCount == 0) {
+		struct sigaction action = {};
+		action.sa_handler = resizeNotifier_onSignal;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_RESTART;
+		if (unlikely(sigaction(SIGWINCH, &action, &savedAction) != 0)) {
+			result.error = errno;
+			goto errUnlock;
+		}
+	}
+	notifierCount++;
+	__atomic_store_n(&signalPipes[notifier->slot], notifier->signalPipe[1], __ATOMIC_SEQ_CST);
+
+	pthread_mutex_unlock(&notifiersLock);
+
+	result.notifier = notifier;
+
+	ret:
+	return result;
+
+	errUnlock:
+	pthread_mutex_unlock(&notifiersLock);
+	close(notifier->interruptPipe[0]);
+	close(notifier->interruptPipe[1]);
+
+	errSignalPipe:
+	close(notifier->signalPipe[0]);
+	close(notifier->signalPipe[1]);
+
+	err:
+	free(notifier);
+	goto ret;
+}
+
+terminalSize resizeNotifier_await(resizeNotifier *notifier) {
+	while (unlikely(poll(notifier->fds, 2, -1) == -1)) {
+		// The signal we are waiting for can itself interrupt the call.
+		if (errno != EINTR) {
+			terminalSize result = {};
+			result.error = errno;
+			return result;
+		}
+	}
+
+	if (notifier->fds[1].revents != 0) {
+		drain(notifier->interruptPipe[0]);
+		terminalSize result = {};
+		result.interrupted = 1;
+		return result;
+	}
+
+	// Multiple signals may have arrived since the last wait. Only the latest size matters.
+	drain(notifier->signalPipe[0]);
+	return getTerminalSize();
+}
+
+int resizeNotifier_signalFd(resizeNotifier *notifier) {
+	return notifier->signalPipe[0];
+}
+
+void resizeNotifier_drainSignal(resizeNotifier *notifier) {
+	drain(notifier->signalPipe[0]);
+}
+
+platformError resizeNotifier_fds(resizeNotifier *notifier, int *signalFd, int *interruptFd) {
+	*signalFd = notifier->signalPipe[0];
+	*interruptFd = notifier->interruptPipe[0];
+	return 0;
+}
+
+platformError resizeNotifier_interrupt(resizeNotifier *notifier) {
+	int result = write(notifier->interruptPipe[1], " ", 1);
+	// The pipe is non-blocking. If it is full an interrupt is already pending so failure is fine.
+	return unlikely(result == -1 && errno != EAGAIN)
+		? errno
+		: 0;
+}
+
+platformError resizeNotifier_free(resizeNotifier *notifier) {
+	int result = 0;
+
+	pthread_mutex_lock(&notifiersLock);
+	__atomic_store_n(&signalPipes[notifier->slot], -1, __ATOMIC_SEQ_CST);
+	notifierCount--;
+	if (notifierCount == 0 && unlikely(sigaction(SIGWINCH, &savedAction, NULL) != 0)) {
+		result = errno;
+	}
+	pthread_mutex_unlock(&notifiersLock);
+
+	// A handler running on another thread may have read the write end before it was removed.
+	while (__atomic_load_n(&runningHandlers, __ATOMIC_SEQ_CST) != 0) {
+		sched_yield();
+	}
+
+	int fds[4] = {
+		notifier->signalPipe[0],
+		notifier->signalPipe[1],
+		notifier->interruptPipe[0],
+		notifier->interruptPipe[1],
+	};
+	for (int i = 0; i < 4; i++) {
+		if (unlikely(close(fds[i]) != 0 && result == 0)) {
+			result = errno;
+		}
+	}
+	free(notifier);
+	return result;
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "mosaic.h"
+
+#if defined(WIN32)
+
+#include "cutils.h"
+#include <Windows.h>
+#include <stdlib.h>
+
+// Windows has no resize signal. Resizes are only reported as console input records which would
+// compete with the stdin reader for consumption, so the size is instead checked periodically.
+#define RESIZE_POLL_MILLIS 100
+
+typedef struct resizeNotifierImpl {
+	HANDLE interruptEvent;
+	terminalSize lastSize;
+} resizeNotifierImpl;
+
+terminalSize getTerminalSize() {
+	terminalSize result = {};
+
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (likely(GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info) != 0)) {
+		result.columns = info.srWindow.Right - info.srWindow.Left + 1;
+		result.rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+	} else {
+		result.error = GetLastError();
+	}
+
+	return result;
+}
+
+resizeNotifierResult resizeNotifier_init() {
+	resizeNotifierResult result = {};
+
+	resizeNotifierImpl *notifier = calloc(1, sizeof(resizeNotifierImpl));
+	if (unlikely(notifier == NULL)) {
+		// result.notifier is set to 0 which will trigger OOM.
+		goto ret;
+	}
+
+	HANDLE interruptEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (unlikely(interruptEvent == NULL)) {
+		result.error = GetLastError();
+		goto err;
+	}
+	notifier->interruptEvent = interruptEvent;
+	notifier->lastSize = getTerminalSize();
+
+	result.notifier = notifier;
+
+	ret:
+	return result;
+
+	err:
+	free(notifier);
+	goto ret;
+}
+
+terminalSize resizeNotifier_await(resizeNotifier *notifier) {
+	while (1) {
+		DWORD waitResult = WaitForSingleObject(notifier->interruptEvent, RESIZE_POLL_MILLIS);
+		if (waitResult == WAIT_OBJECT_0) {
+			terminalSize result = {};
+			result.interrupted = 1;
+			return result;
+		}
+		if (unlikely(waitResult == WAIT_FAILED)) {
+			terminalSize result = {};
+			result.error = GetLastError();
+			return result;
+		}
+
+		terminalSize size = getTerminalSize();
+		if (size.error == 0
+			&& (size.columns != notifier->lastSize.columns || size.rows != notifier->lastSize.rows)) {
+			notifier->lastSize = size;
+			return size;
+		}
+	}
+}
+
+platformError resizeNotifier_fds(resizeNotifier *notifier, int *signalFd, int *interruptFd) {
+	return ERROR_NOT_SUPPORTED;
+}
+
+platformError resizeNotifier_interrupt(resizeNotifier *notifier) {
+	return likely(SetEvent(notifier->interruptEvent) != 0)
+		? 0
+		: GetLastError();
+}
+
+platformError resizeNotifier_free(resizeNotifier *notifier) {
+	DWORD result = 0;
+	if (unlikely(CloseHandle(notifier->interruptEvent) == 0)) {
+		result = GetLastError();
+	}
+	free(notifier);
+	return result;
+}
+
+#endif
@@ -0,0 +1,286 @@
+#include "mosaic.h"
+
+#include "cutils.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define STYLE_BOLD 8
+#define STYLE_DIM 16
+#define STYLE_ITALIC 32
+#define STYLE_UNDERLINE 2
+#define STYLE_INVERT 64
+#define STYLE_STRIKETHROUGH 4
+
+typedef struct decimal {
+	char chars[3];
+	uint8_t length;
+} decimal;
+
+// Every SGR parameter we emit is in [0, 255] so they are all formatted by lookup.
+static const decimal decimals[256] = {
+	{"0", 1}, {"1", 1}, {"2", 1}, {"3", 1}, {"4", 1}, {"5", 1}, {"6", 1}, {"7", 1}, {"8", 1}, {"9", 1}, {"10", 2}, {"11", 2},
+	{"12", 2}, {"13", 2}, {"14", 2}, {"15", 2}, {"16", 2}, {"17", 2}, {"18", 2}, {"19", 2}, {"20", 2}, {"21", 2}, {"22", 2}, {"23", 2},
+	{"24", 2}, {"25", 2}, {"26", 2}, {"27", 2}, {"28", 2}, {"29", 2}, {"30", 2}, {"31", 2}, {"32", 2}, {"33", 2}, {"34", 2}, {"35", 2},
+	{"36", 2}, {"37", 2}, {"38", 2}, {"39", 2}, {"40", 2}, {"41", 2}, {"42", 2}, {"43", 2}, {"44", 2}, {"45", 2}, {"46", 2}, {"47", 2},
+	{"48", 2}, {"49", 2}, {"50", 2}, {"51", 2}, {"52", 2}, {"53", 2}, {"54", 2}, {"55", 2}, {"56", 2}, {"57", 2}, {"58", 2}, {"59", 2},
+	{"60", 2}, {"61", 2}, {"62", 2}, {"63", 2}, {"64", 2}, {"65", 2}, {"66", 2}, {"67", 2}, {"68", 2}, {"69", 2}, {"70", 2}, {"71", 2},
+	{"72", 2}, {"73", 2}, {"74", 2}, {"75", 2}, {"76", 2}, {"77", 2}, {"78", 2}, {"79", 2}, {"80", 2}, {"81", 2}, {"82", 2}, {"83", 2},
+	{"84", 2}, {"85", 2}, {"86", 2}, {"87", 2}, {"88", 2}, {"89", 2}, {"90", 2}, {"91", 2}, {"92", 2}, {"93", 2}, {"94", 2}, {"95", 2},
+	{"96", 2}, {"97", 2}, {"98", 2}, {"99", 2}, {"100", 3}, {"101", 3}, {"102", 3}, {"103", 3}, {"104", 3}, {"105", 3}, {"106", 3}, {"107", 3},
+	{"108", 3}, {"109", 3}, {"110", 3}, {"111", 3}, {"112", 3}, {"113", 3}, {"114", 3}, {"115", 3}, {"116", 3}, {"117", 3}, {"118", 3}, {"119", 3},
+	{"120", 3}, {"121", 3}, {"122", 3}, {"123", 3}, {"124", 3}, {"125", 3}, {"126", 3}, {"127", 3}, {"128", 3}, {"129", 3}, {"130", 3}, {"131", 3},
+	{"132", 3}, {"133", 3}, {"134", 3}, {"135", 3}, {"136", 3}, {"137", 3}, {"138", 3}, {"139", 3}, {"140", 3}, {"141", 3}, {"142", 3}, {"143", 3},
+	{"144", 3}, {"145", 3}, {"146", 3}, {"147", 3}, {"148", 3}, {"149", 3}, {"150", 3}, {"151", 3}, {"152", 3}, {"153", 3}, {"154", 3}, {"155", 3},
+	{"156", 3}, {"157", 3}, {"158", 3}, {"159", 3}, {"160", 3}, {"161", 3}, {"162", 3}, {"163", 3}, {"164", 3}, {"165", 3}, {"166", 3}, {"167", 3},
+	{"168", 3}, {"169", 3}, {"170", 3}, {"171", 3}, {"172", 3}, {"173", 3}, {"174", 3}, {"175", 3}, {"176", 3}, {"177", 3}, {"178", 3}, {"179", 3},
+	{"180", 3}, {"181", 3}, {"182", 3}, {"183", 3}, {"184", 3}, {"185", 3}, {"186", 3}, {"187", 3}, {"188", 3}, {"189", 3}, {"190", 3}, {"191", 3},
+	{"192", 3}, {"193", 3}, {"194", 3}, {"195", 3}, {"196", 3}, {"197", 3}, {"198", 3}, {"199", 3}, {"200", 3}, {"201", 3}, {"202", 3}, {"203", 3},
+	{"204", 3}, {"205", 3}, {"206", 3}, {"207", 3}, {"208", 3}, {"209", 3}, {"210", 3}, {"211", 3}, {"212", 3}, {"213", 3}, {"214", 3}, {"215", 3},
+	{"216", 3}, {"217", 3}, {"218", 3}, {"219", 3}, {"220", 3}, {"221", 3}, {"222", 3}, {"223", 3}, {"224", 3}, {"225", 3}, {"226", 3}, {"227", 3},
+	{"228", 3}, {"229", 3}, {"230", 3}, {"231", 3}, {"232", 3}, {"233", 3}, {"234", 3}, {"235", 3}, {"236", 3}, {"237", 3}, {"238", 3}, {"239", 3},
+	{"240", 3}, {"241", 3}, {"242", 3}, {"243", 3}, {"244", 3}, {"245", 3}, {"246", 3}, {"247", 3}, {"248", 3}, {"249", 3}, {"250", 3}, {"251", 3},
+	{"252", 3}, {"253", 3}, {"254", 3}, {"255", 3},
+};
+
+static inline char *appendParameter(char *out, int value) {
+	// All three bytes are copied unconditionally. Any excess is overwritten by what follows.
+	const decimal *d = &decimals[value];
+	memcpy(out, d->chars, 3);
+	out += d->length;
+	*out++ = ';';
+	return out;
+}
+
+// Equivalent to Kotlin's roundToInt for the non-negative values used below.
+static inline int roundToInt(double value) {
+	return (int) (value + 0.5);
+}
+
+// Must produce the same codes as toAnsi16Code in the runtime.
+static int ansi16Code(uint32_t color) {
+	int red = (color >> 16) & 0xFF;
+	int green = (color >> 8) & 0xFF;
+	int blue = color & 0xFF;
+	int max = red > green ? red : green;
+	max = max > blue ? max : blue;
+
+	int value = roundToInt((float) max / 255.0f * 100);
+	if (value == 30) {
+		return 30;
+	}
+	int code = 30 + (
+		(roundToInt(blue / 255.0f) * 4) |
+		(roundToInt(green / 255.0f) * 2) |
+		roundToInt(red / 255.0f)
+	);
+	return value / 50 == 2 ? code + 60 : code;
+}
+
+// Must produce the same codes as toAnsi256Code in the runtime.
+static int ansi256Code(uint32_t color) {
+	int red = (color >> 16) & 0xFF;
+	int green = (color >> 8) & 0xFF;
+	int blue = color & 0xFF;
+	if (red == green && green == blue) {
+		if (red < 8) return 16;
+		if (red > 248) return 231;
+		return roundToInt(((red - 8) / 247.0) * 24.0) + 232;
+	}
+	return 16 +
+		36 * roundToInt(red / 255.0f * 5) +
+		6 * roundToInt(green / 255.0f * 5) +
+		roundToInt(blue / 255.0f * 5);
+}
+
+static char *appendColor(char *out, uint32_t color, int colorLevel, int select, int reset, int offset) {
+	if (color == cellGrid_defaultColor) {
+		return appendParameter(out, reset);
+	}
+	switch (colorLevel) {
+		case cellGrid_colorLevel16: {
+			int code = ansi16Code(color);
+			return appendParameter(out, code + offset);
+		}
+		case cellGrid_colorLevel256:
+			out = appendParameter(out, select);
+			out = appendParameter(out, 5);
+			return appendParameter(out, ansi256Code(color));
+		default:
+			out = appendParameter(out, select);
+			out = appendParameter(out, 2);
+			out = appendParameter(out, (color >> 16) & 0xFF);
+			out = appendParameter(out, (color >> 8) & 0xFF);
+			return appendParameter(out, color & 0xFF);
+	}
+}
+
+static inline char *toggleStyle(char *out, uint32_t style, uint32_t lastStyle, uint32_t bit, int on, int off) {
+	if ((style & bit) == bit) {
+		if ((lastStyle & bit) != bit) {
+			out = appendParameter(out, on);
+		}
+	} else if ((lastStyle & bit) == bit) {
+		out = appendParameter(out, off);
+	}
+	return out;
+}
+
+static char *appendAttributes(char *out, const uint32_t *cell, const uint32_t *last, int colorLevel) {
+	char *start = out;
+	out[0] = '\x1b';
+	out[1] = '[';
+	out += 2;
+
+	if (cell[1] != last[1]) {
+		out = appendColor(out, cell[1], colorLevel, 38, 39, 0);
+	}
+	if (cell[2] != last[2]) {
+		out = appendColor(out, cell[2], colorLevel, 48, 49, 10);
+	}
+	uint32_t style = cell[3];
+	uint32_t lastStyle = last[3];
+	if (style != lastStyle) {
+		out = toggleStyle(out, style, lastStyle, STYLE_BOLD, 1, 22);
+		out = toggleStyle(out, style, lastStyle, STYLE_DIM, 2, 22);
+		out = toggleStyle(out, style, lastStyle, STYLE_ITALIC, 3, 23);
+		out = toggleStyle(out, style, lastStyle, STYLE_UNDERLINE, 4, 24);
+		out = toggleStyle(out, style, lastStyle, STYLE_INVERT, 7, 27);
+		out = toggleStyle(out, style, lastStyle, STYLE_STRIKETHROUGH, 9, 29);
+	}
+
+	if (out == start + 2) {
+		// Nothing changed. Drop the introducer.
+		return start;
+	}
+	// Replace the trailing separator with the terminator.
+	out[-1] = 'm';
+	return out;
+}
+
+static inline char *appendCodePoint(char *out, uint32_t codePoint) {
+	if (likely(codePoint < 0x80)) {
+		*out++ = (char) codePoint;
+		return out;
+	}
+	if (unlikely(codePoint >= 0x110000 || (codePoint >= 0xD800 && codePoint <= 0xDFFF))) {
+		if (codePoint == cellGrid_wideContinuation) {
+			// Already covered by the wide character in the previous cell.
+			return out;
+		}
+		codePoint = 0xFFFD;
+	}
+	if (codePoint < 0x800) {
+		*out++ = (char) (0xC0 | (codePoint >> 6));
+		*out++ = (char) (0x80 | (codePoint & 0x3F));
+	} else if (codePoint < 0x10000) {
+		*out++ = (char) (0xE0 | (codePoint >> 12));
+		*out++ = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+		*out++ = (char) (0x80 | (codePoint & 0x3F));
+	} else {
+		*out++ = (char) (0xF0 | (codePoint >> 18));
+		*out++ = (char) (0x80 | ((codePoint >> 12) & 0x3F));
+		*out++ = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+		*out++ = (char) (0x80 | (codePoint & 0x3F));
+	}
+	return out;
+}
+
+/**
+ * Return the index of the first cell in [index, count) whose attributes differ from those of the
+ * cell before it, or 'count' if there is none. 'index' must be at least 1.
+ */
+static inline int nextAttributeChange(const uint32_t *cells, int index, int count) {
+#if defined(__AVX2__)
+	// Compare two pairs of adjacent cells at once: [index - 1, index] and [index, index + 1].
+	for (; index + 1 < count; index += 2) {
+		__m256i previous = _mm256_loadu_si256((const __m256i *) (cells + (index - 1) * cellGrid_cellWords));
+		__m256i current = _mm256_loadu_si256((const __m256i *) (cells + index * cellGrid_cellWords));
+		int equal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(previous, current)));
+		// Lanes 0 and 4 are code points which are expected to change.
+		if ((equal & 0xEE) != 0xEE) {
+			return (equal & 0xE) != 0xE ? index : index + 1;
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	for (; index < count; index++) {
+		__m128i previous = _mm_loadu_si128((const __m128i *) (cells + (index - 1) * cellGrid_cellWords));
+		__m128i current = _mm_loadu_si128((const __m128i *) (cells + index * cellGrid_cellWords));
+		int equal = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(previous, current)));
+		// Lane 0 is the code point which is expected to change. Only the attribute lanes matter.
+		if ((equal & 0xE) != 0xE) {
+			break;
+		}
+	}
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	for (; index < count; index++) {
+		uint32x4_t previous = vld1q_u32(cells + (index - 1) * cellGrid_cellWords);
+		uint32x4_t current = vld1q_u32(cells + index * cellGrid_cellWords);
+		uint32x4_t equal = vceqq_u32(previous, current);
+		// Lane 0 is the code point which is expected to change. Only the attribute lanes matter.
+		equal = vsetq_lane_u32(UINT32_MAX, equal, 0);
+		if (vminvq_u32(equal) != UINT32_MAX) {
+			break;
+		}
+	}
+#else
+	for (; index < count; index++) {
+		const uint32_t *previous = cells + (index - 1) * cellGrid_cellWords;
+		const uint32_t *current = previous + cellGrid_cellWords;
+		if (previous[1] != current[1] || previous[2] != current[2] || previous[3] != current[3]) {
+			break;
+		}
+	}
+#endif
+	return index;
+}
+
+int cellGrid_encodeRow(const uint32_t *cells, int count, int colorLevel, char *out) {
+	char *start = out;
+	static const uint32_t blank[cellGrid_cellWords] = {
+		' ',
+		cellGrid_defaultColor,
+		cellGrid_defaultColor,
+		cellGrid_emptyStyle,
+	};
+	const uint32_t *last = blank;
+
+	if (colorLevel == cellGrid_colorLevelNone) {
+		for (int index = 0; index < count; index++) {
+			out = appendCodePoint(out, cells[index * cellGrid_cellWords]);
+		}
+		if (count > 0) {
+			last = cells + (count - 1) * cellGrid_cellWords;
+		}
+	} else {
+		int index = 0;
+		while (index < count) {
+			const uint32_t *cell = cells + index * cellGrid_cellWords;
+			out = appendAttributes(out, cell, last, colorLevel);
+			last = cell;
+
+			// Cells up to the next boundary share these attributes so only their code points are needed.
+			int end = nextAttributeChange(cells, index + 1, count);
+			for (; index < end; index++) {
+				out = appendCodePoint(out, cells[index * cellGrid_cellWords]);
+			}
+		}
+	}
+
+	if (last[1] != cellGrid_defaultColor ||
+		last[2] != cellGrid_defaultColor ||
+		last[3] != cellGrid_emptyStyle
+	) {
+		memcpy(out, "\x1b[0m", 4);
+		out += 4;
+	}
+
+	return (int) (out - start);
+}
@@ -3,25 +3,77 @@
 #if defined(__APPLE__) || defined(__linux__)
 
 #include "cutils.h"
+#include "mosaic-internal.h"
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include <sys/select.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+
 typedef struct stdinReaderImpl {
 	int stdinFd;
-	int pipe[2];
-	fd_set fds;
-	int nfds;
+	// Index 0 is read and index 1 is written to interrupt. On Linux both are the same eventfd whose
+	// counter coalesces interrupts. Elsewhere they are the ends of a pipe. Either way they are
+	// non-blocking and drained when an interrupt is observed.
+	int interrupt[2];
+#if defined(__linux__)
+	// An epoll instance with stdinFd, interrupt[0], and timerFd registered, or -1 if epoll cannot be
+	// used with stdinFd (e.g., it is a regular file or /dev/null) in which case 'fds' is used with
+	// poll.
+	int epollFd;
+	// A monotonic timer armed with the deadline of each timed wait, or -1 when epoll is not used.
+	// Setting it discards any earlier expiration, but a timer from a wait which ended early can
+	// still expire during a later untimed wait.
+	int timerFd;
+	// When non-NULL, reads are performed with io_uring instead of epoll. A read of 'uringBuffer' is
+	// kept in flight on stdinFd so that each call needs at most one system call, which both posts
+	// the next read and waits for it.
+	uring *uring;
+	char *uringBuffer;
+	// Bytes which were read into 'uringBuffer' but did not fit in the caller's buffer.
+	int uringOffset;
+	int uringCount;
+	// The request which is in flight for stdinFd, or 0.
+	uint64_t uringStdinRequest;
+	int uringInterruptPolled;
+	int uringInterruptPending;
+#endif
+	// Index 0 is stdinFd and index 1 is interrupt[0]. Populated once since poll does not modify
+	// 'events'.
+	struct pollfd fds[2];
 } stdinReaderImpl;
 
+#if defined(__linux__)
+// Larger than any single burst of terminal input.
+#define uringBufferSize 16384
+
+#define uringStdinRead 1
+#define uringStdinPoll 2
+#define uringInterruptPoll 3
+#define uringStdinCancel 4
+#endif
+
 typedef struct stdinWriterImpl {
 	int pipe[2];
 	stdinReader *reader;
 } stdinWriterImpl;
 
+#if !defined(__linux__)
+static int setNonBlocking(int fd) {
+	int flags = fcntl(fd, F_GETFL);
+	return flags == -1 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+#endif
+
 stdinReaderResult stdinReader_initWithFd(int stdinFd) {
 	stdinReaderResult result = {};
 
@@ -31,21 +83,105 @@ stdinReaderResult stdinReader_initWithFd(int stdinFd) {
 		goto ret;
 	}
 
-	if (unlikely(pipe(reader->pipe)) != 0) {
+#if defined(__linux__)
+	reader->timerFd = -1;
+	int interruptFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (unlikely(interruptFd == -1)) {
 		result.error = errno;
 		goto err;
 	}
+	reader->interrupt[0] = interruptFd;
+	reader->interrupt[1] = interruptFd;
+#else
+	if (unlikely(pipe(reader->interrupt) != 0)) {
+		result.error = errno;
+		goto err;
+	}
+	if (unlikely(setNonBlocking(reader->interrupt[0]) != 0)
+		|| unlikely(setNonBlocking(reader->interrupt[1]) != 0)) {
+		result.error = errno;
+		goto errInterrupt;
+	}
+#endif
 
 	reader->stdinFd = stdinFd;
-	// TODO Consider forcing the writer pipe to always be lower than this pipe.
-	//  If we did this, we could always assume pipe[0] + 1 is the value for nfds.
-	reader->nfds = (stdinFd > reader->pipe[0]) ? stdinFd : reader->pipe[0];
+	reader->fds[0].fd = stdinFd;
+	reader->fds[0].events = POLLIN;
+	reader->fds[1].fd = reader->interrupt[0];
+	reader->fds[1].events = POLLIN;
+
+#if defined(__linux__)
+	reader->uring = uring_init(4);
+	if (reader->uring != NULL) {
+		reader->uringBuffer = malloc(uringBufferSize);
+		if (likely(reader->uringBuffer != NULL)) {
+			// Reads do not use epoll.
+			reader->epollFd = -1;
+			goto done;
+		}
+		uring_free(reader->uring);
+		reader->uring = NULL;
+	}
+
+	reader->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (unlikely(reader->epollFd == -1)) {
+		result.error = errno;
+		goto errInterrupt;
+	}
+
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = reader->interrupt[0];
+	if (unlikely(epoll_ctl(reader->epollFd, EPOLL_CTL_ADD, reader->interrupt[0], &event) != 0)) {
+		result.error = errno;
+		goto errEpoll;
+	}
+	event.data.fd = stdinFd;
+	if (unlikely(epoll_ctl(reader->epollFd, EPOLL_CTL_ADD, stdinFd, &event) != 0)) {
+		if (errno != EPERM) {
+			result.error = errno;
+			goto errEpoll;
+		}
+		// Files which do not support polling cannot be added to an epoll instance. Fall back to
+		// poll which reports them as always readable.
+		close(reader->epollFd);
+		reader->epollFd = -1;
+	} else {
+		reader->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+		if (unlikely(reader->timerFd == -1)) {
+			result.error = errno;
+			goto errEpoll;
+		}
+		event.data.fd = reader->timerFd;
+		if (unlikely(epoll_ctl(reader->epollFd, EPOLL_CTL_ADD, reader->timerFd, &event) != 0)) {
+			result.error = errno;
+			goto errTimer;
+		}
+	}
+
+	done:
+#endif
 
 	result.reader = reader;
 
 	ret:
 	return result;
 
+#if defined(__linux__)
+	errTimer:
+	close(reader->timerFd);
+
+	errEpoll:
+	close(reader->epollFd);
+
+	errInterrupt:
+	close(reader->interrupt[0]);
+#else
+	errInterrupt:
+	close(reader->interrupt[0]);
+	close(reader->interrupt[1]);
+#endif
+
 	err:
 	free(reader);
 	goto ret;
@@ -55,36 +191,319 @@ stdinReaderResult stdinReader_init() {
 	return stdinReader_initWithFd(STDIN_FILENO);
 }
 
-stdinRead stdinReader_readInternal(
+#define stdinReady 1
+#define interruptReady 2
+
+#define nanosPerSecond 1000000000
+
+static int64_t nowNanos() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t) now.tv_sec * nanosPerSecond + now.tv_nsec;
+}
+
+#if defined(__linux__)
+static struct timespec toTimespec(int64_t nanos) {
+	struct timespec timespec;
+	timespec.tv_sec = nanos / nanosPerSecond;
+	timespec.tv_nsec = nanos % nanosPerSecond;
+	return timespec;
+}
+#endif
+
+/**
+ * Wait up to 'timeoutNanos' for 'stdinFd' or the interrupt to become readable. A negative value
+ * waits indefinitely. Returns a combination of 'stdinReady' and 'interruptReady', 0 on timeout,
+ * or -1 on error.
+ *
+ * The timeout is converted to a deadline on the monotonic clock so that waits which are restarted
+ * after a signal (e.g., SIGWINCH) do not wait any longer in total.
+ */
+static int stdinReader_wait(stdinReader *reader, int64_t timeoutNanos) {
+	int64_t deadline = -1;
+	if (timeoutNanos > 0) {
+		int64_t now = nowNanos();
+		// A deadline beyond the range of the clock is the same as waiting indefinitely.
+		if (timeoutNanos <= INT64_MAX - now) {
+			deadline = now + timeoutNanos;
+		} else {
+			timeoutNanos = -1;
+		}
+	}
+
+	int ready = 0;
+#if defined(__linux__)
+	if (likely(reader->epollFd != -1)) {
+		if (deadline != -1) {
+			struct itimerspec spec = {};
+			spec.it_value = toTimespec(deadline);
+			if (unlikely(timerfd_settime(reader->timerFd, TFD_TIMER_ABSTIME, &spec, NULL) != 0)) {
+				return -1;
+			}
+		}
+		int epollTimeout = timeoutNanos == 0 ? 0 : -1;
+		while (1) {
+			struct epoll_event events[3];
+			int count = epoll_wait(reader->epollFd, events, 3, epollTimeout);
+			if (unlikely(count == -1)) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return -1;
+			}
+			int timedOut = timeoutNanos == 0;
+			for (int i = 0; i < count; i++) {
+				int fd = events[i].data.fd;
+				// Any event (including EPOLLHUP and EPOLLERR) means a read will not block.
+				if (fd == reader->stdinFd) {
+					ready |= stdinReady;
+				} else if (fd == reader->timerFd) {
+					uint64_t expirations;
+					while (unlikely(read(fd, &expirations, sizeof(expirations)) == -1) && errno == EINTR) {
+						// Retry.
+					}
+					// The timer may have been armed by an earlier wait which ended before it expired.
+					timedOut = deadline != -1 && nowNanos() >= deadline;
+				} else {
+					ready |= interruptReady;
+				}
+			}
+			if (ready != 0 || timedOut) {
+				return ready;
+			}
+		}
+	}
+#endif
+
+	while (1) {
+		int timeoutMillis = -1;
+		if (timeoutNanos == 0) {
+			timeoutMillis = 0;
+		} else if (deadline != -1) {
+			int64_t remainingNanos = deadline - nowNanos();
+			// Round up so that the deadline has passed if poll times out. Longer waits take more than
+			// one call.
+			int64_t remainingMillis = remainingNanos > 0 ? (remainingNanos + 999999) / 1000000 : 0;
+			timeoutMillis = remainingMillis > INT32_MAX ? INT32_MAX : (int) remainingMillis;
+		}
+		int result = poll(reader->fds, 2, timeoutMillis);
+		if (unlikely(result == -1)) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+
+		// Any event (including POLLHUP and POLLERR) means a read will not block.
+		if (reader->fds[0].revents != 0) {
+			ready |= stdinReady;
+		}
+		if (reader->fds[1].revents != 0) {
+			ready |= interruptReady;
+		}
+		if (ready != 0 || timeoutNanos == 0 || (deadline != -1 && nowNanos() >= deadline)) {
+			return ready;
+		}
+	}
+}
+
+/** Consume all pending interrupts so that the next wait blocks again. */
+static void stdinReader_drainInterrupt(stdinReader *reader) {
+#if defined(__linux__)
+	// Reading an eventfd returns its counter and resets it to zero.
+	uint64_t count;
+	while (unlikely(read(reader->interrupt[0], &count, sizeof(count)) == -1) && errno == EINTR) {
+		// Retry.
+	}
+#else
+	char buffer[16];
+	while (read(reader->interrupt[0], buffer, sizeof(buffer)) > 0) {
+		// Keep reading until EAGAIN.
+	}
+#endif
+}
+
+#if defined(__linux__)
+static int stdinReader_takeUringBytes(stdinReader *reader, void *buffer, int count) {
+	if (count > reader->uringCount) {
+		count = reader->uringCount;
+	}
+	memcpy(buffer, reader->uringBuffer + reader->uringOffset, count);
+	reader->uringOffset += count;
+	reader->uringCount -= count;
+	return count;
+}
+
+/**
+ * Reap completions and post the requests which are missing, then submit them and wait (if needed)
+ * with a single call to io_uring_enter.
+ */
+static stdinRead stdinReader_readUring(
 	stdinReader *reader,
 	void *buffer,
 	int count,
-	struct timeval *timeout
+	int64_t timeoutNanos
 ) {
-	int stdinFd = reader->stdinFd;
-	FD_SET(stdinFd, &reader->fds);
+	stdinRead result = {};
 
-	int pipeIn = reader->pipe[0];
-	FD_SET(pipeIn, &reader->fds);
+	// Data is preferred over a pending interrupt, which the next call will observe.
+	if (reader->uringCount > 0) {
+		result.count = stdinReader_takeUringBytes(reader, buffer, count);
+		goto ret;
+	}
 
-	stdinRead result = {};
+	int64_t deadline = -1;
+	if (timeoutNanos > 0) {
+		int64_t now = nowNanos();
+		if (timeoutNanos <= INT64_MAX - now) {
+			deadline = now + timeoutNanos;
+		} else {
+			timeoutNanos = -1;
+		}
+	}
 
-	// TODO Consider setting up fd_set once in the struct and doing a stack copy here.
-	if (likely(select(reader->nfds, &reader->fds, NULL, NULL, timeout) >= 0)) {
-		if (likely(FD_ISSET(stdinFd, &reader->fds) != 0)) {
-			int c = read(stdinFd, buffer, count);
-			if (likely(c > 0)) {
-				result.count = c;
-			} else if (c == 0) {
+	int entered = 0;
+	while (1) {
+		uint64_t request;
+		int res;
+		while (uring_peek(reader->uring, &request, &res)) {
+			if (request == uringInterruptPoll) {
+				// A cancelled poll is posted again rather than reported.
+				reader->uringInterruptPolled = 0;
+				reader->uringInterruptPending |= res > 0;
+				continue;
+			}
+
+			reader->uringStdinRequest = 0;
+			if (request == uringStdinPoll || res == -EINTR || res == -ECANCELED) {
+				// Stdin is readable, or the read was cancelled (e.g., the thread which submitted it
+				// exited). Either way, read again.
+			} else if (res == -EAGAIN) {
+				// Someone put stdin into non-blocking mode. Wait for it to be readable first.
+				if (likely(uring_prepPoll(reader->uring, reader->stdinFd, POLLIN, uringStdinPoll) == 0)) {
+					reader->uringStdinRequest = uringStdinPoll;
+				}
+			} else if (likely(res > 0)) {
+				reader->uringOffset = 0;
+				reader->uringCount = res;
+			} else if (res == 0) {
 				result.count = -1; // EOF
+				goto ret;
 			} else {
-				goto err;
+				result.error = -res;
+				goto ret;
 			}
 		}
-		// Otherwise if the interrupt pipe was selected or we timed out, return a count of 0.
-	} else {
+
+		if (reader->uringCount > 0) {
+			result.count = stdinReader_takeUringBytes(reader, buffer, count);
+			goto ret;
+		}
+		if (reader->uringInterruptPending) {
+			reader->uringInterruptPending = 0;
+			stdinReader_drainInterrupt(reader);
+			result.interrupted = 1;
+			goto ret;
+		}
+
+		int64_t remaining = timeoutNanos;
+		if (deadline != -1) {
+			remaining = deadline - nowNanos();
+			if (remaining < 0) {
+				remaining = 0;
+			}
+		}
+		if (entered && remaining == 0) {
+			goto ret; // Timed out.
+		}
+
+		// The submission queue has room for both requests since at most one of each is in flight.
+		if (reader->uringStdinRequest == 0) {
+			uring_prepRead(reader->uring, reader->stdinFd, reader->uringBuffer, uringBufferSize, uringStdinRead);
+			reader->uringStdinRequest = uringStdinRead;
+		}
+		if (!reader->uringInterruptPolled) {
+			uring_prepPoll(reader->uring, reader->interrupt[0], POLLIN, uringInterruptPoll);
+			reader->uringInterruptPolled = 1;
+		}
+
+		platformError error = uring_enter(reader->uring, remaining == 0 ? 0 : 1, remaining);
+		if (unlikely(error != 0 && error != ETIME && error != EINTR)) {
+			result.error = error;
+			goto ret;
+		}
+		entered = 1;
+	}
+
+	ret:
+	return result;
+}
+
+/**
+ * Cancel the read of 'uringBuffer' which is in flight and wait for it to complete so that the
+ * kernel no longer writes into the buffer. Returns 0 if the read is still in flight, in which case
+ * the buffer must not be freed.
+ */
+static int stdinReader_cancelUringRead(stdinReader *reader) {
+	if (unlikely(uring_prepCancel(reader->uring, uringStdinRead, uringStdinCancel) != 0)) {
+		return 0;
+	}
+	int readCompleted = 0;
+	int cancelCompleted = 0;
+	while (!readCompleted || !cancelCompleted) {
+		// A read which cannot be cancelled (e.g., it is blocked in a kernel worker) is given a
+		// bounded time to finish rather than blocking close indefinitely.
+		platformError error = uring_enter(reader->uring, 1, 1000000000);
+		if (unlikely(error != 0 && error != EINTR)) {
+			break;
+		}
+		uint64_t request;
+		int res;
+		while (uring_peek(reader->uring, &request, &res)) {
+			if (request == uringStdinRead) {
+				readCompleted = 1;
+			} else if (request == uringStdinCancel) {
+				cancelCompleted = 1;
+			}
+		}
+	}
+	return readCompleted;
+}
+#endif
+
+stdinRead stdinReader_readInternal(
+	stdinReader *reader,
+	void *buffer,
+	int count,
+	int64_t timeoutNanos
+) {
+#if defined(__linux__)
+	if (reader->uring != NULL) {
+		return stdinReader_readUring(reader, buffer, count, timeoutNanos);
+	}
+#endif
+
+	stdinRead result = {};
+
+	int ready = stdinReader_wait(reader, timeoutNanos);
+	if (unlikely(ready < 0)) {
 		goto err;
 	}
+	if (likely(ready & stdinReady)) {
+		// Prefer data. A pending interrupt is left for the next call to observe.
+		int c = read(reader->stdinFd, buffer, count);
+		if (likely(c > 0)) {
+			result.count = c;
+		} else if (c == 0) {
+			result.count = -1; // EOF
+		} else {
+			goto err;
+		}
+	} else if (ready & interruptReady) {
+		stdinReader_drainInterrupt(reader);
+		result.interrupted = 1;
+	}
+	// Otherwise we timed out and return a count of 0.
 
 	ret:
 	return result;
@@ -95,7 +514,7 @@ stdinRead stdinReader_readInternal(
 }
 
 stdinRead stdinReader_read(stdinReader *reader, void *buffer, int count) {
-	return stdinReader_readInternal(reader, buffer, count, NULL);
+	return stdinReader_readInternal(reader, buffer, count, -1);
 }
 
 stdinRead stdinReader_readWithTimeout(
@@ -104,31 +523,71 @@ stdinRead stdinReader_readWithTimeout(
 	int count,
 	int timeoutMillis
 ) {
-	struct timeval timeout;
-	timeout.tv_sec = 0;
-	timeout.tv_usec = timeoutMillis * 1000;
+	int64_t timeoutNanos = timeoutMillis < 0 ? -1 : (int64_t) timeoutMillis * 1000000;
+	return stdinReader_readInternal(reader, buffer, count, timeoutNanos);
+}
 
-	return stdinReader_readInternal(reader, buffer, count, &timeout);
+stdinRead stdinReader_readWithTimeoutNanos(
+	stdinReader *reader,
+	void *buffer,
+	int count,
+	int64_t timeoutNanos
+) {
+	return stdinReader_readInternal(reader, buffer, count, timeoutNanos);
 }
 
 platformError stdinReader_interrupt(stdinReader *reader) {
-	int pipeOut = reader->pipe[1];
-	int result = write(pipeOut, " ", 1);
-	return unlikely(result == -1)
+#if defined(__linux__)
+	uint64_t increment = 1;
+	int result = write(reader->interrupt[1], &increment, sizeof(increment));
+#else
+	int result = write(reader->interrupt[1], " ", 1);
+#endif
+	// The pipe is non-blocking. If it is full an interrupt is already pending so failure is fine.
+	return unlikely(result == -1 && errno != EAGAIN)
 		? errno
 		: 0;
 }
 
-platformError stdinReader_free(stdinReader *reader) {
-	int *pipe = reader->pipe;
+platformError stdinReader_fds(stdinReader *reader, int *stdinFd, int *interruptFd) {
+#if defined(__linux__)
+	if (reader->uring != NULL) {
+		// Stdin is read ahead of the caller so its readability does not indicate pending data.
+		return ENOTSUP;
+	}
+#endif
+	*stdinFd = reader->stdinFd;
+	*interruptFd = reader->interrupt[0];
+	return 0;
+}
 
+platformError stdinReader_free(stdinReader *reader) {
 	int result = 0;
-	if (unlikely(close(pipe[0]) != 0)) {
+	if (unlikely(close(reader->interrupt[0]) != 0)) {
 		result = errno;
 	}
-	if (unlikely(close(pipe[1]) != 0 && result != 0)) {
+#if !defined(__linux__)
+	if (unlikely(close(reader->interrupt[1]) != 0 && result == 0)) {
+		result = errno;
+	}
+#endif
+#if defined(__linux__)
+	if (reader->uring != NULL) {
+		// Closing the ring cancels the read asynchronously, so it could otherwise still write into
+		// the buffer after it is freed. Any bytes read ahead of the caller are discarded.
+		int bufferFree = reader->uringStdinRequest != uringStdinRead || stdinReader_cancelUringRead(reader);
+		uring_free(reader->uring);
+		if (likely(bufferFree)) {
+			free(reader->uringBuffer);
+		}
+	}
+	if (reader->timerFd != -1 && unlikely(close(reader->timerFd) != 0 && result == 0)) {
 		result = errno;
 	}
+	if (reader->epollFd != -1 && unlikely(close(reader->epollFd) != 0 && result == 0)) {
+		result = errno;
+	}
+#endif
 	free(reader);
 	return result;
 }
@@ -183,6 +642,10 @@ platformError stdinWriter_write(stdinWriter *writer, void *buffer, int count) {
 	return errno;
 }
 
+eventLoopResult stdinWriter_eventLoop(stdinWriter *writer) {
+	return eventLoop_initWithFd(writer->pipe[0], 0);
+}
+
 platformError stdinWriter_free(stdinWriter *writer) {
 	int *pipe = writer->pipe;
 
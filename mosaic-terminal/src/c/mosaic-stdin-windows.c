@@ -66,17 +66,20 @@ stdinRead stdinReader_readWithTimeout(
 	stdinRead result = {};
 	DWORD waitResult = WaitForMultipleObjects(2, reader->handles, FALSE, timeoutMillis);
 	if (likely(waitResult == WAIT_OBJECT_0)) {
-		LPDWORD read = 0;
-		if (likely(ReadConsole(reader->handles[0], buffer, count, read, NULL) != 0)) {
+		DWORD read = 0;
+		if (likely(ReadConsole(reader->handles[0], buffer, count, &read, NULL) != 0)) {
 			// TODO EOF?
-			result.count = (*read);
+			result.count = read;
 		} else {
 			goto err;
 		}
+	} else if (waitResult == WAIT_OBJECT_0 + 1) {
+		// The auto-reset event was reset by this wait, which coalesces and drains interrupts.
+		result.interrupted = 1;
 	} else if (unlikely(waitResult == WAIT_FAILED)) {
 		goto err;
 	}
-	// Else if the interrupt event was selected or we timed out, return a count of 0.
+	// Else if we timed out, return a count of 0.
 
 	ret:
 	return result;
@@ -86,6 +89,28 @@ stdinRead stdinReader_readWithTimeout(
 	goto ret;
 }
 
+stdinRead stdinReader_readWithTimeoutNanos(
+	stdinReader *reader,
+	void *buffer,
+	int count,
+	int64_t timeoutNanos
+) {
+	DWORD timeoutMillis = INFINITE;
+	if (timeoutNanos >= 0) {
+		// Round up so that the wait is never shorter than requested. Waits too long to represent
+		// are the same as waiting indefinitely.
+		int64_t millis = timeoutNanos / 1000000 + (timeoutNanos % 1000000 != 0);
+		if (millis < INFINITE) {
+			timeoutMillis = (DWORD) millis;
+		}
+	}
+	return stdinReader_readWithTimeout(reader, buffer, count, timeoutMillis);
+}
+
+platformError stdinReader_fds(stdinReader *reader, int *stdinFd, int *interruptFd) {
+	return ERROR_NOT_SUPPORTED;
+}
+
 platformError stdinReader_interrupt(stdinReader *reader) {
 	return likely(SetEvent(reader->handles[1]) != 0)
 		? 0
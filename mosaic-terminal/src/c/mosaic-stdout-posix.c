@@ -0,0 +1,197 @@
+#include "mosaic.h"
+
+#if defined(__APPLE__) || defined(__linux__)
+
+#include "cutils.h"
+#include "mosaic-internal.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct stdoutWriterImpl {
+	int stdoutFd;
+	char *buffer;
+	int capacity;
+#if defined(__linux__)
+	// When non-NULL, writes are submitted with io_uring and complete asynchronously. Each write is
+	// copied to 'uringBuffer' so that the caller can reuse 'buffer' (whose address the JVM caches)
+	// while it is in flight. Only one write is in flight at a time to preserve their order.
+	uring *uring;
+	char *uringBuffer;
+	int uringCapacity;
+	// The bytes of the in-flight write which remain to be written, or a count of 0 if there is none.
+	int uringOffset;
+	int uringCount;
+#endif
+} stdoutWriterImpl;
+
+#if defined(__linux__)
+#define uringWrite 1
+#define uringPoll 2
+#endif
+
+stdoutWriterResult stdoutWriter_initWithFd(int stdoutFd) {
+	stdoutWriterResult result = {};
+
+	stdoutWriterImpl *writer = calloc(1, sizeof(stdoutWriterImpl));
+	if (unlikely(writer == NULL)) {
+		// result.writer is set to 0 which will trigger OOM.
+		goto ret;
+	}
+
+	writer->stdoutFd = stdoutFd;
+#if defined(__linux__)
+	writer->uring = uring_init(2);
+#endif
+
+	result.writer = writer;
+
+	ret:
+	return result;
+}
+
+stdoutWriterResult stdoutWriter_init() {
+	return stdoutWriter_initWithFd(STDOUT_FILENO);
+}
+
+char *stdoutWriter_buffer(stdoutWriter *writer, int capacity) {
+	if (unlikely(capacity > writer->capacity)) {
+		// Contents are not preserved so avoid the copy which realloc might perform.
+		free(writer->buffer);
+		writer->buffer = malloc(capacity);
+		writer->capacity = likely(writer->buffer != NULL) ? capacity : 0;
+	}
+	return writer->buffer;
+}
+
+#if defined(__linux__)
+/** Wait for the in-flight write, if any, to complete in its entirety. */
+static platformError stdoutWriter_awaitUring(stdoutWriter *writer) {
+	while (writer->uringCount > 0) {
+		uint64_t request;
+		int res;
+		if (!uring_peek(writer->uring, &request, &res)) {
+			platformError error = uring_enter(writer->uring, 1, -1);
+			if (unlikely(error != 0 && error != EINTR)) {
+				writer->uringCount = 0;
+				return error;
+			}
+			continue;
+		}
+
+		if (unlikely(request == uringWrite && res == 0)) {
+			// No progress was made and retrying would loop forever.
+			writer->uringCount = 0;
+			return EIO;
+		} else if (likely(request == uringWrite && res > 0)) {
+			writer->uringOffset += res;
+			writer->uringCount -= res;
+			if (likely(writer->uringCount == 0)) {
+				break;
+			}
+			// Write the remainder.
+		} else if (request == uringWrite && res == -EAGAIN) {
+			// Someone else put stdout into non-blocking mode. Wait until it can accept more bytes.
+			uring_prepPoll(writer->uring, writer->stdoutFd, POLLOUT, uringPoll);
+			continue;
+		} else if (unlikely(request == uringWrite && res != -EINTR && res != -ECANCELED)) {
+			writer->uringCount = 0;
+			return -res;
+		}
+		// Otherwise stdout is writable or the write was cancelled. Either way, write again.
+		uring_prepWrite(
+			writer->uring,
+			writer->stdoutFd,
+			writer->uringBuffer + writer->uringOffset,
+			writer->uringCount,
+			uringWrite
+		);
+	}
+	return 0;
+}
+
+static platformError stdoutWriter_writeUring(stdoutWriter *writer, int count) {
+	// Errors from the previous write are reported by this one since that call already returned.
+	platformError error = stdoutWriter_awaitUring(writer);
+	if (unlikely(error != 0)) {
+		return error;
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	if (unlikely(count > writer->uringCapacity)) {
+		free(writer->uringBuffer);
+		writer->uringBuffer = malloc(count);
+		if (unlikely(writer->uringBuffer == NULL)) {
+			writer->uringCapacity = 0;
+			return ENOMEM;
+		}
+		writer->uringCapacity = count;
+	}
+	memcpy(writer->uringBuffer, writer->buffer, count);
+	writer->uringOffset = 0;
+	writer->uringCount = count;
+	uring_prepWrite(writer->uring, writer->stdoutFd, writer->uringBuffer, count, uringWrite);
+
+	// Submit without waiting. Writes which complete immediately are reaped by the next call.
+	error = uring_enter(writer->uring, 0, 0);
+	if (unlikely(error != 0 && error != EINTR)) {
+		writer->uringCount = 0;
+		return error;
+	}
+	return 0;
+}
+#endif
+
+platformError stdoutWriter_write(stdoutWriter *writer, int count) {
+#if defined(__linux__)
+	if (writer->uring != NULL) {
+		return stdoutWriter_writeUring(writer, count);
+	}
+#endif
+
+	int stdoutFd = writer->stdoutFd;
+	char *buffer = writer->buffer;
+	while (count > 0) {
+		int result = write(stdoutFd, buffer, count);
+		if (likely(result > 0)) {
+			buffer += result;
+			count -= result;
+		} else if (unlikely(result == 0)) {
+			// No progress was made and retrying would loop forever.
+			return EIO;
+		} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			// Someone else put stdout into non-blocking mode. Wait until it can accept more bytes.
+			struct pollfd fd = { .fd = stdoutFd, .events = POLLOUT };
+			if (unlikely(poll(&fd, 1, -1) == -1 && errno != EINTR)) {
+				goto err;
+			}
+		} else if (errno != EINTR) {
+			goto err;
+		}
+	}
+	return 0;
+
+	err:
+	return errno;
+}
+
+platformError stdoutWriter_free(stdoutWriter *writer) {
+	platformError result = 0;
+#if defined(__linux__)
+	if (writer->uring != NULL) {
+		// Flush the in-flight write before the ring is closed, which would cancel it.
+		result = stdoutWriter_awaitUring(writer);
+		uring_free(writer->uring);
+		free(writer->uringBuffer);
+	}
+#endif
+	free(writer->buffer);
+	free(writer);
+	return result;
+}
+
+#endif
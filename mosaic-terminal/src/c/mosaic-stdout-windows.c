@@ -0,0 +1,106 @@
+#include "mosaic.h"
+
+#if defined(WIN32)
+
+#include "cutils.h"
+#include <Windows.h>
+#include <stdlib.h>
+
+typedef struct stdoutWriterImpl {
+	HANDLE stdout;
+	BOOL restoreConsole;
+	DWORD savedMode;
+	UINT savedCodePage;
+	char *buffer;
+	int capacity;
+} stdoutWriterImpl;
+
+stdoutWriterResult stdoutWriter_init() {
+	stdoutWriterResult result = {};
+
+	stdoutWriterImpl *writer = calloc(1, sizeof(stdoutWriterImpl));
+	if (unlikely(writer == NULL)) {
+		// result.writer is set to 0 which will trigger OOM.
+		goto ret;
+	}
+
+	HANDLE stdout = GetStdHandle(STD_OUTPUT_HANDLE);
+	if (unlikely(stdout == INVALID_HANDLE_VALUE)) {
+		result.error = GetLastError();
+		goto err;
+	}
+	writer->stdout = stdout;
+
+	// Control sequences and UTF-8 are only understood by a console with these settings. When output
+	// is redirected there is no console mode and the bytes are written as-is.
+	if (GetConsoleMode(stdout, &writer->savedMode) != 0) {
+		if (unlikely((writer->savedCodePage = GetConsoleOutputCP()) == 0)) {
+			result.error = GetLastError();
+			goto err;
+		}
+		if (unlikely(SetConsoleMode(stdout, writer->savedMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) == 0)) {
+			result.error = GetLastError();
+			goto err;
+		}
+		if (unlikely(SetConsoleOutputCP(65001 /* UTF-8 */) == 0)) {
+			result.error = GetLastError();
+			SetConsoleMode(stdout, writer->savedMode);
+			goto err;
+		}
+		writer->restoreConsole = TRUE;
+	}
+
+	result.writer = writer;
+
+	ret:
+	return result;
+
+	err:
+	free(writer);
+	goto ret;
+}
+
+char *stdoutWriter_buffer(stdoutWriter *writer, int capacity) {
+	if (unlikely(capacity > writer->capacity)) {
+		// Contents are not preserved so avoid the copy which realloc might perform.
+		free(writer->buffer);
+		writer->buffer = malloc(capacity);
+		writer->capacity = likely(writer->buffer != NULL) ? capacity : 0;
+	}
+	return writer->buffer;
+}
+
+platformError stdoutWriter_write(stdoutWriter *writer, int count) {
+	char *buffer = writer->buffer;
+	while (count > 0) {
+		DWORD written;
+		if (unlikely(WriteFile(writer->stdout, buffer, count, &written, NULL) == 0)) {
+			return GetLastError();
+		}
+		if (unlikely(written == 0)) {
+			// No progress was made and retrying would loop forever.
+			return ERROR_WRITE_FAULT;
+		}
+		buffer += written;
+		count -= written;
+	}
+	return 0;
+}
+
+platformError stdoutWriter_free(stdoutWriter *writer) {
+	platformError result = 0;
+	if (writer->restoreConsole) {
+		// Try to restore both properties even if one fails.
+		if (unlikely(SetConsoleMode(writer->stdout, writer->savedMode) == 0)) {
+			result = GetLastError();
+		}
+		if (unlikely(SetConsoleOutputCP(writer->savedCodePage) == 0 && result == 0)) {
+			result = GetLastError();
+		}
+	}
+	free(writer->buffer);
+	free(writer);
+	return result;
+}
+
+#endif
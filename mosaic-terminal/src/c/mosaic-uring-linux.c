@@ -0,0 +1,349 @@
+#include "mosaic.h"
+
+#if defined(__linux__)
+
+#include "cutils.h"
+#include "mosaic-internal.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// The toolchains used for some targets ship kernel headers which predate io_uring, so the parts of
+// its ABI which are used are declared here rather than including <linux/io_uring.h>. These system
+// call numbers are shared by every architecture.
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+#define IORING_OFF_SQ_RING 0ULL
+#define IORING_OFF_SQES 0x10000000ULL
+
+#define IORING_FEAT_SINGLE_MMAP (1U << 0)
+#define IORING_FEAT_NODROP (1U << 1)
+#define IORING_FEAT_RW_CUR_POS (1U << 3)
+#define IORING_FEAT_EXT_ARG (1U << 8)
+#define requiredFeatures (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS | IORING_FEAT_EXT_ARG)
+
+#define IORING_ENTER_GETEVENTS (1U << 0)
+#define IORING_ENTER_EXT_ARG (1U << 3)
+
+#define IORING_REGISTER_PROBE 8
+#define IO_URING_OP_SUPPORTED (1U << 0)
+
+#define IORING_OP_POLL_ADD 6
+#define IORING_OP_ASYNC_CANCEL 14
+#define IORING_OP_READ 22
+#define IORING_OP_WRITE 23
+
+typedef struct uringSqe {
+	uint8_t opcode;
+	uint8_t flags;
+	uint16_t ioprio;
+	int32_t fd;
+	uint64_t off;
+	uint64_t addr;
+	uint32_t len;
+	// Named 'rw_flags' or 'poll32_events' depending on the opcode.
+	uint32_t opFlags;
+	uint64_t userData;
+	uint64_t unused[3];
+} uringSqe;
+
+typedef struct uringCqe {
+	uint64_t userData;
+	int32_t res;
+	uint32_t flags;
+} uringCqe;
+
+typedef struct uringParams {
+	uint32_t sqEntries;
+	uint32_t cqEntries;
+	uint32_t flags;
+	uint32_t sqThreadCpu;
+	uint32_t sqThreadIdle;
+	uint32_t features;
+	uint32_t wqFd;
+	uint32_t resv[3];
+	struct {
+		uint32_t head;
+		uint32_t tail;
+		uint32_t ringMask;
+		uint32_t ringEntries;
+		uint32_t flags;
+		uint32_t dropped;
+		uint32_t array;
+		uint32_t resv1;
+		uint64_t userAddr;
+	} sqOff;
+	struct {
+		uint32_t head;
+		uint32_t tail;
+		uint32_t ringMask;
+		uint32_t ringEntries;
+		uint32_t overflow;
+		uint32_t cqes;
+		uint32_t flags;
+		uint32_t resv1;
+		uint64_t userAddr;
+	} cqOff;
+} uringParams;
+
+typedef struct uringGeteventsArg {
+	uint64_t sigmask;
+	uint32_t sigmaskSize;
+	uint32_t pad;
+	uint64_t ts;
+} uringGeteventsArg;
+
+typedef struct uringProbe {
+	uint8_t lastOp;
+	uint8_t opsLength;
+	uint16_t resv;
+	uint32_t resv2[3];
+	struct {
+		uint8_t op;
+		uint8_t resv;
+		uint16_t flags;
+		uint32_t resv2;
+	} ops[32];
+} uringProbe;
+
+typedef struct uringImpl {
+	int ringFd;
+	void *ring;
+	size_t ringSize;
+	uringSqe *sqes;
+	size_t sqesSize;
+
+	uint32_t *sqHead;
+	uint32_t *sqTail;
+	uint32_t sqMask;
+	uint32_t sqEntries;
+	uint32_t *sqArray;
+	// Entries up to this index have been prepared. The kernel's tail is only advanced on enter.
+	uint32_t sqLocalTail;
+
+	uint32_t *cqHead;
+	uint32_t *cqTail;
+	uint32_t cqMask;
+	uringCqe *cqes;
+} uringImpl;
+
+static int uring_supportsOps(int ringFd) {
+	uringProbe probe = {};
+	if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, &probe, 32) != 0) {
+		return 0;
+	}
+	static const uint8_t requiredOps[] = {
+		IORING_OP_POLL_ADD,
+		IORING_OP_ASYNC_CANCEL,
+		IORING_OP_READ,
+		IORING_OP_WRITE,
+	};
+	for (size_t i = 0; i < sizeof(requiredOps); i++) {
+		uint8_t op = requiredOps[i];
+		if (op > probe.lastOp || op >= probe.opsLength || !(probe.ops[op].flags & IO_URING_OP_SUPPORTED)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+uring *uring_init(unsigned entries) {
+	const char *enabled = getenv("MOSAIC_IO_URING");
+	if (enabled == NULL || strcmp(enabled, "1") != 0) {
+		return NULL;
+	}
+
+	uringImpl *ring = calloc(1, sizeof(uringImpl));
+	if (unlikely(ring == NULL)) {
+		goto ret;
+	}
+
+	uringParams params = {};
+	// Setup fails with ENOSYS on old kernels, and with EPERM when disabled by sysctl or seccomp.
+	ring->ringFd = syscall(__NR_io_uring_setup, entries, &params);
+	if (ring->ringFd < 0) {
+		goto err;
+	}
+	if ((params.features & requiredFeatures) != requiredFeatures || !uring_supportsOps(ring->ringFd)) {
+		goto errFd;
+	}
+
+	// With IORING_FEAT_SINGLE_MMAP both rings share one mapping which must fit the larger of them.
+	size_t sqSize = params.sqOff.array + params.sqEntries * sizeof(uint32_t);
+	size_t cqSize = params.cqOff.cqes + params.cqEntries * sizeof(uringCqe);
+	ring->ringSize = sqSize > cqSize ? sqSize : cqSize;
+	ring->ring = mmap(
+		NULL,
+		ring->ringSize,
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE,
+		ring->ringFd,
+		IORING_OFF_SQ_RING
+	);
+	if (unlikely(ring->ring == MAP_FAILED)) {
+		goto errFd;
+	}
+	ring->sqesSize = params.sqEntries * sizeof(uringSqe);
+	ring->sqes = mmap(
+		NULL,
+		ring->sqesSize,
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE,
+		ring->ringFd,
+		IORING_OFF_SQES
+	);
+	if (unlikely(ring->sqes == MAP_FAILED)) {
+		goto errRing;
+	}
+
+	char *base = ring->ring;
+	ring->sqHead = (uint32_t *) (base + params.sqOff.head);
+	ring->sqTail = (uint32_t *) (base + params.sqOff.tail);
+	ring->sqMask = *(uint32_t *) (base + params.sqOff.ringMask);
+	ring->sqEntries = *(uint32_t *) (base + params.sqOff.ringEntries);
+	ring->sqArray = (uint32_t *) (base + params.sqOff.array);
+	ring->sqLocalTail = *ring->sqTail;
+	ring->cqHead = (uint32_t *) (base + params.cqOff.head);
+	ring->cqTail = (uint32_t *) (base + params.cqOff.tail);
+	ring->cqMask = *(uint32_t *) (base + params.cqOff.ringMask);
+	ring->cqes = (uringCqe *) (base + params.cqOff.cqes);
+
+	ret:
+	return ring;
+
+	errRing:
+	munmap(ring->ring, ring->ringSize);
+
+	errFd:
+	close(ring->ringFd);
+
+	err:
+	free(ring);
+	ring = NULL;
+	goto ret;
+}
+
+static uringSqe *uring_nextSqe(uringImpl *ring) {
+	uint32_t head = __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+	if (unlikely(ring->sqLocalTail - head >= ring->sqEntries)) {
+		return NULL;
+	}
+	uint32_t index = ring->sqLocalTail & ring->sqMask;
+	uringSqe *sqe = &ring->sqes[index];
+	memset(sqe, 0, sizeof(uringSqe));
+	ring->sqArray[index] = index;
+	ring->sqLocalTail++;
+	return sqe;
+}
+
+static int uring_prepRw(uringImpl *ring, uint8_t opcode, int fd, void *buffer, unsigned count, uint64_t userData) {
+	uringSqe *sqe = uring_nextSqe(ring);
+	if (unlikely(sqe == NULL)) {
+		return -1;
+	}
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	// Use (and advance) the file position, which is required for pipes and terminals.
+	sqe->off = (uint64_t) -1;
+	sqe->addr = (uint64_t) (uintptr_t) buffer;
+	sqe->len = count;
+	sqe->userData = userData;
+	return 0;
+}
+
+int uring_prepRead(uring *ring, int fd, void *buffer, unsigned count, uint64_t userData) {
+	return uring_prepRw(ring, IORING_OP_READ, fd, buffer, count, userData);
+}
+
+int uring_prepWrite(uring *ring, int fd, const void *buffer, unsigned count, uint64_t userData) {
+	return uring_prepRw(ring, IORING_OP_WRITE, fd, (void *) buffer, count, userData);
+}
+
+int uring_prepPoll(uring *ring, int fd, unsigned pollEvents, uint64_t userData) {
+	uringSqe *sqe = uring_nextSqe(ring);
+	if (unlikely(sqe == NULL)) {
+		return -1;
+	}
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	// Only little-endian targets are supported, where the low half is also the legacy 16-bit field.
+	sqe->opFlags = pollEvents;
+	sqe->userData = userData;
+	return 0;
+}
+
+int uring_prepCancel(uring *ring, uint64_t targetUserData, uint64_t userData) {
+	uringSqe *sqe = uring_nextSqe(ring);
+	if (unlikely(sqe == NULL)) {
+		return -1;
+	}
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = targetUserData;
+	sqe->userData = userData;
+	return 0;
+}
+
+int uring_peek(uring *ring, uint64_t *userData, int *res) {
+	uint32_t head = *ring->cqHead;
+	if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+		return 0;
+	}
+	uringCqe *cqe = &ring->cqes[head & ring->cqMask];
+	*userData = cqe->userData;
+	*res = cqe->res;
+	__atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+platformError uring_enter(uring *ring, unsigned minComplete, int64_t timeoutNanos) {
+	// Publish prepared entries to the kernel.
+	__atomic_store_n(ring->sqTail, ring->sqLocalTail, __ATOMIC_RELEASE);
+	unsigned toSubmit = ring->sqLocalTail - __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE);
+
+	// Always ask for events so that pending completions are flushed to the queue, even when not
+	// waiting for any of them.
+	unsigned flags = IORING_ENTER_GETEVENTS;
+	struct timespec timeout;
+	uringGeteventsArg arg = {};
+	void *argPtr = NULL;
+	size_t argSize = 0;
+	if (minComplete > 0 && timeoutNanos >= 0) {
+		timeout.tv_sec = timeoutNanos / 1000000000;
+		timeout.tv_nsec = timeoutNanos % 1000000000;
+		arg.sigmaskSize = _NSIG / 8;
+		arg.ts = (uint64_t) (uintptr_t) &timeout;
+		flags |= IORING_ENTER_EXT_ARG;
+		argPtr = &arg;
+		argSize = sizeof(arg);
+	}
+
+	long result = syscall(__NR_io_uring_enter, ring->ringFd, toSubmit, minComplete, flags, argPtr, argSize);
+	// When entries were submitted the count is returned even if waiting was then interrupted or
+	// timed out. Callers check the completion queue and their deadline either way.
+	return likely(result >= 0) ? 0 : errno;
+}
+
+void uring_free(uring *ring) {
+	// Closing the ring cancels any requests which are still in flight.
+	munmap(ring->sqes, ring->sqesSize);
+	munmap(ring->ring, ring->ringSize);
+	close(ring->ringFd);
+	free(ring);
+}
+
+#endif
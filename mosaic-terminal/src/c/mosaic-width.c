@@ -0,0 +1,17 @@
+#include "mosaic.h"
+
+#include "cutils.h"
+#include "mosaic-width-table.h"
+
+int unicodeWidth_codePoint(uint32_t codePoint) {
+	if (likely(codePoint < 0x80)) {
+		return 1;
+	}
+	if (unlikely(codePoint >= 0x110000)) {
+		// Invalid code points are drawn as U+FFFD.
+		return 1;
+	}
+	uint8_t block = widthStage1[codePoint >> widthBlockBits];
+	uint8_t packed = widthStage2[(block << (widthBlockBits - 2)) + ((codePoint & 0xFF) >> 2)];
+	return (packed >> ((codePoint & 3) * 2)) & 3;
+}
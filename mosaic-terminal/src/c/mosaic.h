@@ -1,6 +1,8 @@
 #ifndef MOSAIC_H
 #define MOSAIC_H
 
+#include <stdint.h>
+
 #if defined(__APPLE__) || defined(__linux__)
 
 #include <termios.h>
@@ -41,13 +43,25 @@ typedef struct stdinWriterResult {
 
 typedef struct stdinRead {
 	int count;
+	/**
+	 * Non-zero when 'count' is 0 because of stdinReader_interrupt rather than a timeout. Interrupts
+	 * which occur while no read is waiting are coalesced and observed by the next read.
+	 */
+	int interrupted;
 	platformError error;
 } stdinRead;
 
 stdinReaderResult stdinReader_init();
 stdinRead stdinReader_read(stdinReader *reader, void *buffer, int count);
 stdinRead stdinReader_readWithTimeout(stdinReader *reader, void *buffer, int count, int timeoutMillis);
+stdinRead stdinReader_readWithTimeoutNanos(stdinReader *reader, void *buffer, int count, int64_t timeoutNanos);
 platformError stdinReader_interrupt(stdinReader* reader);
+/**
+ * Retrieve the file descriptors which become readable when a read would not block: stdin and the
+ * interrupt. Waiting on both (e.g., with an eventLoop) and then reading with a timeout of 0 allows
+ * many readers to share one waiting thread. Not supported on Windows or when reading with io_uring.
+ */
+platformError stdinReader_fds(stdinReader *reader, int *stdinFd, int *interruptFd);
 platformError stdinReader_free(stdinReader *reader);
 
 stdinWriterResult stdinWriter_init();
@@ -55,4 +69,231 @@ stdinReader *stdinWriter_getReader(stdinWriter *writer);
 platformError stdinWriter_write(stdinWriter *writer, void *buffer, int count);
 platformError stdinWriter_free(stdinWriter *writer);
 
+
+typedef struct stdoutWriterImpl stdoutWriter;
+
+typedef struct stdoutWriterResult {
+	stdoutWriter *writer;
+	platformError error;
+} stdoutWriterResult;
+
+stdoutWriterResult stdoutWriter_init();
+/**
+ * Return the writer's reusable output buffer after ensuring it can hold at least 'capacity' bytes.
+ * Previous contents are not preserved when the buffer grows. Returns NULL on allocation failure.
+ */
+char *stdoutWriter_buffer(stdoutWriter *writer, int capacity);
+/**
+ * Write the first 'count' bytes of the writer's buffer to stdout in their entirety.
+ *
+ * When using io_uring the write is only submitted and the buffer may be reused immediately.
+ * An error from the write is returned by the next call to this function or to stdoutWriter_free.
+ */
+platformError stdoutWriter_write(stdoutWriter *writer, int count);
+platformError stdoutWriter_free(stdoutWriter *writer);
+
+
+typedef struct terminalSize {
+	int columns;
+	int rows;
+	/** Non-zero when returned from resizeNotifier_await because of resizeNotifier_interrupt. */
+	int interrupted;
+	platformError error;
+} terminalSize;
+
+terminalSize getTerminalSize();
+
+typedef struct resizeNotifierImpl resizeNotifier;
+
+typedef struct resizeNotifierResult {
+	resizeNotifier *notifier;
+	platformError error;
+} resizeNotifierResult;
+
+/**
+ * Each notifier is woken by every resize. On POSIX-compliant platforms up to 32 can exist at the
+ * same time, after which creating another fails with EBUSY.
+ */
+resizeNotifierResult resizeNotifier_init();
+/** Block until the terminal is resized, returning its new size, or until interrupted. */
+terminalSize resizeNotifier_await(resizeNotifier *notifier);
+/**
+ * Retrieve the file descriptors which become readable when resizeNotifier_await would not block:
+ * the resize signal and the interrupt. Not supported on Windows.
+ */
+platformError resizeNotifier_fds(resizeNotifier *notifier, int *signalFd, int *interruptFd);
+platformError resizeNotifier_interrupt(resizeNotifier *notifier);
+platformError resizeNotifier_free(resizeNotifier *notifier);
+
+
+/** The stdin file descriptor is readable. */
+#define eventLoopEvent_stdin 1
+/** The terminal was resized one or more times. Query the new size with getTerminalSize. */
+#define eventLoopEvent_resize 2
+/** The timeout set by eventLoop_setTimeout elapsed. */
+#define eventLoopEvent_timeout 3
+/** eventLoop_interrupt was called one or more times. */
+#define eventLoopEvent_interrupt 4
+/** A file descriptor registered with eventLoop_addFd is readable. It is held in 'fd'. */
+#define eventLoopEvent_fd 5
+
+typedef struct eventLoopEvent {
+	/** One of the eventLoopEvent_ values. */
+	uint32_t type;
+	/** The readable file descriptor when 'type' is eventLoopEvent_fd. Otherwise 0. */
+	int32_t fd;
+} eventLoopEvent;
+
+typedef struct eventLoopImpl eventLoop;
+
+typedef struct eventLoopResult {
+	eventLoop *loop;
+	platformError error;
+} eventLoopResult;
+
+typedef struct eventLoopWait {
+	int count;
+	platformError error;
+} eventLoopWait;
+
+/**
+ * Create a loop which waits on stdin, an optional timeout, interrupts, registered file
+ * descriptors, and terminal resizes when 'watchResize' is non-zero. Watching resizes creates a
+ * resizeNotifier. Not supported on Windows.
+ */
+eventLoopResult eventLoop_init(int watchResize);
+/** Watch 'fd' for readability. Removing the stdin file descriptor stops watching stdin. */
+platformError eventLoop_addFd(eventLoop *loop, int fd);
+platformError eventLoop_removeFd(eventLoop *loop, int fd);
+/**
+ * Deliver a single eventLoopEvent_timeout once 'timeoutNanos' have passed on a monotonic clock,
+ * replacing any previous timeout. A negative value removes the timeout.
+ */
+platformError eventLoop_setTimeout(eventLoop *loop, int64_t timeoutNanos);
+/**
+ * Block until at least one event occurs, then write up to 'capacity' events into 'events' and
+ * return their count. Stdin and registered file descriptors are reported by every wait while they
+ * remain readable. Resizes, interrupts, and timeouts are reported once. Events which do not fit
+ * are reported by the next wait.
+ */
+eventLoopWait eventLoop_wait(eventLoop *loop, eventLoopEvent *events, int capacity);
+platformError eventLoop_interrupt(eventLoop *loop);
+/** Frees the loop and its resizeNotifier, if any. Registered file descriptors are not closed. */
+platformError eventLoop_free(eventLoop *loop);
+/** Create an event loop which watches the writer's pipe as its stdin. Resizes are not watched. */
+eventLoopResult stdinWriter_eventLoop(stdinWriter *writer);
+/** Create an event loop which does not watch stdin or resizes, only registered file descriptors. */
+eventLoopResult eventLoop_initWithoutStdin();
+
+
+#define inputKey_codePoint 0
+#define inputKey_enter 1
+#define inputKey_tab 2
+#define inputKey_backspace 3
+#define inputKey_escape 4
+#define inputKey_up 5
+#define inputKey_down 6
+#define inputKey_left 7
+#define inputKey_right 8
+#define inputKey_home 9
+#define inputKey_end 10
+#define inputKey_insert 11
+#define inputKey_delete 12
+#define inputKey_pageUp 13
+#define inputKey_pageDown 14
+/** F1 through F12 are contiguous starting from this value. */
+#define inputKey_f1 15
+/**
+ * Text delivered by bracketed paste. 'codePoint' holds the length in bytes of the UTF-8 text
+ * which can be retrieved with inputParser_paste.
+ */
+#define inputKey_paste 27
+
+#define inputModifier_shift 1
+#define inputModifier_alt 2
+#define inputModifier_ctrl 4
+
+typedef struct inputEvent {
+	/** One of the inputKey_ values. When inputKey_codePoint, 'codePoint' holds the character. */
+	uint16_t key;
+	/** A bitmask of inputModifier_ values. */
+	uint16_t modifiers;
+	uint32_t codePoint;
+} inputEvent;
+
+typedef struct inputParserImpl inputParser;
+
+/** Returns NULL on allocation failure. */
+inputParser *inputParser_init();
+/**
+ * Decode 'count' bytes from 'buffer' into 'events', returning the number of events written.
+ * 'events' must have room for at least count + 1 events. Incomplete sequences at the end of the
+ * buffer are retained and continue with the bytes of the next call.
+ */
+int inputParser_parse(inputParser *parser, const char *buffer, int count, inputEvent *events);
+/** Returns non-zero when bytes of an incomplete, or ambiguous, sequence are retained. */
+int inputParser_hasPending(inputParser *parser);
+/**
+ * Resolve any retained bytes as if no more input will follow, such as a lone escape key press.
+ * 'events' must have room for at least 1 event. Returns the number of events written.
+ */
+int inputParser_flush(inputParser *parser, inputEvent *events);
+/**
+ * Return a pointer to 'length' bytes of pasted text starting at 'offset'. The text of each paste
+ * event from the most recent call to inputParser_parse is stored consecutively in event order.
+ * Returns NULL if the range is out of bounds. Contents are invalidated by the next parse.
+ */
+const char *inputParser_paste(inputParser *parser, int offset, int length);
+void inputParser_free(inputParser *parser);
+
+
+/** Each cell of a grid is this many consecutive 32-bit words, such as a code point and its attributes. */
+#define cellGrid_cellWords 4
+
+/**
+ * Compare two grids of 'width' by 'height' cells and write each changed region as three integers
+ * (row, start column, end column exclusive) into 'runs', returning the number of regions written.
+ * Unchanged gaps of at most 'mergeGap' cells between two changed regions of the same row are
+ * folded into a single region since rewriting them is cheaper than repositioning the cursor.
+ * 'runs' must have room for at least 3 * height * ((width + 1) / 2) integers.
+ */
+int cellGrid_diff(
+	const uint32_t *previous,
+	const uint32_t *next,
+	int width,
+	int height,
+	int mergeGap,
+	int32_t *runs
+);
+
+#define cellGrid_colorLevelNone 0
+#define cellGrid_colorLevel16 1
+#define cellGrid_colorLevel256 2
+#define cellGrid_colorLevelTruecolor 3
+
+/** A foreground or background which uses the terminal default. Other colors are 0xRRGGBB. */
+#define cellGrid_defaultColor 0x80000000u
+/** A style with no attributes. Otherwise styles are a bitmask of the TextStyle values. */
+#define cellGrid_emptyStyle 1u
+/** The code point of a cell covered by the right half of the wide character before it. */
+#define cellGrid_wideContinuation 0xFFFFFFFEu
+
+/** The number of bytes which must be available to cellGrid_encodeRow for 'count' cells. */
+#define cellGrid_encodedRowCapacity(count) ((count) * 64 + 8)
+
+/**
+ * Encode 'count' cells of a row into 'out' as UTF-8 text preceded by SGR sequences wherever
+ * attributes change, returning the number of bytes written. Attributes are assumed to be reset
+ * at the start, and are reset again at the end if any were set. Each cell is a code point,
+ * foreground, background, and style. Cells of cellGrid_wideContinuation write no text.
+ * 'out' must have room for cellGrid_encodedRowCapacity bytes.
+ */
+int cellGrid_encodeRow(const uint32_t *cells, int count, int colorLevel, char *out);
+
+/**
+ * The number of cells occupied by 'codePoint': 0 for combining marks and other zero-width
+ * characters, 2 for East Asian wide and fullwidth characters, and 1 otherwise.
+ */
+int unicodeWidth_codePoint(uint32_t codePoint);
+
 #endif // MOSAIC_H
@@ -0,0 +1,238 @@
+// Compares the poll and io_uring backends by the latency and number of system calls of a frame:
+// reading one byte of input from stdin and then writing a screen of output to stdout.
+//
+// Run with 'zig build bench' from the mosaic-terminal/ directory. System calls are only counted
+// on Linux, where the benchmark traces a child process running the same frames.
+
+#include "mosaic.h"
+#include "mosaic-internal.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#endif
+
+#define warmupIterations 100
+#define timedFrames 20000
+#define countedFrames 1000
+
+// About a full 120x40 screen of styled text.
+#define frameBytes 8192
+
+static uint64_t nowNanos() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+static void check(platformError error, const char *operation) {
+	if (error) {
+		fprintf(stderr, "%s failed: %u\n", operation, (unsigned int) error);
+		exit(1);
+	}
+}
+
+static int compareNanos(const void *a, const void *b) {
+	uint64_t left = *(const uint64_t *) a;
+	uint64_t right = *(const uint64_t *) b;
+	return (left > right) - (left < right);
+}
+
+typedef struct frameSession {
+	stdinWriter *input;
+	stdinReader *reader;
+	stdoutWriter *output;
+} frameSession;
+
+/** Create a session using io_uring if 'useUring' is non-zero and the kernel supports it. */
+static frameSession createSession(int useUring) {
+	if (useUring) {
+		setenv("MOSAIC_IO_URING", "1", 1);
+	} else {
+		unsetenv("MOSAIC_IO_URING");
+	}
+
+	frameSession session = {};
+	stdinWriterResult input = stdinWriter_init();
+	check(input.error, "stdinWriter_init");
+	session.input = input.writer;
+	session.reader = stdinWriter_getReader(input.writer);
+
+	int devNull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+	if (devNull == -1) {
+		perror("open /dev/null");
+		exit(1);
+	}
+	stdoutWriterResult output = stdoutWriter_initWithFd(devNull);
+	check(output.error, "stdoutWriter_init");
+	session.output = output.writer;
+	return session;
+}
+
+static void freeSession(frameSession session) {
+	check(stdoutWriter_free(session.output), "stdoutWriter_free");
+	check(stdinReader_free(session.reader), "stdinReader_free");
+	check(stdinWriter_free(session.input), "stdinWriter_free");
+}
+
+static void runFrame(frameSession session) {
+	char key = 'a';
+	check(stdinWriter_write(session.input, &key, 1), "stdinWriter_write");
+
+	char input[64];
+	stdinRead read = stdinReader_read(session.reader, input, sizeof(input));
+	check(read.error, "stdinReader_read");
+	if (read.count != 1) {
+		fprintf(stderr, "stdinReader_read failed: expected 1 byte but got %d\n", read.count);
+		exit(1);
+	}
+
+	char *buffer = stdoutWriter_buffer(session.output, frameBytes);
+	if (buffer == NULL) {
+		fprintf(stderr, "stdoutWriter_buffer failed: out of memory\n");
+		exit(1);
+	}
+	memset(buffer, input[0], frameBytes);
+	check(stdoutWriter_write(session.output, frameBytes), "stdoutWriter_write");
+}
+
+static void benchmarkLatency(const char *name, int useUring) {
+	frameSession session = createSession(useUring);
+	uint64_t *samples = malloc(timedFrames * sizeof(uint64_t));
+	for (int i = -warmupIterations; i < timedFrames; i++) {
+		uint64_t start = nowNanos();
+		runFrame(session);
+		uint64_t end = nowNanos();
+		if (i >= 0) {
+			samples[i] = end - start;
+		}
+	}
+	freeSession(session);
+
+	qsort(samples, timedFrames, sizeof(uint64_t), compareNanos);
+	printf(
+		"%-20s p50 %9llu ns  p99 %9llu ns  %7d frames\n",
+		name,
+		(unsigned long long) samples[timedFrames / 2],
+		(unsigned long long) samples[timedFrames * 99 / 100],
+		timedFrames
+	);
+	free(samples);
+}
+
+#if defined(__linux__)
+/**
+ * Count the system calls made by a traced child while it runs 'frames' frames. SIGUSR1 marks the
+ * start and end of the frames so that setup and teardown are not counted. Returns -1 if the child
+ * cannot be traced (e.g., when ptrace is blocked by seccomp).
+ */
+static long countSyscalls(int useUring, int frames) {
+	pid_t child = fork();
+	if (child == -1) {
+		perror("fork");
+		exit(1);
+	}
+	if (child == 0) {
+		if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) != 0) {
+			_exit(2);
+		}
+		raise(SIGSTOP);
+
+		frameSession session = createSession(useUring);
+		for (int i = 0; i < warmupIterations; i++) {
+			runFrame(session);
+		}
+		raise(SIGUSR1);
+		for (int i = 0; i < frames; i++) {
+			runFrame(session);
+		}
+		raise(SIGUSR1);
+		freeSession(session);
+		_exit(0);
+	}
+
+	long count = 0;
+	int counting = 0;
+	int inSyscall = 0;
+	while (1) {
+		int status;
+		if (waitpid(child, &status, 0) == -1) {
+			perror("waitpid");
+			exit(1);
+		}
+		if (WIFEXITED(status)) {
+			return WEXITSTATUS(status) == 0 ? count : -1;
+		}
+		if (WIFSIGNALED(status)) {
+			fprintf(stderr, "Traced child killed by signal %d\n", WTERMSIG(status));
+			exit(1);
+		}
+
+		int signal = WSTOPSIG(status);
+		int deliver = 0;
+		if (signal == (SIGTRAP | 0x80)) {
+			// Syscall stops alternate between entry and exit.
+			inSyscall = !inSyscall;
+			if (inSyscall && counting) {
+				count++;
+			}
+		} else if (signal == SIGSTOP) {
+			ptrace(PTRACE_SETOPTIONS, child, NULL, (void *) PTRACE_O_TRACESYSGOOD);
+		} else if (signal == SIGUSR1) {
+			counting = !counting;
+		} else {
+			deliver = signal;
+		}
+		ptrace(PTRACE_SYSCALL, child, NULL, (void *) (intptr_t) deliver);
+	}
+}
+
+static void benchmarkSyscalls(const char *name, int useUring) {
+	long baseline = countSyscalls(useUring, 0);
+	long counted = countSyscalls(useUring, countedFrames);
+	if (baseline < 0 || counted < 0) {
+		printf("%-20s system calls unavailable: unable to trace child process\n", name);
+		return;
+	}
+	// One write per frame simulates the input and would not be made by a real session.
+	double perFrame = (double) (counted - baseline) / countedFrames - 1;
+	printf("%-20s %5.2f system calls per frame\n", name, perFrame);
+}
+#endif
+
+int main() {
+#if defined(__linux__)
+	setenv("MOSAIC_IO_URING", "1", 1);
+	uring *ring = uring_init(2);
+	int uringSupported = ring != NULL;
+	if (uringSupported) {
+		uring_free(ring);
+	}
+#else
+	int uringSupported = 0;
+#endif
+
+	benchmarkLatency("poll frame", 0);
+	if (uringSupported) {
+		benchmarkLatency("io_uring frame", 1);
+	} else {
+		printf("%-20s unavailable\n", "io_uring frame");
+	}
+
+#if defined(__linux__)
+	benchmarkSyscalls("poll frame", 0);
+	if (uringSupported) {
+		benchmarkSyscalls("io_uring frame", 1);
+	}
+#endif
+	return 0;
+}
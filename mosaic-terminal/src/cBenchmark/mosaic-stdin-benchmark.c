@@ -0,0 +1,228 @@
+// Measures the latency and throughput of reading stdin through a stdinWriter's pipe.
+//
+// Run with 'zig build bench' from the mosaic-terminal/ directory.
+
+#include "mosaic.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define warmupIterations 100
+#define roundTripIterations 20000
+#define wakeupIterations 1000
+#define throughputBytes (64 * 1024 * 1024)
+
+// Long enough for the reader thread to be blocked waiting before it is interrupted.
+#define wakeupBlockMicros 200
+
+static uint64_t nowNanos() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * 1000000000u + (uint64_t) time.tv_nsec;
+}
+
+static void check(platformError error, const char *operation) {
+	if (error) {
+		fprintf(stderr, "%s failed: %u\n", operation, (unsigned int) error);
+		exit(1);
+	}
+}
+
+static int compareNanos(const void *a, const void *b) {
+	uint64_t left = *(const uint64_t *) a;
+	uint64_t right = *(const uint64_t *) b;
+	return (left > right) - (left < right);
+}
+
+static void report(const char *name, uint64_t *samples, int count, const char *suffix) {
+	qsort(samples, count, sizeof(uint64_t), compareNanos);
+	printf(
+		"%-20s p50 %9llu ns  p99 %9llu ns  %7d samples%s\n",
+		name,
+		(unsigned long long) samples[count / 2],
+		(unsigned long long) samples[count * 99 / 100],
+		count,
+		suffix
+	);
+}
+
+static stdinWriter *createWriter() {
+	stdinWriterResult result = stdinWriter_init();
+	check(result.error, "stdinWriter_init");
+	if (result.writer == NULL) {
+		fprintf(stderr, "stdinWriter_init failed: out of memory\n");
+		exit(1);
+	}
+	return result.writer;
+}
+
+static void freeWriter(stdinWriter *writer) {
+	check(stdinReader_free(stdinWriter_getReader(writer)), "stdinReader_free");
+	check(stdinWriter_free(writer), "stdinWriter_free");
+}
+
+static void readFully(stdinReader *reader, char *buffer, int count) {
+	while (count > 0) {
+		stdinRead read = stdinReader_read(reader, buffer, count);
+		check(read.error, "stdinReader_read");
+		if (read.count < 0) {
+			fprintf(stderr, "stdinReader_read failed: unexpected EOF\n");
+			exit(1);
+		}
+		count -= read.count;
+	}
+}
+
+/** Time writing 'size' bytes and then reading them back on the same thread. */
+static void benchmarkRoundTrip(int size) {
+	stdinWriter *writer = createWriter();
+	stdinReader *reader = stdinWriter_getReader(writer);
+	char *buffer = calloc(size, 1);
+	uint64_t *samples = malloc(roundTripIterations * sizeof(uint64_t));
+
+	for (int i = -warmupIterations; i < roundTripIterations; i++) {
+		uint64_t start = nowNanos();
+		check(stdinWriter_write(writer, buffer, size), "stdinWriter_write");
+		readFully(reader, buffer, size);
+		uint64_t end = nowNanos();
+		if (i >= 0) {
+			samples[i] = end - start;
+		}
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "round trip %d B", size);
+	report(name, samples, roundTripIterations, "");
+
+	free(samples);
+	free(buffer);
+	freeWriter(writer);
+}
+
+typedef struct interruptedRead {
+	stdinReader *reader;
+	uint64_t returnedNanos;
+} interruptedRead;
+
+static void *readUntilInterrupted(void *arg) {
+	interruptedRead *state = arg;
+	char buffer[1];
+	stdinRead read = stdinReader_read(state->reader, buffer, sizeof(buffer));
+	state->returnedNanos = nowNanos();
+	check(read.error, "stdinReader_read");
+	if (!read.interrupted) {
+		fprintf(stderr, "stdinReader_read returned without being interrupted\n");
+		exit(1);
+	}
+	return NULL;
+}
+
+/** Time from calling stdinReader_interrupt until a read blocked on another thread returns. */
+static void benchmarkInterruptWakeup() {
+	uint64_t *samples = malloc(wakeupIterations * sizeof(uint64_t));
+	// Interrupts are consumed by the read they wake, so one reader serves every sample.
+	stdinWriter *writer = createWriter();
+	interruptedRead state = { .reader = stdinWriter_getReader(writer) };
+
+	for (int i = -warmupIterations; i < wakeupIterations; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, readUntilInterrupted, &state) != 0) {
+			fprintf(stderr, "pthread_create failed\n");
+			exit(1);
+		}
+		usleep(wakeupBlockMicros);
+
+		uint64_t start = nowNanos();
+		check(stdinReader_interrupt(state.reader), "stdinReader_interrupt");
+		pthread_join(thread, NULL);
+		if (i >= 0) {
+			samples[i] = state.returnedNanos - start;
+		}
+	}
+	freeWriter(writer);
+
+	report("interrupt wakeup", samples, wakeupIterations, "");
+	free(samples);
+}
+
+typedef struct throughputWriter {
+	stdinWriter *writer;
+	int size;
+} throughputWriter;
+
+static void *writeThroughputBytes(void *arg) {
+	throughputWriter *state = arg;
+	char *buffer = calloc(state->size, 1);
+	for (int written = 0; written < throughputBytes; written += state->size) {
+		check(stdinWriter_write(state->writer, buffer, state->size), "stdinWriter_write");
+	}
+	free(buffer);
+	return NULL;
+}
+
+/**
+ * Read bytes written continuously by another thread into a buffer of 'size' bytes. Reports the
+ * latency of each read call and the overall rate.
+ */
+static void benchmarkThroughput(int size) {
+	stdinWriter *writer = createWriter();
+	stdinReader *reader = stdinWriter_getReader(writer);
+	char *buffer = malloc(size);
+	int maxSamples = throughputBytes / size + 1;
+	uint64_t *samples = malloc(maxSamples * sizeof(uint64_t));
+	int sampleCount = 0;
+
+	throughputWriter state = { .writer = writer, .size = size };
+	pthread_t thread;
+	if (pthread_create(&thread, NULL, writeThroughputBytes, &state) != 0) {
+		fprintf(stderr, "pthread_create failed\n");
+		exit(1);
+	}
+
+	uint64_t start = nowNanos();
+	int remaining = throughputBytes;
+	while (remaining > 0) {
+		uint64_t readStart = nowNanos();
+		stdinRead read = stdinReader_read(reader, buffer, size);
+		uint64_t readEnd = nowNanos();
+		check(read.error, "stdinReader_read");
+		if (read.count < 0) {
+			fprintf(stderr, "stdinReader_read failed: unexpected EOF\n");
+			exit(1);
+		}
+		remaining -= read.count;
+		if (sampleCount < maxSamples) {
+			samples[sampleCount++] = readEnd - readStart;
+		}
+	}
+	uint64_t elapsed = nowNanos() - start;
+	pthread_join(thread, NULL);
+
+	char name[64];
+	snprintf(name, sizeof(name), "read %d B buffer", size);
+	char rate[64];
+	snprintf(rate, sizeof(rate), "  %.1f MiB/s", (throughputBytes / (1024.0 * 1024.0)) / (elapsed / 1e9));
+	report(name, samples, sampleCount, rate);
+
+	free(samples);
+	free(buffer);
+	freeWriter(writer);
+}
+
+int main() {
+	benchmarkRoundTrip(1);
+	benchmarkRoundTrip(64);
+	benchmarkRoundTrip(4096);
+
+	benchmarkInterruptWakeup();
+
+	benchmarkThroughput(64);
+	benchmarkThroughput(1024);
+	benchmarkThroughput(8192);
+	benchmarkThroughput(65536);
+	return 0;
+}
@@ -0,0 +1,121 @@
+package com.jakewharton.mosaic.terminal
+
+/**
+ * Operations over grids of terminal cells stored as packed integers.
+ *
+ * Each cell occupies [CellWords] consecutive values of an [IntArray], laid out row by row.
+ * The meaning of each value is up to the caller; cells are only compared for equality.
+ */
+public object CellGrid {
+	/** The number of consecutive [Int] values which make up one cell. */
+	public const val CellWords: Int = 4
+
+	/**
+	 * The code point of a cell covered by the right half of the wide character before it.
+	 * [encodeRow] writes no text for such cells.
+	 */
+	public const val WideContinuation: Int = -2
+
+	/** A [encodeRow] color level which emits no colors or styles. */
+	public const val ColorLevelNone: Int = 0
+
+	/** A [encodeRow] color level which maps colors to the 16 standard ANSI colors. */
+	public const val ColorLevel16: Int = 1
+
+	/** A [encodeRow] color level which maps colors to the 256-color palette. */
+	public const val ColorLevel256: Int = 2
+
+	/** A [encodeRow] color level which emits colors as 24-bit RGB. */
+	public const val ColorLevelTruecolor: Int = 3
+
+	/** The minimum size of the `runs` array passed to [diff] for a grid of the given dimensions. */
+	public fun runsSize(width: Int, height: Int): Int = 3 * height * ((width + 1) / 2)
+
+	/**
+	 * Compare two grids of [width] by [height] cells and write each changed region into [runs] as
+	 * three consecutive values: its row, start column, and end column (exclusive). Returns the
+	 * number of regions written, in row-major order.
+	 *
+	 * Unchanged gaps of at most [mergeGap] cells between two changed regions on the same row are
+	 * folded into a single region since rewriting a few cells is cheaper than moving the cursor.
+	 *
+	 * @param runs An array with a size of at least [runsSize].
+	 */
+	public fun diff(
+		previous: IntArray,
+		next: IntArray,
+		width: Int,
+		height: Int,
+		mergeGap: Int,
+		runs: IntArray,
+	): Int {
+		// The native comparison reads and writes these arrays directly so verify bounds up front.
+		require(width >= 0 && height >= 0) { "width=$width, height=$height" }
+		require(mergeGap >= 0) { "mergeGap must be non-negative: $mergeGap" }
+		val cells = width.toLong() * height * CellWords
+		require(previous.size.toLong() == cells && next.size.toLong() == cells) {
+			"Grids must have exactly $cells values: previous=${previous.size}, next=${next.size}"
+		}
+		require(runs.size >= runsSize(width, height)) {
+			"runs.size must be at least ${runsSize(width, height)}: ${runs.size}"
+		}
+		if (cells == 0L) return 0
+		return cellGridDiff(previous, next, width, height, mergeGap, runs)
+	}
+
+	/** The minimum space in the `output` array passed to [encodeRow] for [count] cells. */
+	public fun encodedRowCapacity(count: Int): Int = count * 64 + 8
+
+	/**
+	 * Encode [count] cells starting at cell [offset] of [cells] into [output] at [outputOffset] as
+	 * UTF-8 text preceded by SGR sequences wherever attributes change. Returns the number of bytes
+	 * written. Attributes are assumed to be reset at the start, and are reset again at the end if
+	 * any were set.
+	 *
+	 * Each cell is a code point, foreground, background, and style. Colors are `0xRRGGBB`, or
+	 * [Int.MIN_VALUE] for the terminal default. Styles are a bitmask of Mosaic's `TextStyle` values.
+	 *
+	 * @param colorLevel One of [ColorLevelNone], [ColorLevel16], [ColorLevel256], or
+	 * [ColorLevelTruecolor].
+	 * @param output An array with at least [encodedRowCapacity] bytes available after [outputOffset].
+	 */
+	public fun encodeRow(
+		cells: IntArray,
+		offset: Int,
+		count: Int,
+		colorLevel: Int,
+		output: ByteArray,
+		outputOffset: Int,
+	): Int {
+		// The native encoder reads and writes these arrays directly so verify bounds up front.
+		if (offset < 0 || count < 0 || offset.toLong() + count > cells.size / CellWords) {
+			throw IndexOutOfBoundsException("offset=$offset, count=$count, cells=${cells.size / CellWords}")
+		}
+		require(colorLevel in ColorLevelNone..ColorLevelTruecolor) { "Invalid color level: $colorLevel" }
+		if (outputOffset < 0 || output.size.toLong() - outputOffset < encodedRowCapacity(count)) {
+			throw IndexOutOfBoundsException(
+				"outputOffset=$outputOffset, capacity=${encodedRowCapacity(count)}, size=${output.size}",
+			)
+		}
+		if (count == 0) return 0
+		return cellGridEncodeRow(cells, offset, count, colorLevel, output, outputOffset)
+	}
+}
+
+internal expect fun cellGridEncodeRow(
+	cells: IntArray,
+	offset: Int,
+	count: Int,
+	colorLevel: Int,
+	output: ByteArray,
+	outputOffset: Int,
+): Int
+
+internal expect fun cellGridDiff(
+	previous: IntArray,
+	next: IntArray,
+	width: Int,
+	height: Int,
+	mergeGap: Int,
+	runs: IntArray,
+): Int
@@ -0,0 +1,44 @@
+package com.jakewharton.mosaic.terminal
+
+import kotlin.jvm.JvmInline
+
+/**
+ * A single event reported by [EventLoop.await].
+ *
+ * [EventLoopEvent] uses a [Long] to represent two values which mirror the native event record:
+ * [type] in the lower 32 bits and [fd] in the upper 32 bits. This allows events to be delivered
+ * in bulk into a [LongArray] with no allocation.
+ */
+@JvmInline
+public value class EventLoopEvent(
+	public val value: Long,
+) {
+	/** One of the `Type` constants. */
+	public val type: Int
+		get() = value.toInt()
+
+	/** The readable file descriptor when [type] is [TypeFd]. Otherwise 0. */
+	public val fd: Int
+		get() = (value ushr 32).toInt()
+
+	override fun toString(): String {
+		return "EventLoopEvent(type=$type, fd=$fd)"
+	}
+
+	public companion object {
+		/** Stdin is readable. Read it without blocking using [StdinReader.readWithTimeout] and 0. */
+		public const val TypeStdin: Int = 1
+
+		/** The terminal was resized one or more times since the last event. */
+		public const val TypeResize: Int = 2
+
+		/** The timeout set with [EventLoop.setTimeout] has passed. */
+		public const val TypeTimeout: Int = 3
+
+		/** [EventLoop.interrupt] was called one or more times since the last event. */
+		public const val TypeInterrupt: Int = 4
+
+		/** A file descriptor added with [EventLoop.addFd] is readable. */
+		public const val TypeFd: Int = 5
+	}
+}
@@ -0,0 +1,269 @@
+package com.jakewharton.mosaic.terminal
+
+import com.jakewharton.mosaic.terminal.EventLoopEvent.Companion.TypeFd
+import kotlin.coroutines.resume
+import kotlin.coroutines.resumeWithException
+import kotlinx.coroutines.CancellableContinuation
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineStart
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.IO
+import kotlinx.coroutines.NonCancellable
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.channels.Channel.Factory.UNLIMITED
+import kotlinx.coroutines.completeWith
+import kotlinx.coroutines.coroutineScope
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.suspendCancellableCoroutine
+import kotlinx.coroutines.withContext
+
+/**
+ * Suspends callers until one of their file descriptors is readable. A single thread waits on
+ * behalf of every caller in one [EventLoop], so any number of concurrent waits cost no threads.
+ *
+ * File descriptors are only registered with the loop while a caller is waiting on them. Each
+ * wait is one-shot: the caller is resumed once and then re-registers if it needs to wait again.
+ */
+internal class FdPoller(private val loop: EventLoop) {
+	private val requests = Channel<Request>(UNLIMITED)
+
+	/** Only accessed by the poller thread. */
+	private val waitersByFd = HashMap<Int, MutableList<Waiter>>()
+
+	private class Waiter(
+		val fds: IntArray,
+		val continuation: CancellableContinuation<Unit>,
+	)
+
+	private sealed interface Request {
+		class Add(val waiter: Waiter) : Request
+		class Remove(val waiter: Waiter) : Request
+	}
+
+	/** Suspend until [fd1] or [fd2] is readable, or until either cannot be waited on. */
+	suspend fun awaitReadable(fd1: Int, fd2: Int) {
+		suspendCancellableCoroutine { continuation ->
+			val waiter = Waiter(intArrayOf(fd1, fd2), continuation)
+			continuation.invokeOnCancellation {
+				send(Request.Remove(waiter))
+			}
+			send(Request.Add(waiter))
+		}
+	}
+
+	private fun send(request: Request) {
+		val result = requests.trySend(request)
+		if (result.isClosed) {
+			// The poller thread failed. Fail this waiter too rather than letting it wait forever.
+			if (request is Request.Add) {
+				request.waiter.continuation.resumeWithException(result.exceptionOrNull()!!)
+			}
+			return
+		}
+		loop.interrupt()
+	}
+
+	/**
+	 * Wait for and dispatch events forever. Call from a dedicated thread.
+	 *
+	 * If the loop fails, every current and future waiter is resumed with its exception since no
+	 * thread remains to wake them.
+	 */
+	fun run() {
+		try {
+			dispatchEvents()
+		} catch (t: Throwable) {
+			requests.close(t)
+
+			val waiters = LinkedHashSet<Waiter>()
+			for (fdWaiters in waitersByFd.values) {
+				waiters += fdWaiters
+			}
+			waitersByFd.clear()
+			// Requests sent before the close are still buffered.
+			while (true) {
+				val request = requests.tryReceive().getOrNull() ?: break
+				if (request is Request.Add) {
+					waiters += request.waiter
+				}
+			}
+
+			for (waiter in waiters) {
+				// Skip a waiter which was resumed just before the failure.
+				if (waiter.continuation.isActive) {
+					waiter.continuation.resumeWithException(t)
+				}
+			}
+		}
+	}
+
+	private fun dispatchEvents() {
+		val events = LongArray(64)
+		while (true) {
+			// Requests are applied between waits since the loop can only be changed while not waiting.
+			while (true) {
+				when (val request = requests.tryReceive().getOrNull() ?: break) {
+					is Request.Add -> add(request.waiter)
+					is Request.Remove -> remove(request.waiter)
+				}
+			}
+
+			val count = loop.await(events)
+			for (i in 0 until count) {
+				val event = EventLoopEvent(events[i])
+				// Interrupts only exist to wake this loop to apply requests.
+				if (event.type == TypeFd) {
+					val waiters = waitersByFd[event.fd] ?: continue
+					for (waiter in waiters.toList()) {
+						// Resumed first so that a failure to remove it cannot leave it waiting.
+						waiter.continuation.resume(Unit)
+						remove(waiter)
+					}
+				}
+			}
+		}
+	}
+
+	private fun add(waiter: Waiter) {
+		if (waiter.continuation.isCompleted) return // Cancelled before it was added.
+
+		for (fd in waiter.fds) {
+			val waiters = waitersByFd.getOrPut(fd) {
+				try {
+					loop.addFd(fd)
+				} catch (e: IllegalStateException) {
+					// The fd cannot be waited on, such as a regular file which is always readable. Let the
+					// caller find out what happens when it reads.
+					waiter.continuation.resume(Unit)
+					remove(waiter)
+					return
+				}
+				ArrayList(1)
+			}
+			waiters += waiter
+		}
+	}
+
+	private fun remove(waiter: Waiter) {
+		for (fd in waiter.fds) {
+			val waiters = waitersByFd[fd] ?: continue
+			if (waiters.remove(waiter) && waiters.isEmpty()) {
+				waitersByFd.remove(fd)
+				try {
+					loop.removeFd(fd)
+				} catch (e: IllegalStateException) {
+					// The fd was closed after its waiter was cancelled, which already removed it.
+				}
+			}
+		}
+	}
+}
+
+/** The poller shared by every [StdinReader] and [ResizeNotifier]. Started when first used. */
+internal val sharedPoller: FdPoller by lazy {
+	val poller = FdPoller(Tty.eventLoopWithoutStdin())
+	startDaemonThread("mosaic-poller", poller::run)
+	poller
+}
+
+/** Start a thread which will not prevent the process from exiting. */
+internal expect fun startDaemonThread(name: String, block: () -> Unit)
+
+/**
+ * Run the blocking [block] on `Dispatchers.IO` for platforms whose file descriptors cannot be
+ * polled. If the caller is canceled, [interrupt] is called to wake [block], and this function
+ * waits for it to return and passes its result to [onCancel] before resuming.
+ */
+private suspend fun <T> interruptibleOnIo(
+	interrupt: () -> Unit,
+	onCancel: (T) -> Unit = {},
+	block: () -> T,
+): T {
+	// Not a child of the caller so that canceling does not discard a result which was produced.
+	val result = CompletableDeferred<T>()
+	return coroutineScope {
+		// Atomic so that the block always runs and completes the result, even if already canceled.
+		launch(Dispatchers.IO, start = CoroutineStart.ATOMIC) {
+			result.completeWith(runCatching(block))
+		}
+		try {
+			result.await()
+		} catch (e: CancellationException) {
+			interrupt()
+			val value = withContext(NonCancellable) {
+				runCatching { result.await() }
+			}
+			value.onSuccess(onCancel)
+			throw e
+		}
+	}
+}
+
+/**
+ * The implementation of [StdinReader.awaitRead] given the reader's [packedFds] from the native
+ * layer: stdin in the upper 32 bits and the interrupt in the lower 32 bits, or -1 if unsupported.
+ */
+internal suspend fun StdinReader.pollAndRead(
+	buffer: ByteArray,
+	offset: Int,
+	length: Int,
+	packedFds: Long,
+): Int {
+	canceledInput?.let { input ->
+		val count = minOf(input.size, length)
+		input.copyInto(buffer, offset, 0, count)
+		canceledInput = if (count < input.size) input.copyOfRange(count, input.size) else null
+		return count
+	}
+
+	if (packedFds == -1L) {
+		return interruptibleOnIo(
+			interrupt = this::interrupt,
+			onCancel = { read ->
+				if (read > 0) {
+					keepCanceledInput(buffer, offset, read)
+				}
+				drainInterrupt(buffer, offset, length)
+			},
+		) {
+			read(buffer, offset, length)
+		}
+	}
+
+	// Wait first so that an interrupt is not consumed by a read which then suspends anyway.
+	sharedPoller.awaitReadable((packedFds ushr 32).toInt(), packedFds.toInt())
+	return readWithTimeout(buffer, offset, length, 0)
+}
+
+private fun StdinReader.keepCanceledInput(buffer: ByteArray, offset: Int, count: Int) {
+	val previous = canceledInput ?: ByteArray(0)
+	canceledInput = previous + buffer.copyOfRange(offset, offset + count)
+}
+
+/**
+ * Consume the interrupt sent to wake a canceled read so that it does not end the next read
+ * early. Data which is available ahead of the interrupt is kept for the next read.
+ */
+private fun StdinReader.drainInterrupt(buffer: ByteArray, offset: Int, length: Int) {
+	while (true) {
+		val read = readWithTimeout(buffer, offset, length, 0)
+		if (read <= 0) break
+		keepCanceledInput(buffer, offset, read)
+	}
+}
+
+/**
+ * The implementation of [ResizeNotifier.awaitResize] given the notifier's [packedFds] from the
+ * native layer: the signal in the upper 32 bits and the interrupt in the lower 32 bits, or -1 if
+ * unsupported.
+ */
+internal suspend fun ResizeNotifier.pollAndAwaitResize(packedFds: Long): Boolean {
+	if (packedFds == -1L) {
+		return interruptibleOnIo(this::interrupt, block = this::awaitResizeBlocking)
+	}
+
+	// Once either is readable the blocking call returns immediately.
+	sharedPoller.awaitReadable((packedFds ushr 32).toInt(), packedFds.toInt())
+	return awaitResizeBlocking()
+}
@@ -0,0 +1,66 @@
+package com.jakewharton.mosaic.terminal
+
+import kotlin.jvm.JvmInline
+
+/**
+ * A single decoded unit of terminal input as produced by [InputParser].
+ *
+ * [InputEvent] uses a [Long] to represent three values which mirror the native event record:
+ * [key] in the lowest 16 bits, [modifiers] in the next 16 bits, and [codePoint] in the upper
+ * 32 bits. This allows events to be decoded in bulk into a [LongArray] with no allocation.
+ */
+@JvmInline
+public value class InputEvent(
+	public val value: Long,
+) {
+	/** One of the `Key` constants. When [KeyCodePoint], the character is held in [codePoint]. */
+	public val key: Int
+		get() = (value and 0xFFFF).toInt()
+
+	/** A bitmask of the `Modifier` constants. */
+	public val modifiers: Int
+		get() = ((value ushr 16) and 0xFFFF).toInt()
+
+	/**
+	 * The Unicode code point of the character when [key] is [KeyCodePoint], or the length in bytes
+	 * of the pasted text when [key] is [KeyPaste]. Otherwise 0.
+	 */
+	public val codePoint: Int
+		get() = (value ushr 32).toInt()
+
+	public val shift: Boolean get() = modifiers and ModifierShift != 0
+	public val alt: Boolean get() = modifiers and ModifierAlt != 0
+	public val ctrl: Boolean get() = modifiers and ModifierCtrl != 0
+
+	override fun toString(): String {
+		return "InputEvent(key=$key, modifiers=$modifiers, codePoint=$codePoint)"
+	}
+
+	public companion object {
+		public const val KeyCodePoint: Int = 0
+		public const val KeyEnter: Int = 1
+		public const val KeyTab: Int = 2
+		public const val KeyBackspace: Int = 3
+		public const val KeyEscape: Int = 4
+		public const val KeyUp: Int = 5
+		public const val KeyDown: Int = 6
+		public const val KeyLeft: Int = 7
+		public const val KeyRight: Int = 8
+		public const val KeyHome: Int = 9
+		public const val KeyEnd: Int = 10
+		public const val KeyInsert: Int = 11
+		public const val KeyDelete: Int = 12
+		public const val KeyPageUp: Int = 13
+		public const val KeyPageDown: Int = 14
+
+		/** F1 through F12 are contiguous starting from this value. */
+		public const val KeyF1: Int = 15
+
+		/** Text delivered by bracketed paste. Read it with [InputParser.pasteText]. */
+		public const val KeyPaste: Int = 27
+
+		public const val ModifierShift: Int = 1
+		public const val ModifierAlt: Int = 2
+		public const val ModifierCtrl: Int = 4
+	}
+}
@@ -24,10 +24,50 @@ public expect object Tty {
 	 * supporting interruption.
 	 *
 	 * Use with [enableRawMode] to read input byte-by-byte.
+	 *
+	 * On Linux, setting the `MOSAIC_IO_URING` environment variable to `1` reads with io_uring when
+	 * the kernel supports it. A read is then kept in flight between calls, so stdin should not also
+	 * be read by anything else, such as an [EventLoop].
 	 */
 	public fun stdinReader(): StdinReader
 
 	internal fun stdinWriter(): StdinWriter
+
+	/**
+	 * Create a [StdoutWriter] which will write to this process' stdout stream using a reusable
+	 * native buffer.
+	 *
+	 * On Linux, setting the `MOSAIC_IO_URING` environment variable to `1` writes with io_uring when
+	 * the kernel supports it. Writes then return once submitted, and a failure is thrown by the
+	 * next write or by [close][AutoCloseable.close].
+	 */
+	public fun stdoutWriter(): StdoutWriter
+
+	/**
+	 * Create a [ResizeNotifier] which waits until this process' terminal changes size.
+	 *
+	 * On POSIX-compliant platforms this is driven by `SIGWINCH` and consumes no CPU while waiting.
+	 * Every notifier is woken by each resize, but at most 32 may exist at the same time.
+	 */
+	public fun resizeNotifier(): ResizeNotifier
+
+	/**
+	 * Create an [EventLoop] which waits on stdin, a timeout, and file descriptors of the caller
+	 * all at once, as well as terminal resizes when [watchResize] is true. This allows a single
+	 * thread to handle all of them with one system call per wakeup.
+	 *
+	 * Watching resizes creates a [ResizeNotifier] internally. Not supported on Windows.
+	 */
+	public fun eventLoop(watchResize: Boolean): EventLoop
+
+	/** Create an [EventLoop] which only watches the file descriptors added to it. */
+	internal fun eventLoopWithoutStdin(): EventLoop
+
+	/**
+	 * Create an [InputParser] which decodes the raw bytes of terminal input, such as those read
+	 * by a [StdinReader] while in [raw mode][enableRawMode], into [InputEvent]s.
+	 */
+	public fun inputParser(): InputParser
 }
 
 public expect class StdinReader : AutoCloseable {
@@ -45,14 +85,55 @@ public expect class StdinReader : AutoCloseable {
 	 * 0 will be returned if [interrupt] is called while waiting for input, or if at least
 	 * [timeoutMillis] have passed without data. -1 will be returned if the input stream is closed.
 	 *
-	 * @param timeoutMillis A value of 0 will perform a non-blocking read. Otherwise, valid values
-	 * are 1 to 999 which represent a maximum time (in milliseconds) to wait for data. Note: This
-	 * value is not validated.
+	 * @param timeoutMillis A value of 0 will perform a non-blocking read. A negative value will wait
+	 * indefinitely, like [read]. Otherwise, the maximum time (in milliseconds) to wait for data.
 	 * @see read
+	 * @see readWithTimeoutNanos
 	 */
 	public fun readWithTimeout(buffer: ByteArray, offset: Int, length: Int, timeoutMillis: Int): Int
 
-	/** Signal blocking calls to [read] to wake up and return 0. */
+	/**
+	 * Read up to [length] bytes into [buffer] at [offset]. The number of bytes read will be returned.
+	 * 0 will be returned if [interrupt] is called while waiting for input, or if at least
+	 * [timeoutNanos] have passed without data. -1 will be returned if the input stream is closed.
+	 *
+	 * The timeout is measured against a monotonic clock and is not extended by signals which
+	 * interrupt the wait. Its precision is limited by the platform, where Windows rounds up to whole
+	 * milliseconds.
+	 *
+	 * @param timeoutNanos A value of 0 will perform a non-blocking read. A negative value will wait
+	 * indefinitely, like [read]. Otherwise, the maximum time (in nanoseconds) to wait for data.
+	 * @see read
+	 * @see readWithTimeout
+	 */
+	public fun readWithTimeoutNanos(buffer: ByteArray, offset: Int, length: Int, timeoutNanos: Long): Int
+
+	/**
+	 * Suspend until input is available and then read up to [length] bytes into [buffer] at [offset].
+	 * The number of bytes read will be returned. 0 will be returned if [interrupt] is called while
+	 * waiting for input. -1 will be returned if the input stream is closed. Cancel the calling
+	 * coroutine to stop waiting.
+	 *
+	 * Rather than blocking a thread per reader, a single thread shared by every reader waits for
+	 * all of their input. On Windows, and when reading with io_uring, a thread from
+	 * `Dispatchers.IO` is blocked instead. Canceling then waits for that read to return, and any
+	 * bytes it read are returned by the next call to this function.
+	 *
+	 * @see read
+	 */
+	public suspend fun awaitRead(buffer: ByteArray, offset: Int, length: Int): Int
+
+	/** Bytes read on behalf of a canceled [awaitRead] which the next call returns first. */
+	internal var canceledInput: ByteArray?
+
+	/**
+	 * Signal a blocking call to [read], [readWithTimeout], or [readWithTimeoutNanos], or a suspended
+	 * call to [awaitRead], to wake up and return 0.
+	 *
+	 * If no call is waiting, the next call returns 0 immediately instead. Multiple interrupts
+	 * before a call are coalesced into one. Data which is already available is returned before
+	 * a pending interrupt.
+	 */
 	public fun interrupt()
 
 	/**
@@ -71,5 +152,164 @@ internal expect class StdinWriter : AutoCloseable {
 	//  https://github.com/Kotlin/kotlinx-io/issues/354
 	fun write(buffer: ByteArray)
 
+	/** Create an [EventLoop] which watches this writer's [reader] as stdin. */
+	fun eventLoop(): EventLoop
+
+	override fun close()
+}
+
+public expect class StdoutWriter : AutoCloseable {
+	/**
+	 * Encode [chars] as UTF-8 and write all of the resulting bytes to stdout.
+	 *
+	 * The bytes are written from a single buffer in as few system calls as possible (usually one)
+	 * so that terminals see frames as atomic updates. No additional flushing is required.
+	 *
+	 * This function is not thread-safe.
+	 */
+	public fun write(chars: CharSequence)
+
+	/**
+	 * Write [length] bytes of [buffer] starting at [offset] to stdout. The bytes should already be
+	 * UTF-8, such as those produced by [CellGrid.encodeRow], and are written without re-encoding.
+	 *
+	 * Like the [CharSequence] overload, the bytes are written in as few system calls as possible.
+	 *
+	 * This function is not thread-safe.
+	 */
+	public fun write(buffer: ByteArray, offset: Int, length: Int)
+
+	/**
+	 * Free the resources associated with this writer.
+	 *
+	 * This call can be omitted if your process is exiting.
+	 */
+	override fun close()
+}
+
+public expect class EventLoop : AutoCloseable {
+	/** Report [fd] with [EventLoopEvent.TypeFd] events whenever it is readable. */
+	public fun addFd(fd: Int)
+
+	/** Stop watching [fd]. Removing the stdin file descriptor stops watching stdin. */
+	public fun removeFd(fd: Int)
+
+	/**
+	 * Report a single [EventLoopEvent.TypeTimeout] event once [timeoutNanos] have passed,
+	 * replacing any previous timeout. A negative value removes the timeout.
+	 */
+	public fun setTimeout(timeoutNanos: Long)
+
+	/**
+	 * Block until at least one event occurs, then write up to [events.size][LongArray.size]
+	 * [EventLoopEvent] values into [events] and return their count.
+	 *
+	 * Stdin and added file descriptors are reported by every call while they remain readable.
+	 * Resizes, interrupts, and timeouts are reported once, coalescing any repeats. Events which
+	 * do not fit are reported by the next call.
+	 */
+	public fun await(events: LongArray): Int
+
+	/** Signal a blocking call to [await] to wake up with an [EventLoopEvent.TypeInterrupt] event. */
+	public fun interrupt()
+
+	/**
+	 * Free the resources associated with this loop, including its resize notifier. Added file
+	 * descriptors are not closed.
+	 *
+	 * This call can be omitted if your process is exiting.
+	 */
+	override fun close()
+}
+
+public expect class ResizeNotifier : AutoCloseable {
+	/**
+	 * The width of the terminal as of the creation of this notifier or the most recent call to
+	 * [awaitResize] or [awaitResizeBlocking] which returned true. 0 if unknown, such as when not
+	 * attached to a terminal.
+	 */
+	public val columns: Int
+
+	/**
+	 * The height of the terminal as of the creation of this notifier or the most recent call to
+	 * [awaitResize] or [awaitResizeBlocking] which returned true. 0 if unknown, such as when not
+	 * attached to a terminal.
+	 */
+	public val rows: Int
+
+	/**
+	 * Suspend until the terminal is resized, update [columns] and [rows], and return true.
+	 * False will be returned if [interrupt] is called while waiting. Cancel the calling coroutine
+	 * to stop waiting.
+	 *
+	 * Multiple resizes which occur between calls are coalesced into one.
+	 *
+	 * Rather than blocking a thread per notifier, the thread which waits for [StdinReader.awaitRead]
+	 * also waits for resizes. On Windows a thread from `Dispatchers.IO` is blocked instead.
+	 *
+	 * @see awaitResizeBlocking
+	 */
+	public suspend fun awaitResize(): Boolean
+
+	/**
+	 * Block until the terminal is resized, update [columns] and [rows], and return true.
+	 * False will be returned if [interrupt] is called while waiting.
+	 *
+	 * Multiple resizes which occur between calls are coalesced into one.
+	 *
+	 * @see awaitResize
+	 */
+	public fun awaitResizeBlocking(): Boolean
+
+	/** Signal a call to [awaitResize] or [awaitResizeBlocking] to wake up and return false. */
+	public fun interrupt()
+
+	/**
+	 * Free the resources associated with this notifier and restore the previous signal handler.
+	 *
+	 * This call can be omitted if your process is exiting.
+	 */
+	override fun close()
+}
+
+public expect class InputParser : AutoCloseable {
+	/**
+	 * Decode [length] bytes from [buffer] at [offset] into [events], returning the number of
+	 * events written. Each element of [events] can be read by wrapping it in an [InputEvent].
+	 *
+	 * [events] must have a size of at least [length] + 1. Escape sequences or UTF-8 characters
+	 * which are incomplete at the end of [buffer] are retained and completed by the next call.
+	 *
+	 * @see hasPending
+	 */
+	public fun parse(buffer: ByteArray, offset: Int, length: Int, events: LongArray): Int
+
+	/**
+	 * True when bytes of an incomplete sequence are retained. Since a lone escape key press is
+	 * indistinguishable from the start of an escape sequence, callers should wait a short time
+	 * for additional input and then call [flush] if none arrives.
+	 */
+	public val hasPending: Boolean
+
+	/**
+	 * Resolve any retained bytes as if no further input will follow, writing at most one event
+	 * into [events] and returning the number written.
+	 */
+	public fun flush(events: LongArray): Int
+
+	/**
+	 * Decode the UTF-8 text of [paste events][InputEvent.KeyPaste] from the most recent call to
+	 * [parse]. The text of each paste is stored consecutively in event order, so [offset] is the
+	 * sum of the lengths of any preceding paste events from the same call.
+	 *
+	 * @param length The [InputEvent.codePoint] value of the paste event.
+	 */
+	public fun pasteText(offset: Int, length: Int): String
+
+	/**
+	 * Free the resources associated with this parser.
+	 *
+	 * This call can be omitted if your process is exiting.
+	 */
 	override fun close()
 }
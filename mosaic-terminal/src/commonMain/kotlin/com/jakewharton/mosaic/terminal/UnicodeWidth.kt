@@ -0,0 +1,59 @@
+package com.jakewharton.mosaic.terminal
+
+/**
+ * The number of terminal cells occupied by code points, similar to `wcwidth`.
+ *
+ * Combining marks and other zero-width characters occupy 0 cells. East Asian wide and fullwidth
+ * characters, which include most emoji, occupy 2 cells. Everything else, including control
+ * characters and invalid code points, occupies 1 cell.
+ */
+public object UnicodeWidth {
+	private val stage1 = decodeHex(widthStage1)
+	private val stage2 = decodeHex(widthStage2)
+
+	/** The number of cells occupied by [codePoint]. */
+	public fun of(codePoint: Int): Int {
+		if (codePoint in 0 until 0x80) return 1
+		if (codePoint !in 0 until 0x110000) return 1
+
+		val block = stage1[codePoint ushr widthBlockBits].toInt() and 0xFF
+		val packed = stage2[(block shl (widthBlockBits - 2)) + ((codePoint and 0xFF) ushr 2)].toInt()
+		return (packed ushr ((codePoint and 3) * 2)) and 3
+	}
+
+	/** The number of cells occupied by the code points of [string] from [startIndex] until [endIndex]. */
+	public fun of(string: String, startIndex: Int = 0, endIndex: Int = string.length): Int {
+		if (startIndex < 0 || endIndex > string.length || startIndex > endIndex) {
+			throw IndexOutOfBoundsException(
+				"startIndex=$startIndex, endIndex=$endIndex, length=${string.length}",
+			)
+		}
+		var width = 0
+		var index = startIndex
+		while (index < endIndex) {
+			val char = string[index]
+			if (char.code < 0x80) {
+				width++
+				index++
+				continue
+			}
+			var codePoint = char.code
+			if (char.isHighSurrogate() && index + 1 < endIndex) {
+				val low = string[index + 1]
+				if (low.isLowSurrogate()) {
+					codePoint = 0x10000 + ((char.code - 0xD800) shl 10) + (low.code - 0xDC00)
+					index++
+				}
+			}
+			width += of(codePoint)
+			index++
+		}
+		return width
+	}
+}
+
+private fun decodeHex(hex: String): ByteArray {
+	return ByteArray(hex.length / 2) {
+		(hex[it * 2].digitToInt(16) shl 4 or hex[it * 2 + 1].digitToInt(16)).toByte()
+	}
+}
@@ -0,0 +1,274 @@
+// Generated by update-unicode-width.py from Unicode 14.0.0. Do not edit.
+
+package com.jakewharton.mosaic.terminal
+
+internal const val widthBlockBits: Int = 8
+
+/** The block of packed widths for each run of 256 code points, as hex. */
+internal const val widthStage1: String =
+	"0000000102030405060708090a0b0c0d0e0f101100001213141516171819001a1b1c001d1e1f20210000002223242526" +
+	"272628262626262626262626262626262626262626262626262626262629262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"26262626262626262626262626262626262626262a002b2c2d2e2f302626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262631000000000000000000000000000000000000000000000000" +
+	"00000000000000000026263200333435363738393a3b003c3d3e3f404142434445464748494a4b4c4d4e4f2650515253" +
+	"000000545556262626262626262626570000000058262626262626262626262626262626000059262626262626262626" +
+	"26262626262626262626262626262626262626262626262600005a5b26265c5d26262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"2626262626262626262626265e2626262626262626262626262626262626265f60616263646566670000682626262669" +
+	"6a6b6c262626266d6e6f26267071722673742675767778797a7b7c7d2626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"26262626262626262626262626262626262626262626262626262626262626267e7f2626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626262626" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000800000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000" +
+	"0000000000000000000000000000000000000000000000000000000000000080"
+
+/** Widths of 2 bits each, packed four to a byte starting from the low bits, as hex. */
+internal const val widthStage2: String =
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555555555550000000000000000000000000000000000000000000000000000000055555a55" +
+	"aa5595595555555565555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555555555551500505555555555555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555565555555555555555955655555555555555555555559556020000000000000000000010" +
+	"4110aaaa555555555555956a55a9aaaa0050555500004054555555555555555555551500000000005555555554555555" +
+	"555555555555555555555555555555555555555555050010001404505555555555555525515555555555555500000000" +
+	"00008056555555555555555555555555555555555555555555050000a4aaaaaa55555555555555555555150000559552" +
+	"5555555555051000000101a055555595555555555555019a555595aa5555555555555595a0aa00005555555555555555" +
+	"555505000000000000000000000000004055555555555555555555555555455401005451010055550555555555555555" +
+	"515655696955555555555955995aa55401686991aa6aaa65055a5555555555854256956a69555555555559555996a558" +
+	"812a28a0a2aa5699aa5a55555091aaaa4256556565555555555559555956a554012064a1a9aaaaaa055a5555a5aa0600" +
+	"5256556969555555555559555956a514016869a1aa42aa65055a55555555aaaa4a56955a59a596596aa9955a5555a55a" +
+	"945a59a1a96aaaaaaa5a5555555595aa5454555959555555555559555555a504540908a0aa8295a6055a5555aa6a5555" +
+	"5155555959555555555559555556a514554959a0aa96aa96055a555596aaaaaa50555559595555555555555555551554" +
+	"01585951aa555555055a5555555555555256555555955a5555555555655555a655958a6a05885555aa5a55555aa9aaaa" +
+	"5655555555555555555555555100806a55150040555555aaaaaaaaaaaaaaaaaa965995555555555555665555510000a4" +
+	"559900a05555a555aaaaaaaaaaaaaaaa555555555555505555555555551151555555565555555555555555a902000040" +
+	"0004550100000200000000000000005855455559555595aaaaaaaaaaaaaaaaaa55555555555555555555550104004141" +
+	"55555555555550055455555501545555454155515555555155555555555555555565aaa6555555555555555555555555" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa000000000000000000000000000000000000000000000000" +
+	"0000000000000000000000000000000055555555555555555555555555555555555559a5559559a55555555555555555" +
+	"555559a5555555555555555559a5559559a555555595555555555555555555555555555559a555555555555555555555" +
+	"555555555555950255555555555555a9555555555555a5aa555555555555555555555555555555555555555555a555a5" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555a95555555555555555" +
+	"5555555555555555555555555555a9aa5555555505a4aa6a555555550595aaaa5555555505aaaaaa5555555909aaaaaa" +
+	"5555555555555555555555555510005055450100005555a15555a5aa5555a5aa555515005555a5aa5555555555555555" +
+	"5555555555555555555555555555a9aa5541555555555555555591aa5555555555555555555555555555555555a5aaaa" +
+	"5555555555555595401554aa455501aaa955555555555555555555a555a9aaaa5555555555555555555555aa55555555" +
+	"5555a5aa5555955a5555555555555555555555555515145a555555555555555555555555554500804401005415000028" +
+	"5555a5aa5555a5aa555555a50000000000000080aaaaaaaaaaaaaaaaaaaaaaaa00555555555555555555555555044054" +
+	"455555a95555555555551500005555955055555555555555055010505555555555555555555555555545501150aaaa55" +
+	"55555555555555555555550000056a555555a5565555555555555555555555555555a9aa555555555555555555559556" +
+	"5555aaaa4000000004005451555490aa5555555555555555555555555555555555555555555555555555555555555555" +
+	"55555555555555555555555555555555000000000000000000000000000000005555555555a555a55555555555555555" +
+	"55a555a55555666655555555555555a55555555555555555555555555559555555595555555a5556555555555a595595" +
+	"55551500555555555555054055555555555555555555555500080000a555555555555595555555a95555555555555555" +
+	"a9aaaaaa0000000000000000a8aaaaaa5555555555555555555555555555555555555555555555555555555555555555" +
+	"555555aa55555555555555555555555555555555555555555555555555555555555555555555a5555555695555555555" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555a95696555555" +
+	"55555555555555555595aaaaaaaaaaaa555595aaaaaaaaaa555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555555555555555555555555555555555555555556955555555555a55555555555555555555" +
+	"5555aaaaaa555555555555555555559555555555955555555955a55555555569555a55655556555555556555a5596559" +
+	"5559a55555555555555556555555555555555566959a555555555555555555555555555555a955555555555556555595" +
+	"5555555555555555555555555555555555555555555595565555555555555555555555555659555555555555555a5555" +
+	"555555555565555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555551550aa5655" +
+	"55555555555555555565aaa65555555555555555555555555555aa6aa9aaaa2a555555555595aaaa5595559555955595" +
+	"559555955595559500000000000000005555555555555555555555555555555555555555555555a5aaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaa0aa0aaaaaa6aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa82aaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555aaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555555555555555" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaa5555555555555555555555555555555555555555555555aaaaaaaaaa55555555555555555555551540000050" +
+	"555555555555550555555555555555555555555555555555555555555055aaaa55555555555555555555555555555555" +
+	"5555555555555555555555555555555555555555555555555555555555555555555595aa6556a5aaaaaaaaaa5a555555" +
+	"4545155555555555554155a85555a5aa5555555555555555555555555555aaaa55555555555555555555555555555555" +
+	"55a0aa5a5555a5aa0000000050555515555555555555555555050050555555555515000050aaaa6aaaaaaaaaaaaaaaaa" +
+	"40555555555555555555555515055050555555655555a55a55515555555555955555555555555555555501404181aaaa" +
+	"155555a45555a55555555555555555545555555555555555555555550414540591aaaaaaaaaa6a55555555505585aaaa" +
+	"569556955695aaaa55955595555555555555555555555555555555aa5555555555555555555555555555555555555555" +
+	"5555555555555555555154a15555a5aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaa00000000000000000000000000000000000000005595aaaa6a55aa465555555555955599" +
+	"655955555555555555555555555555555555555555555555555555555555555595aaaaaa6a5555555555555555555555" +
+	"5555555555555555555555555555555555555555555555555555555555555555555555555a5555555555555555555555" +
+	"5555aa6aaaaaaaaaaaaaaaaa5555555500000000aaaaaaaa00000000aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55595555" +
+	"5555555555555555555555555555555555555555555555555555555555555529aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaa5655555555555555555555555555555555555555555555955a555a555a555aa9aaaa5595aaaa02a5" +
+	"55555556555555555595555555559565555555a5555555a5aaaaaaaaaaaaaaaa55555555555555555555555555555555" +
+	"555555555555555555555555555595aa956a55555555555555555555556a555555555555555555555555555555555555" +
+	"55555595555555a9a9aaaaaaaaaaaaaaaaaaaaaa5555555555555555555555a1aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555a9555555555555555555555555a9aaaaaa54555555555555aa" +
+	"555555555555555555aaaa5655555555555595aa5555555555555555550580aa55555555555555655555555555555555" +
+	"55aa555555a5aaaaaaaaaaaaaaaaaaaa5555555555555555555555555555555555555555555555555555555555555555" +
+	"55555555555555a55555a5aa555555555555555555aa555555555555555555aa55555555555555555555aaaa55555555" +
+	"555555555555555555aaaa6a55559555555595559565555565555555655565a9aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"5555555555555555555555555595aaaa5555555555a5aaaa5555aaaaaaaaaaaa556555555555555555555555595595aa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55a5595555555555555555555565a96955555555556555555555555555555555" +
+	"5555555555555595aa6a5555aaaaaaaaaaaaaaaaaaaaaaaa5555555595a56a55555555555555556a555555555555a56a" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555555555555555555555aa55555555555a5555555555555555555555" +
+	"0182aa00555656555555555555a5802a5555a9aa5555a9aa55555555555555555555555555555555aaaaaaaaaaaaaaaa" +
+	"555555555555555555816a555595aaaa55555555555555555555555555a556555555555555a555555555555595aa5555" +
+	"55555555a5aa56a9aaaa5655aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555555555555555" +
+	"5555a9aaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555555595aaaaaa55555555555555555555555595aa5a55" +
+	"55555555555555555500aaaa5555a5aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555555595" +
+	"5555555555555555555525a4a5aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555aaaa55555555" +
+	"550500005455a5aaaaaaaaaa555555550550a5aaaaaaaaaaaaaaaaaa55555555555555aaaaaaaaaa555555555595aaaa" +
+	"51555555555555555555555555550000004055a55a5555555555555514a4aa2a50555555555555555555555515404151" +
+	"85aaaaa2555555555555a9aa5555a5aa405555555555555555150001005855555555aaaa55555555555555551595aaaa" +
+	"5055555555555555555555555505004055550114555555555655555555a9aaaa55555555655555555555551550045585" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55955965555555655555a5aa555555555555555555555515150080aa5555a5aa" +
+	"50565569695555555555595559562554546969a5a96aaa56550a00a800a8aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555555555555555555555555500000544555555555546a5aaaaaaaaaaaaaa" +
+	"555555555555555555555555150044150455aaaa5555a5aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555555505a0551054555555555555a0aaaaaaaaaaaaaaaa" +
+	"5555555555555555555555551500401154a9aaaa5555a5aa555555a9aaaaaaaa5555555555555555555515510010a5aa" +
+	"5555a5aaaaaaaaaaaaaaaaaaaaaaaaaa5555555555559502051000aa555555555595aaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555555555555555555515000041aa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555555555555555555555555555555555555595aaaa6a" +
+	"5595a6555596555555555555556529441595aaaa5555a5aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555a5555555555" +
+	"5555555555000a5554a9aaaaaaaaaaaa010040555555555555555555150014405515aaaa014001555555555555555555" +
+	"555505000040505595aaaaaa555555555555555555555555555555555555a9aa55555955555555555555555500800010" +
+	"55a5aaaa55555555555555a955555555555555550a000000000006000481aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"55956555555555555555555501808a200010aaaa5555a5aa5565595555555555555555956011a9aa5555a5aaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555551554a9aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa9aaaaaa555555555555555555555555a5aaaa6a" +
+	"5555555555555555555555555555555555555555555555555555555555555555555555555555a5aaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555555555555555555555555555555555555555555555559555a9aaaa" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"55aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555555555555555555555" +
+	"55555555555555555555555595aaaaaa5555555555555555555555950000a8aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555555555555555" +
+	"5595aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"5555555555555555555555555555a9aa55555555555555955555a55a5555555555555555555555555555555555555595" +
+	"5555a5aa55555555555555a500a4aaaa5555555555555555555555550040555555a5aaaa55556555655555555555aa56" +
+	"55555555aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"5555555555555555555555555555555555555555555595aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"555555555555555555555555555555555555952a5555555555555555555555555555aa2a40555555aaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaa8aaaaaaaaaaaa555555555555555555555555555555555555555555555555555595aa555555a9" +
+	"5555a9aa5555a54100aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa0000000000000000000000a000000000" +
+	"0080aaaa5555555555555555555555555555555555555555555555555555555555aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"55555555555555555555555555a5aaaa5555555555555555559556555555555555555555555555555515505515000000" +
+	"400100555555555555550550555555555555555555555555555595aaaaaaaaaa55555555555555555555555555555555" +
+	"05a4aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555aaaaaa" +
+	"55555555555555555555555555555555555555555595aaaa555555555555a9aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555555555555555555555555555555555555955555555555555555555" +
+	"55555555555555599a965659555565565556555555555555555555555555555555659556555955595555555555556595" +
+	"55995a555955555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"5555555555555555555555555555555555555555555555555555555555555555555555555555555555a5555555555555" +
+	"555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555" +
+	"555555555555555555555555555555555555555a55555555555555555555555500000000000000000000000000401500" +
+	"00000000000000000000005455515555555455aaaaaa2a0002000000aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"5555555555555595aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa0080000000002800200880aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555555555555555a9004055a5" +
+	"5555a55aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5555555555555585aaaaaaaa" +
+	"5555555555555555555555005555a56aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa559555965555559555555555555555555555555555555555" +
+	"5555555555555555555555555555555555555555555555555555555555555555556955550080aaaaaaaaaaaaaaaaaaaa" +
+	"55555555555555555555555555555555550040aa5555a55aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa56555555" +
+	"55555555555555555555555555a9aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa565555555555555555555555555555a5" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"555655555555555596695655955566aa9a6a665696696666966995559555569955556555555555aa56566555555555aa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaa5aaaaaa5556555555555555555555aa5555555555555555555555555555555555555555" +
+	"5555555555aaaaaa555555955655555556555595565555555555555555a5aaaa55555555555555555555555555555555" +
+	"5555555555555555555555555555555555555565a9aa6a55555555a5aaaaaaaaaaaaaaaaaaaaaaaaaa5a555555555555" +
+	"aaaaaaaaaaaaaaaa565555a9aa9aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa6aaaaaaaaaa555555aaaaaaaaaaaaaaaa" +
+	"aaaa6a95aa555555aaaaaaaa5656aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa6aa6aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa96aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa5a" +
+	"5555956aaaaaaaaaaaaa55555555655555555555556955555556555555555555555555555555555555555555555595aa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555555555555555555555aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aa5a55566aa9aaaa555595aa55aaaaaa5555555555555555555555555555555555555555555555555555555555aaaaaa" +
+	"55555555555555555555555555555555555555555555a9aaaaaaaaaaaaaaaaaa555555aa555555555555555555555555" +
+	"5555aaaa5555a5aa55555555555555555555aaaa55555555555555a5a5aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"555555aaaaaaaaaaaaaaaaaaaaaa6aaaaa9aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa555555555555555555555555555555555555555555aaaaaa555555a5aaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa55555555555555555555555555555555" +
+	"5555555555555555555555555555555555555555955555555555555555555555555595aaaaaaaaaaaaaaaaaa5555a5aa" +
+	"a2aaaaaaaaaaaaaa000000000000000000000000000000000000000000000000aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" +
+	"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa0000000000000000000000000000000000000000000000000000000000000000" +
+	"00000000000000000000000000000000000000000000000000000000aaaaaaaa55555555555555555555555555555555" +
+	"5555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555555a5"
@@ -0,0 +1,149 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertFailure
+import assertk.assertThat
+import assertk.assertions.containsExactly
+import assertk.assertions.isEmpty
+import assertk.assertions.isEqualTo
+import assertk.assertions.isInstanceOf
+import com.jakewharton.mosaic.terminal.CellGrid.CellWords
+import com.jakewharton.mosaic.terminal.CellGrid.ColorLevel16
+import com.jakewharton.mosaic.terminal.CellGrid.ColorLevel256
+import com.jakewharton.mosaic.terminal.CellGrid.ColorLevelNone
+import com.jakewharton.mosaic.terminal.CellGrid.ColorLevelTruecolor
+import com.jakewharton.mosaic.terminal.CellGrid.WideContinuation
+import kotlin.test.Test
+
+class CellGridTest {
+	private val width = 10
+	private val height = 3
+	private val previous = IntArray(width * height * CellWords)
+	private val next = IntArray(width * height * CellWords)
+	private val runs = IntArray(CellGrid.runsSize(width, height))
+
+	private fun diff(mergeGap: Int = 0): List<String> {
+		val count = CellGrid.diff(previous, next, width, height, mergeGap, runs)
+		return List(count) { "${runs[it * 3]}:${runs[it * 3 + 1]}-${runs[it * 3 + 2]}" }
+	}
+
+	private fun change(row: Int, column: Int, word: Int = 0) {
+		next[(row * width + column) * CellWords + word]++
+	}
+
+	@Test fun identical() {
+		assertThat(diff()).isEmpty()
+	}
+
+	@Test fun singleCell() {
+		change(1, 4)
+		assertThat(diff()).containsExactly("1:4-5")
+	}
+
+	@Test fun everyWordCompared() {
+		change(0, 0, word = 0)
+		change(0, 2, word = 1)
+		change(0, 4, word = 2)
+		change(0, 6, word = 3)
+		assertThat(diff()).containsExactly("0:0-1", "0:2-3", "0:4-5", "0:6-7")
+	}
+
+	@Test fun adjacentCellsFormOneRun() {
+		change(2, 7)
+		change(2, 8)
+		change(2, 9)
+		assertThat(diff()).containsExactly("2:7-10")
+	}
+
+	@Test fun gapsMerged() {
+		change(0, 0)
+		change(0, 3)
+		change(0, 9)
+		assertThat(diff(mergeGap = 2)).containsExactly("0:0-4", "0:9-10")
+		assertThat(diff(mergeGap = 5)).containsExactly("0:0-10")
+	}
+
+	@Test fun gapsNotMergedAcrossRows() {
+		change(0, 9)
+		change(1, 0)
+		assertThat(diff(mergeGap = 100)).containsExactly("0:9-10", "1:0-1")
+	}
+
+	@Test fun mismatchedSizesThrow() {
+		assertFailure {
+			CellGrid.diff(previous, IntArray(4), width, height, 0, runs)
+		}.isInstanceOf<IllegalArgumentException>()
+		assertFailure {
+			CellGrid.diff(previous, next, width, height, 0, IntArray(1))
+		}.isInstanceOf<IllegalArgumentException>()
+	}
+
+	private fun encode(colorLevel: Int, vararg cells: IntArray): String {
+		val packed = cells.reduce(IntArray::plus)
+		val output = ByteArray(CellGrid.encodedRowCapacity(cells.size))
+		val length = CellGrid.encodeRow(packed, 0, cells.size, colorLevel, output, 0)
+		return output.decodeToString(0, length)
+	}
+
+	private fun cell(
+		codePoint: Int,
+		foreground: Int = Default,
+		background: Int = Default,
+		style: Int = Empty,
+	) = intArrayOf(codePoint, foreground, background, style)
+
+	@Test fun encodePlain() {
+		val encoded = encode(ColorLevelTruecolor, cell('a'.code), cell('é'.code), cell(0x1F600))
+		assertThat(encoded).isEqualTo("aé\uD83D\uDE00")
+	}
+
+	@Test fun encodeTruecolor() {
+		val encoded = encode(
+			ColorLevelTruecolor,
+			cell('a'.code, foreground = 0xFF0000),
+			cell('b'.code, foreground = 0xFF0000),
+			cell('c'.code, background = 0x102030),
+		)
+		assertThat(encoded).isEqualTo("\u001B[38;2;255;0;0mab\u001B[39;48;2;16;32;48mc\u001B[0m")
+	}
+
+	@Test fun encode256() {
+		val encoded = encode(ColorLevel256, cell('a'.code, foreground = 0xFF0000, background = 0x808080))
+		assertThat(encoded).isEqualTo("\u001B[38;5;196;48;5;244ma\u001B[0m")
+	}
+
+	@Test fun encode16() {
+		val encoded = encode(ColorLevel16, cell('a'.code, foreground = 0xFF0000, background = 0x000080))
+		assertThat(encoded).isEqualTo("\u001B[91;44ma\u001B[0m")
+	}
+
+	@Test fun encodeNoneOmitsAttributes() {
+		val encoded = encode(ColorLevelNone, cell('a'.code, foreground = 0xFF0000), cell('b'.code))
+		assertThat(encoded).isEqualTo("ab")
+	}
+
+	@Test fun encodeStyles() {
+		val boldUnderline = 8 or 2
+		val encoded = encode(ColorLevelTruecolor, cell('a'.code, style = boldUnderline), cell('b'.code))
+		assertThat(encoded).isEqualTo("\u001B[1;4ma\u001B[22;24mb")
+	}
+
+	@Test fun encodeWideContinuationWritesNothing() {
+		val encoded = encode(ColorLevelTruecolor, cell(0x4E2D), cell(WideContinuation), cell('a'.code))
+		assertThat(encoded).isEqualTo("中a")
+	}
+
+	@Test fun encodeOutOfBoundsThrows() {
+		val cells = IntArray(2 * CellWords)
+		assertFailure {
+			CellGrid.encodeRow(cells, 1, 2, ColorLevelNone, ByteArray(1024), 0)
+		}.isInstanceOf<IndexOutOfBoundsException>()
+		assertFailure {
+			CellGrid.encodeRow(cells, 0, 2, ColorLevelNone, ByteArray(4), 0)
+		}.isInstanceOf<IndexOutOfBoundsException>()
+	}
+
+	private companion object {
+		const val Default = Int.MIN_VALUE
+		const val Empty = 1
+	}
+}
@@ -0,0 +1,73 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertThat
+import assertk.assertions.containsExactly
+import assertk.assertions.containsExactlyInAnyOrder
+import assertk.assertions.isGreaterThan
+import com.jakewharton.mosaic.terminal.EventLoopEvent.Companion.TypeInterrupt
+import com.jakewharton.mosaic.terminal.EventLoopEvent.Companion.TypeStdin
+import com.jakewharton.mosaic.terminal.EventLoopEvent.Companion.TypeTimeout
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.time.Duration.Companion.milliseconds
+import kotlin.time.measureTime
+
+class EventLoopTest {
+	private val writer = Tty.stdinWriter()
+	private val loop = writer.eventLoop()
+	private val events = LongArray(8)
+
+	@AfterTest fun after() {
+		loop.close()
+		writer.reader.close()
+		writer.close()
+	}
+
+	private fun awaitTypes(): List<Int> {
+		val count = loop.await(events)
+		return List(count) { EventLoopEvent(events[it]).type }
+	}
+
+	@Test fun stdinAndInterruptInOneWakeup() {
+		writer.write("hello".encodeToByteArray())
+		loop.interrupt()
+		loop.interrupt()
+		assertThat(awaitTypes()).containsExactly(TypeStdin, TypeInterrupt)
+
+		// Stdin remains readable until read. The interrupts were coalesced and consumed.
+		assertThat(awaitTypes()).containsExactly(TypeStdin)
+	}
+
+	@Test fun timeout() {
+		loop.setTimeout(100.milliseconds.inWholeNanoseconds)
+		val types: List<Int>
+		val took = measureTime {
+			types = awaitTypes()
+		}
+		assertThat(types).containsExactly(TypeTimeout)
+		assertThat(took).isGreaterThan(99.milliseconds)
+	}
+
+	@Test fun timeoutIsReplaced() {
+		loop.setTimeout(0)
+		loop.setTimeout(-1)
+		loop.setTimeout(50.milliseconds.inWholeNanoseconds)
+		val took = measureTime {
+			assertThat(awaitTypes()).containsExactly(TypeTimeout)
+		}
+		assertThat(took).isGreaterThan(49.milliseconds)
+	}
+
+	@Test fun eventsWhichDoNotFitAreReportedNext() {
+		writer.write("hello".encodeToByteArray())
+		loop.interrupt()
+		val one = LongArray(1)
+		val types = buildList {
+			repeat(2) {
+				assertThat(loop.await(one)).isGreaterThan(0)
+				add(EventLoopEvent(one[0]).type)
+			}
+		}
+		assertThat(types).containsExactlyInAnyOrder(TypeStdin, TypeInterrupt)
+	}
+}
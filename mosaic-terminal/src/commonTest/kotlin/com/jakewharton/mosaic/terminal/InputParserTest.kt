@@ -0,0 +1,133 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertThat
+import assertk.assertions.containsExactly
+import assertk.assertions.isEmpty
+import assertk.assertions.isFalse
+import assertk.assertions.isTrue
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyCodePoint
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyDelete
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyEnter
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyEscape
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyF1
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyPaste
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyRight
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyTab
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.KeyUp
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.ModifierCtrl
+import com.jakewharton.mosaic.terminal.InputEvent.Companion.ModifierShift
+import kotlin.test.AfterTest
+import kotlin.test.Test
+
+class InputParserTest {
+	private val parser = Tty.inputParser()
+	private val events = LongArray(100)
+
+	@AfterTest fun after() {
+		parser.close()
+	}
+
+	private fun parse(input: String): List<String> {
+		val bytes = input.encodeToByteArray()
+		val count = parser.parse(bytes, 0, bytes.size, events)
+		var pasteOffset = 0
+		return events.take(count).map { value ->
+			val event = InputEvent(value)
+			if (event.key == KeyPaste) {
+				val text = parser.pasteText(pasteOffset, event.codePoint)
+				pasteOffset += event.codePoint
+				"Paste($text)"
+			} else {
+				value.describe()
+			}
+		}
+	}
+
+	private fun flush(): List<String> {
+		val count = parser.flush(events)
+		return events.take(count).map { it.describe() }
+	}
+
+	private fun Long.describe(): String {
+		val event = InputEvent(this)
+		return buildString {
+			if (event.ctrl) append("Ctrl+")
+			if (event.alt) append("Alt+")
+			if (event.shift) append("Shift+")
+			when (event.key) {
+				KeyCodePoint -> append("'").append(Char(event.codePoint)).append("'")
+				else -> append("Key(").append(event.key).append(")")
+			}
+		}
+	}
+
+	private fun key(key: Int, modifiers: Int = 0): String {
+		return InputEvent(key.toLong() or (modifiers.toLong() shl 16)).value.describe()
+	}
+
+	@Test fun printable() {
+		assertThat(parse("hi")).containsExactly("'h'", "'i'")
+	}
+
+	@Test fun controls() {
+		assertThat(parse("\r\t\u0003")).containsExactly(
+			key(KeyEnter),
+			key(KeyTab),
+			"Ctrl+'c'",
+		)
+	}
+
+	@Test fun csiAndSs3() {
+		assertThat(parse("\u001B[A\u001B[1;5C\u001BOP\u001B[3~\u001B[Z")).containsExactly(
+			key(KeyUp),
+			key(KeyRight, ModifierCtrl),
+			key(KeyF1),
+			key(KeyDelete),
+			key(KeyTab, ModifierShift),
+		)
+	}
+
+	@Test fun altPrefix() {
+		assertThat(parse("\u001Bx")).containsExactly("Alt+'x'")
+	}
+
+	@Test fun utf8() {
+		assertThat(parse("é€")).containsExactly("'é'", "'€'")
+	}
+
+	@Test fun sequenceSplitAcrossCalls() {
+		assertThat(parse("\u001B[1;")).isEmpty()
+		assertThat(parser.hasPending).isTrue()
+		assertThat(parse("2A")).containsExactly(key(KeyUp, ModifierShift))
+		assertThat(parser.hasPending).isFalse()
+	}
+
+	@Test fun loneEscapeResolvedByFlush() {
+		assertThat(parse("\u001B")).isEmpty()
+		assertThat(parser.hasPending).isTrue()
+		assertThat(flush()).containsExactly(key(KeyEscape))
+		assertThat(parser.hasPending).isFalse()
+	}
+
+	@Test fun bracketedPaste() {
+		assertThat(parse("a\u001B[200~x\u001B[Ay\u001B[201~b\u001B[200~é\u001B[201~")).containsExactly(
+			"'a'",
+			"Paste(x\u001B[Ay)",
+			"'b'",
+			"Paste(é)",
+		)
+	}
+
+	@Test fun bracketedPasteSplitAcrossCalls() {
+		assertThat(parse("\u001B[200~hello ")).isEmpty()
+		assertThat(parser.hasPending).isFalse()
+		assertThat(parse("world\u001B[20")).isEmpty()
+		assertThat(parse("1~")).containsExactly("Paste(hello world)")
+	}
+
+	@Test fun emptyBracketedPaste() {
+		assertThat(parse("\u001B[200~\u001B[201~")).containsExactly("Paste()")
+		assertThat(parse("\u001B[200~")).isEmpty()
+		assertThat(parse("\u001B[201~")).containsExactly("Paste()")
+	}
+}
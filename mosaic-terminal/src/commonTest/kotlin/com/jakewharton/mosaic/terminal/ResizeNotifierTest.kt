@@ -0,0 +1,52 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertThat
+import assertk.assertions.isFalse
+import assertk.assertions.isNull
+import kotlin.test.AfterTest
+import kotlin.test.Test
+import kotlin.time.Duration.Companion.milliseconds
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeoutOrNull
+
+class ResizeNotifierTest {
+	private val notifier = Tty.resizeNotifier()
+
+	@AfterTest fun after() {
+		notifier.close()
+	}
+
+	@Test fun interruptWakesAwaitBlocking() {
+		notifier.interrupt()
+		assertThat(notifier.awaitResizeBlocking()).isFalse()
+	}
+
+	@Test fun interruptWakesAwait() = runBlocking {
+		notifier.interrupt()
+		assertThat(notifier.awaitResize()).isFalse()
+	}
+
+	@Test fun awaitIsCancellable() = runBlocking {
+		val resized = withTimeoutOrNull(100.milliseconds) {
+			notifier.awaitResize()
+		}
+		assertThat(resized).isNull()
+
+		// The notifier is still usable after a canceled wait.
+		notifier.interrupt()
+		assertThat(notifier.awaitResize()).isFalse()
+	}
+
+	@Test fun multipleNotifiersAtATime() {
+		val other = Tty.resizeNotifier()
+		try {
+			other.interrupt()
+			assertThat(other.awaitResizeBlocking()).isFalse()
+
+			notifier.interrupt()
+			assertThat(notifier.awaitResizeBlocking()).isFalse()
+		} finally {
+			other.close()
+		}
+	}
+}
@@ -1,13 +1,26 @@
 package com.jakewharton.mosaic.terminal
 
 import assertk.assertThat
+import assertk.assertions.containsOnly
 import assertk.assertions.isEqualTo
 import assertk.assertions.isGreaterThan
+import assertk.assertions.isNull
 import assertk.assertions.isZero
 import kotlin.test.AfterTest
 import kotlin.test.Test
+import kotlin.test.fail
+import kotlin.time.Duration.Companion.microseconds
 import kotlin.time.Duration.Companion.milliseconds
 import kotlin.time.measureTime
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.CoroutineStart
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.cancelAndJoin
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeoutOrNull
 
 class StdinReaderTest {
 	private val writer = Tty.stdinWriter()
@@ -34,4 +47,148 @@ class StdinReaderTest {
 		assertThat(read).isZero()
 		assertThat(took).isGreaterThan(100.milliseconds)
 	}
+
+	@Test fun readWithTimeoutLongerThanOneSecond() {
+		val read: Int
+		val took = measureTime {
+			read = reader.readWithTimeout(ByteArray(10), 0, 10, 1_500)
+		}
+		assertThat(read).isZero()
+		assertThat(took).isGreaterThan(1_500.milliseconds)
+	}
+
+	@Test fun readWithTimeoutNanosReturnsZeroOnTimeout() {
+		val read: Int
+		val took = measureTime {
+			read = reader.readWithTimeoutNanos(ByteArray(10), 0, 10, 2_500_000)
+		}
+		assertThat(read).isZero()
+		assertThat(took).isGreaterThan(2_500.microseconds)
+	}
+
+	@Test fun earlierTimeoutDoesNotEndLaterRead() {
+		writer.write("hello".encodeToByteArray())
+		assertThat(reader.readWithTimeout(ByteArray(10), 0, 10, 50)).isEqualTo(5)
+
+		// The deadline of the first read passes while this one waits.
+		val read: Int
+		val took = measureTime {
+			read = reader.readWithTimeout(ByteArray(10), 0, 10, 200)
+		}
+		assertThat(read).isZero()
+		assertThat(took).isGreaterThan(200.milliseconds)
+	}
+
+	@Test fun interruptIsConsumedByOneRead() {
+		reader.interrupt()
+		reader.interrupt()
+		assertThat(reader.read(ByteArray(10), 0, 10)).isZero()
+
+		// Without draining the interrupt this would return immediately.
+		val read: Int
+		val took = measureTime {
+			read = reader.readWithTimeout(ByteArray(10), 0, 10, 100)
+		}
+		assertThat(read).isZero()
+		assertThat(took).isGreaterThan(100.milliseconds)
+	}
+
+	@Test fun dataIsReadBeforePendingInterrupt() {
+		reader.interrupt()
+		writer.write("hello".encodeToByteArray())
+
+		val buffer = ByteArray(100)
+		val read = reader.read(buffer, 0, buffer.size)
+		assertThat(buffer.decodeToString(endIndex = read)).isEqualTo("hello")
+		assertThat(reader.read(buffer, 0, buffer.size)).isZero()
+	}
+
+	@Test fun awaitReadSuspendsUntilDataIsWritten() = runBlocking {
+		launch {
+			delay(50.milliseconds)
+			writer.write("hello".encodeToByteArray())
+		}
+
+		val buffer = ByteArray(100)
+		val read = reader.awaitRead(buffer, 0, buffer.size)
+		assertThat(buffer.decodeToString(endIndex = read)).isEqualTo("hello")
+	}
+
+	@Test fun awaitReadReturnsZeroOnInterrupt() = runBlocking {
+		launch {
+			delay(50.milliseconds)
+			reader.interrupt()
+		}
+		assertThat(reader.awaitRead(ByteArray(10), 0, 10)).isZero()
+	}
+
+	@Test fun awaitReadIsCancellable() = runBlocking {
+		val cancelled = withTimeoutOrNull(50.milliseconds) {
+			reader.awaitRead(ByteArray(10), 0, 10)
+		}
+		assertThat(cancelled).isNull()
+
+		// The cancelled read neither consumed input nor left the reader waiting.
+		writer.write("hello".encodeToByteArray())
+		val buffer = ByteArray(100)
+		val read = reader.awaitRead(buffer, 0, buffer.size)
+		assertThat(buffer.decodeToString(endIndex = read)).isEqualTo("hello")
+	}
+
+	@Test fun awaitReadCancelledWhileDataArrivesKeepsData() = runBlocking {
+		assertCancelledReadKeepsData { buffer ->
+			reader.awaitRead(buffer, 0, buffer.size)
+		}
+	}
+
+	@Test fun awaitReadWithoutPollingCancelledWhileDataArrivesKeepsData() = runBlocking {
+		// The path taken on Windows and with io_uring, where the read blocks a thread.
+		assertCancelledReadKeepsData { buffer ->
+			reader.pollAndRead(buffer, 0, buffer.size, packedFds = -1L)
+		}
+	}
+
+	private suspend fun CoroutineScope.assertCancelledReadKeepsData(read: suspend (ByteArray) -> Int) {
+		val buffer = ByteArray(100)
+		repeat(10) {
+			writer.write("hello".encodeToByteArray())
+			val job = launch(start = CoroutineStart.UNDISPATCHED) {
+				read(buffer)
+				fail("Read was not cancelled")
+			}
+			job.cancelAndJoin()
+
+			// Whether or not the cancelled read took the data, the next read returns it.
+			val hello = read(buffer)
+			assertThat(buffer.decodeToString(endIndex = hello)).isEqualTo("hello")
+
+			// No interrupt was left behind to end the next read early.
+			writer.write("world".encodeToByteArray())
+			val world = read(buffer)
+			assertThat(buffer.decodeToString(endIndex = world)).isEqualTo("world")
+		}
+	}
+
+	@Test fun awaitReadWithManyReaders() = runBlocking {
+		val writers = List(20) { Tty.stdinWriter() }
+		try {
+			val reads = writers.map { writer ->
+				async {
+					val buffer = ByteArray(10)
+					val read = writer.reader.awaitRead(buffer, 0, buffer.size)
+					buffer.decodeToString(endIndex = read)
+				}
+			}
+			delay(50.milliseconds)
+			for (writer in writers) {
+				writer.write("hi".encodeToByteArray())
+			}
+			assertThat(reads.awaitAll()).containsOnly("hi")
+		} finally {
+			for (writer in writers) {
+				writer.reader.close()
+				writer.close()
+			}
+		}
+	}
 }
@@ -0,0 +1,56 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertFailure
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import assertk.assertions.isInstanceOf
+import kotlin.test.Test
+
+class UnicodeWidthTest {
+	@Test fun ascii() {
+		assertThat(UnicodeWidth.of('a'.code)).isEqualTo(1)
+		assertThat(UnicodeWidth.of('\n'.code)).isEqualTo(1)
+	}
+
+	@Test fun wide() {
+		assertThat(UnicodeWidth.of(0x4E2D)).isEqualTo(2) // 中
+		assertThat(UnicodeWidth.of(0xAC00)).isEqualTo(2) // 가
+		assertThat(UnicodeWidth.of(0xFF21)).isEqualTo(2) // Ａ
+		assertThat(UnicodeWidth.of(0x1F600)).isEqualTo(2) // 😀
+	}
+
+	@Test fun zeroWidth() {
+		assertThat(UnicodeWidth.of(0x0301)).isEqualTo(0) // Combining acute accent
+		assertThat(UnicodeWidth.of(0x200B)).isEqualTo(0) // Zero width space
+		assertThat(UnicodeWidth.of(0xFE0F)).isEqualTo(0) // Variation selector-16
+	}
+
+	@Test fun narrow() {
+		assertThat(UnicodeWidth.of(0x00E9)).isEqualTo(1) // é
+		assertThat(UnicodeWidth.of(0x00AD)).isEqualTo(1) // Soft hyphen
+		assertThat(UnicodeWidth.of(0x20AC)).isEqualTo(1) // €
+	}
+
+	@Test fun invalid() {
+		assertThat(UnicodeWidth.of(-5)).isEqualTo(1)
+		assertThat(UnicodeWidth.of(0x110000)).isEqualTo(1)
+	}
+
+	@Test fun string() {
+		assertThat(UnicodeWidth.of("")).isEqualTo(0)
+		assertThat(UnicodeWidth.of("hello")).isEqualTo(5)
+		assertThat(UnicodeWidth.of("a中😀é")).isEqualTo(6)
+		assertThat(UnicodeWidth.of("a中😀e", 1, 4)).isEqualTo(4)
+	}
+
+	@Test fun stringUnpairedSurrogate() {
+		assertThat(UnicodeWidth.of("\uD83D")).isEqualTo(1)
+		// Ending between the halves of a surrogate pair leaves the high surrogate unpaired.
+		assertThat(UnicodeWidth.of("😀", 0, 1)).isEqualTo(1)
+	}
+
+	@Test fun stringOutOfBounds() {
+		assertFailure { UnicodeWidth.of("abc", 2, 4) }.isInstanceOf<IndexOutOfBoundsException>()
+		assertFailure { UnicodeWidth.of("abc", 2, 1) }.isInstanceOf<IndexOutOfBoundsException>()
+	}
+}
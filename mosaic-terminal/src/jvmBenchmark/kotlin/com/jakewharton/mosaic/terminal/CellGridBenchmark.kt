@@ -0,0 +1,70 @@
+package com.jakewharton.mosaic.terminal
+
+import com.jakewharton.mosaic.terminal.CellGrid.CellWords
+import kotlinx.benchmark.Benchmark
+import kotlinx.benchmark.Param
+import kotlinx.benchmark.Scope
+import kotlinx.benchmark.Setup
+import kotlinx.benchmark.State
+import org.openjdk.jmh.annotations.AuxCounters
+import org.openjdk.jmh.annotations.Level
+import org.openjdk.jmh.annotations.Setup as JmhSetup
+
+/**
+ * Measures [CellGrid.encodeRow] throughput for rows of [width] cells whose colors change every
+ * [runLength] cells. The `bytes` counter reports the encoded output rate in bytes per second.
+ */
+@State(Scope.Benchmark)
+public class CellGridBenchmark {
+	@Param("truecolor", "256", "16")
+	public var colors: String = ""
+
+	@Param("200")
+	public var width: Int = 0
+
+	@Param("1", "8")
+	public var runLength: Int = 0
+
+	private var colorLevel = 0
+	private lateinit var cells: IntArray
+	private lateinit var output: ByteArray
+
+	@Setup
+	public fun setup() {
+		colorLevel = when (colors) {
+			"truecolor" -> CellGrid.ColorLevelTruecolor
+			"256" -> CellGrid.ColorLevel256
+			"16" -> CellGrid.ColorLevel16
+			else -> throw IllegalArgumentException(colors)
+		}
+		cells = IntArray(width * CellWords)
+		for (column in 0 until width) {
+			val run = column / runLength
+			val index = column * CellWords
+			cells[index] = 'a'.code + column % 26
+			cells[index + 1] = (run * 0x0F1D2B) and 0xFFFFFF
+			cells[index + 2] = (run * 0x2B1D0F).inv() and 0xFFFFFF
+			cells[index + 3] = if (run % 2 == 0) 1 else 8
+		}
+		output = ByteArray(CellGrid.encodedRowCapacity(width))
+	}
+
+	@Benchmark
+	public fun encodeRow(counter: ByteCounter): Int {
+		val length = CellGrid.encodeRow(cells, 0, width, colorLevel, output, 0)
+		counter.bytes += length
+		return length
+	}
+
+	@AuxCounters(AuxCounters.Type.OPERATIONS)
+	@State(Scope.Thread)
+	public class ByteCounter {
+		@JvmField
+		public var bytes: Long = 0
+
+		@JmhSetup(Level.Iteration)
+		public fun reset() {
+			bytes = 0
+		}
+	}
+}
@@ -0,0 +1,55 @@
+package com.jakewharton.mosaic.terminal
+
+import java.nio.ByteBuffer
+import kotlinx.benchmark.Benchmark
+import kotlinx.benchmark.Param
+import kotlinx.benchmark.Scope
+import kotlinx.benchmark.Setup
+import kotlinx.benchmark.State
+import kotlinx.benchmark.TearDown
+
+/**
+ * Compares reading into a [ByteArray] against reading into a direct [ByteBuffer].
+ *
+ * Each read only receives a small payload, as is typical for keyboard input, so the difference
+ * is the cost of accessing a buffer of [bufferSize] from native code.
+ */
+@State(Scope.Benchmark)
+public class StdinReaderBenchmark {
+	@Param("16", "4096", "65536")
+	public var bufferSize: Int = 0
+
+	private val payload = ByteArray(16) { it.toByte() }
+
+	private lateinit var writer: StdinWriter
+	private lateinit var reader: StdinReader
+	private lateinit var array: ByteArray
+	private lateinit var buffer: ByteBuffer
+
+	@Setup
+	public fun setup() {
+		writer = Tty.stdinWriter()
+		reader = writer.reader
+		array = ByteArray(bufferSize)
+		buffer = ByteBuffer.allocateDirect(bufferSize)
+	}
+
+	@TearDown
+	public fun tearDown() {
+		reader.close()
+		writer.close()
+	}
+
+	@Benchmark
+	public fun byteArray(): Int {
+		writer.write(payload)
+		return reader.read(array, 0, array.size)
+	}
+
+	@Benchmark
+	public fun directByteBuffer(): Int {
+		writer.write(payload)
+		buffer.clear()
+		return reader.read(buffer)
+	}
+}
@@ -89,16 +89,16 @@ Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderReadWithTimeout(
 	jbyteArray buffer,
 	jint offset,
 	jint length,
-	jint timeoutMillis
+	jlong timeoutNanos
 ) {
 	jbyte *nativeBuffer = (*env)->GetByteArrayElements(env, buffer, NULL);
 	jbyte *nativeBufferAtOffset = nativeBuffer + offset;
 
-	stdinRead read = stdinReader_readWithTimeout(
+	stdinRead read = stdinReader_readWithTimeoutNanos(
 		(stdinReader *) ptr,
 		nativeBufferAtOffset,
 		length,
-		timeoutMillis
+		timeoutNanos
 	);
 
 	(*env)->ReleaseByteArrayElements(env, buffer, nativeBuffer, 0);
@@ -113,11 +113,78 @@ Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderReadWithTimeout(
 	return -1;
 }
 
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderReadBuffer(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jobject buffer,
+	jint offset,
+	jint length
+) {
+	// Direct buffers expose their native memory so there is nothing to copy or release.
+	jbyte *nativeBuffer = (*env)->GetDirectBufferAddress(env, buffer);
+	jbyte *nativeBufferAtOffset = nativeBuffer + offset;
+
+	stdinRead read = stdinReader_read((stdinReader *) ptr, nativeBufferAtOffset, length);
+
+	if (likely(!read.error)) {
+		return read.count;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM. Return -1 (EOF)
+	// and should cause the program to try and exit cleanly. 0 is a valid return value.
+	throwIse(env, read.error, "Unable to read stdin");
+	return -1;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderReadBufferWithTimeout(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jobject buffer,
+	jint offset,
+	jint length,
+	jlong timeoutNanos
+) {
+	// Direct buffers expose their native memory so there is nothing to copy or release.
+	jbyte *nativeBuffer = (*env)->GetDirectBufferAddress(env, buffer);
+	jbyte *nativeBufferAtOffset = nativeBuffer + offset;
+
+	stdinRead read = stdinReader_readWithTimeoutNanos(
+		(stdinReader *) ptr,
+		nativeBufferAtOffset,
+		length,
+		timeoutNanos
+	);
+
+	if (likely(!read.error)) {
+		return read.count;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM. Return -1 (EOF)
+	// and should cause the program to try and exit cleanly. 0 is a valid return value.
+	throwIse(env, read.error, "Unable to read stdin");
+	return -1;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderInterrupt(JNIEnv *env, jclass type, jlong ptr) {
 	return stdinReader_interrupt((stdinReader *) ptr);
 }
 
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderFds(JNIEnv *env, jclass type, jlong ptr) {
+	int stdinFd;
+	int interruptFd;
+	if (unlikely(stdinReader_fds((stdinReader *) ptr, &stdinFd, &interruptFd) != 0)) {
+		// Not supported. Callers fall back to a blocking read.
+		return -1;
+	}
+	return ((jlong) stdinFd << 32) | (jlong) (unsigned int) interruptFd;
+}
+
 JNIEXPORT jint JNICALL
 Java_com_jakewharton_mosaic_terminal_Tty_stdinReaderFree(JNIEnv *env, jclass type, jlong ptr) {
 	return stdinReader_free((stdinReader *) ptr);
@@ -165,3 +232,344 @@ JNIEXPORT jint JNICALL
 Java_com_jakewharton_mosaic_terminal_Tty_stdinWriterFree(JNIEnv *env, jclass type, jlong ptr) {
 	return stdinWriter_free((stdinWriter *) ptr);
 }
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdoutWriterInit(JNIEnv *env, jclass type) {
+	stdoutWriterResult result = stdoutWriter_init();
+	if (likely(!result.error)) {
+		return (jlong) result.writer;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM which
+	// will occur from returning 0 (which is otherwise ignored if the throw succeeds).
+	throwIse(env, result.error, "Unable to create stdout writer");
+	return 0;
+}
+
+JNIEXPORT jobject JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdoutWriterBuffer(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jint capacity
+) {
+	char *buffer = stdoutWriter_buffer((stdoutWriter *) ptr, capacity);
+	if (unlikely(buffer == NULL)) {
+		// Returning null will trigger OOM.
+		return NULL;
+	}
+	return (*env)->NewDirectByteBuffer(env, buffer, capacity);
+}
+
+JNIEXPORT void JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdoutWriterWrite(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jint count
+) {
+	platformError error = stdoutWriter_write((stdoutWriter *) ptr, count);
+	if (unlikely(error)) {
+		// This throw can fail, but the only condition that should cause that is OOM. Oh well.
+		throwIse(env, error, "Unable to write stdout");
+	}
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdoutWriterFree(JNIEnv *env, jclass type, jlong ptr) {
+	return stdoutWriter_free((stdoutWriter *) ptr);
+}
+
+static jlong packTerminalSize(terminalSize size) {
+	return ((jlong) size.columns << 32) | (jlong) (unsigned int) size.rows;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_terminalSize(JNIEnv *env, jclass type) {
+	terminalSize size = getTerminalSize();
+	// Not being attached to a terminal is not exceptional. Report an unknown size of 0x0.
+	return likely(!size.error) ? packTerminalSize(size) : 0;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_resizeNotifierInit(JNIEnv *env, jclass type) {
+	resizeNotifierResult result = resizeNotifier_init();
+	if (likely(!result.error)) {
+		return (jlong) result.notifier;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM which
+	// will occur from returning 0 (which is otherwise ignored if the throw succeeds).
+	throwIse(env, result.error, "Unable to create resize notifier");
+	return 0;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_resizeNotifierAwait(JNIEnv *env, jclass type, jlong ptr) {
+	terminalSize size = resizeNotifier_await((resizeNotifier *) ptr);
+	if (unlikely(size.error)) {
+		throwIse(env, size.error, "Unable to await resize");
+		return -1;
+	}
+	return size.interrupted ? -1 : packTerminalSize(size);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_resizeNotifierFds(JNIEnv *env, jclass type, jlong ptr) {
+	int signalFd;
+	int interruptFd;
+	if (unlikely(resizeNotifier_fds((resizeNotifier *) ptr, &signalFd, &interruptFd) != 0)) {
+		// Not supported. Callers fall back to a blocking wait.
+		return -1;
+	}
+	return ((jlong) signalFd << 32) | (jlong) (unsigned int) interruptFd;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_resizeNotifierInterrupt(JNIEnv *env, jclass type, jlong ptr) {
+	return resizeNotifier_interrupt((resizeNotifier *) ptr);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_resizeNotifierFree(JNIEnv *env, jclass type, jlong ptr) {
+	return resizeNotifier_free((resizeNotifier *) ptr);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopInit(JNIEnv *env, jclass type, jboolean watchResize) {
+	eventLoopResult result = eventLoop_init(watchResize);
+	if (likely(!result.error)) {
+		return (jlong) result.loop;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM which
+	// will occur from returning 0 (which is otherwise ignored if the throw succeeds).
+	throwIse(env, result.error, "Unable to create event loop");
+	return 0;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_stdinWriterEventLoop(JNIEnv *env, jclass type, jlong ptr) {
+	eventLoopResult result = stdinWriter_eventLoop((stdinWriter *) ptr);
+	if (likely(!result.error)) {
+		return (jlong) result.loop;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM which
+	// will occur from returning 0 (which is otherwise ignored if the throw succeeds).
+	throwIse(env, result.error, "Unable to create event loop");
+	return 0;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopInitWithoutStdin(JNIEnv *env, jclass type) {
+	eventLoopResult result = eventLoop_initWithoutStdin();
+	if (likely(!result.error)) {
+		return (jlong) result.loop;
+	}
+
+	// This throw can fail, but the only condition that should cause that is OOM which
+	// will occur from returning 0 (which is otherwise ignored if the throw succeeds).
+	throwIse(env, result.error, "Unable to create event loop");
+	return 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopAddFd(JNIEnv *env, jclass type, jlong ptr, jint fd) {
+	return eventLoop_addFd((eventLoop *) ptr, fd);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopRemoveFd(JNIEnv *env, jclass type, jlong ptr, jint fd) {
+	return eventLoop_removeFd((eventLoop *) ptr, fd);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopSetTimeout(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jlong timeoutNanos
+) {
+	return eventLoop_setTimeout((eventLoop *) ptr, timeoutNanos);
+}
+
+#define maxJniLoopEvents 64
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopWait(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jlongArray events
+) {
+	// Waiting blocks, which critical array access must not, so events are staged on the stack.
+	eventLoopEvent nativeEvents[maxJniLoopEvents];
+	jsize capacity = (*env)->GetArrayLength(env, events);
+	if (capacity > maxJniLoopEvents) {
+		capacity = maxJniLoopEvents;
+	}
+
+	eventLoopWait result = eventLoop_wait((eventLoop *) ptr, nativeEvents, capacity);
+	if (unlikely(result.error)) {
+		// This throw can fail, but the only condition that should cause that is OOM. Oh well.
+		throwIse(env, result.error, "Unable to wait for events");
+		return 0;
+	}
+
+	jlong packed[maxJniLoopEvents];
+	for (int i = 0; i < result.count; i++) {
+		packed[i] = (jlong) nativeEvents[i].type | ((jlong) nativeEvents[i].fd << 32);
+	}
+	(*env)->SetLongArrayRegion(env, events, 0, result.count, packed);
+	return result.count;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopInterrupt(JNIEnv *env, jclass type, jlong ptr) {
+	return eventLoop_interrupt((eventLoop *) ptr);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_eventLoopFree(JNIEnv *env, jclass type, jlong ptr) {
+	return eventLoop_free((eventLoop *) ptr);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_inputParserInit(JNIEnv *env, jclass type) {
+	// A null return value will trigger OOM.
+	return (jlong) inputParser_init();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_inputParserParse(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jbyteArray buffer,
+	jint offset,
+	jint length,
+	jlongArray events
+) {
+	// Parsing never blocks, so critical access avoids copying either array in or out.
+	jbyte *nativeBuffer = (*env)->GetPrimitiveArrayCritical(env, buffer, NULL);
+	jlong *nativeEvents = (*env)->GetPrimitiveArrayCritical(env, events, NULL);
+
+	// Each 8-byte inputEvent is written directly into one element of the long array.
+	int count = inputParser_parse(
+		(inputParser *) ptr,
+		(const char *) nativeBuffer + offset,
+		length,
+		(inputEvent *) nativeEvents
+	);
+
+	(*env)->ReleasePrimitiveArrayCritical(env, events, nativeEvents, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, buffer, nativeBuffer, JNI_ABORT);
+
+	return count;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_inputParserHasPending(JNIEnv *env, jclass type, jlong ptr) {
+	return inputParser_hasPending((inputParser *) ptr) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_inputParserFlush(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jlongArray events
+) {
+	jlong *nativeEvents = (*env)->GetPrimitiveArrayCritical(env, events, NULL);
+	int count = inputParser_flush((inputParser *) ptr, (inputEvent *) nativeEvents);
+	(*env)->ReleasePrimitiveArrayCritical(env, events, nativeEvents, 0);
+	return count;
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_inputParserPaste(
+	JNIEnv *env,
+	jclass type,
+	jlong ptr,
+	jint offset,
+	jint length
+) {
+	const char *paste = inputParser_paste((inputParser *) ptr, offset, length);
+	if (unlikely(paste == NULL)) {
+		// A null return value will trigger an out of bounds exception.
+		return NULL;
+	}
+
+	// If allocation fails an OOM is already pending and the null return value is ignored.
+	jbyteArray array = (*env)->NewByteArray(env, length);
+	if (likely(array != NULL)) {
+		(*env)->SetByteArrayRegion(env, array, 0, length, (const jbyte *) paste);
+	}
+	return array;
+}
+
+JNIEXPORT void JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_inputParserFree(JNIEnv *env, jclass type, jlong ptr) {
+	inputParser_free((inputParser *) ptr);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_cellGridEncodeRow(
+	JNIEnv *env,
+	jclass type,
+	jintArray cells,
+	jint offset,
+	jint count,
+	jint colorLevel,
+	jbyteArray output,
+	jint outputOffset
+) {
+	// Encoding never blocks, so critical access avoids copying the cells in or the bytes out.
+	jint *nativeCells = (*env)->GetPrimitiveArrayCritical(env, cells, NULL);
+	jbyte *nativeOutput = (*env)->GetPrimitiveArrayCritical(env, output, NULL);
+
+	int length = cellGrid_encodeRow(
+		(const uint32_t *) nativeCells + offset * cellGrid_cellWords,
+		count,
+		colorLevel,
+		(char *) nativeOutput + outputOffset
+	);
+
+	(*env)->ReleasePrimitiveArrayCritical(env, output, nativeOutput, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, cells, nativeCells, JNI_ABORT);
+
+	return length;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_jakewharton_mosaic_terminal_Tty_cellGridDiff(
+	JNIEnv *env,
+	jclass type,
+	jintArray previous,
+	jintArray next,
+	jint width,
+	jint height,
+	jint mergeGap,
+	jintArray runs
+) {
+	// Comparison never blocks, so critical access avoids copying the grids in or the runs out.
+	jint *nativePrevious = (*env)->GetPrimitiveArrayCritical(env, previous, NULL);
+	jint *nativeNext = (*env)->GetPrimitiveArrayCritical(env, next, NULL);
+	jint *nativeRuns = (*env)->GetPrimitiveArrayCritical(env, runs, NULL);
+
+	int count = cellGrid_diff(
+		(const uint32_t *) nativePrevious,
+		(const uint32_t *) nativeNext,
+		width,
+		height,
+		mergeGap,
+		(int32_t *) nativeRuns
+	);
+
+	(*env)->ReleasePrimitiveArrayCritical(env, runs, nativeRuns, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, next, nativeNext, JNI_ABORT);
+	(*env)->ReleasePrimitiveArrayCritical(env, previous, nativePrevious, JNI_ABORT);
+
+	return count;
+}
@@ -1,14 +1,26 @@
 package com.jakewharton.mosaic.terminal
 
+import java.io.File
 import java.io.IOException
+import java.nio.Buffer
+import java.nio.ByteBuffer
+import java.nio.CharBuffer
+import java.nio.charset.CodingErrorAction.REPLACE
+import java.nio.charset.StandardCharsets.UTF_8
 import java.nio.file.Files
 import java.nio.file.Path
+import java.nio.file.Paths
+import java.nio.file.StandardCopyOption.ATOMIC_MOVE
 import java.nio.file.StandardCopyOption.REPLACE_EXISTING
+import java.security.MessageDigest
 import java.util.Locale.US
 
+// 'abm' is the name Linux reports for LZCNT.
+private val x8664V3Flags = listOf("avx", "avx2", "bmi1", "bmi2", "f16c", "fma", "abm", "movbe")
+
 public actual object Tty {
 	init {
-		loadNativeLibrary("mosaic")
+		loadNativeLibrary()
 	}
 
 	public actual fun enableRawMode(): AutoCloseable {
@@ -40,6 +52,36 @@ public actual object Tty {
 		return StdinWriter(writer, reader)
 	}
 
+	public actual fun stdoutWriter(): StdoutWriter {
+		val writer = stdoutWriterInit()
+		if (writer == 0L) throw OutOfMemoryError()
+		return StdoutWriter(writer)
+	}
+
+	public actual fun resizeNotifier(): ResizeNotifier {
+		val notifier = resizeNotifierInit()
+		if (notifier == 0L) throw OutOfMemoryError()
+		return ResizeNotifier(notifier, terminalSize())
+	}
+
+	public actual fun eventLoop(watchResize: Boolean): EventLoop {
+		val loop = eventLoopInit(watchResize)
+		if (loop == 0L) throw OutOfMemoryError()
+		return EventLoop(loop)
+	}
+
+	internal actual fun eventLoopWithoutStdin(): EventLoop {
+		val loop = eventLoopInitWithoutStdin()
+		if (loop == 0L) throw OutOfMemoryError()
+		return EventLoop(loop)
+	}
+
+	public actual fun inputParser(): InputParser {
+		val parser = inputParserInit()
+		if (parser == 0L) throw OutOfMemoryError()
+		return InputParser(parser)
+	}
+
 	@JvmStatic
 	private external fun enterRawMode(): Long
 
@@ -67,7 +109,28 @@ public actual object Tty {
 		buffer: ByteArray,
 		offset: Int,
 		length: Int,
-		timeoutMillis: Int,
+		timeoutNanos: Long,
+	): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdinReaderReadBuffer") // Avoid internal name mangling.
+	internal external fun stdinReaderReadBuffer(
+		reader: Long,
+		buffer: ByteBuffer,
+		offset: Int,
+		length: Int,
+	): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdinReaderReadBufferWithTimeout") // Avoid internal name mangling.
+	internal external fun stdinReaderReadBufferWithTimeout(
+		reader: Long,
+		buffer: ByteBuffer,
+		offset: Int,
+		length: Int,
+		timeoutNanos: Long,
 	): Int
 
 	@JvmStatic
@@ -75,6 +138,11 @@ public actual object Tty {
 	@JvmName("stdinReaderInterrupt") // Avoid internal name mangling.
 	internal external fun stdinReaderInterrupt(reader: Long)
 
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdinReaderFds") // Avoid internal name mangling.
+	internal external fun stdinReaderFds(reader: Long): Long
+
 	@JvmStatic
 	@JvmSynthetic // Hide from Java callers.
 	@JvmName("stdinReaderFree") // Avoid internal name mangling.
@@ -96,36 +164,282 @@ public actual object Tty {
 	@JvmName("stdinWriterFree") // Avoid internal name mangling.
 	internal external fun stdinWriterFree(writer: Long)
 
+	@JvmStatic
+	private external fun stdoutWriterInit(): Long
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdoutWriterBuffer") // Avoid internal name mangling.
+	internal external fun stdoutWriterBuffer(writer: Long, capacity: Int): ByteBuffer?
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdoutWriterWrite") // Avoid internal name mangling.
+	internal external fun stdoutWriterWrite(writer: Long, count: Int)
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdoutWriterFree") // Avoid internal name mangling.
+	internal external fun stdoutWriterFree(writer: Long): Int
+
+	/** Returns columns in the upper 32 bits and rows in the lower 32 bits. */
+	@JvmStatic
+	private external fun terminalSize(): Long
+
+	@JvmStatic
+	private external fun resizeNotifierInit(): Long
+
+	/** Returns a size packed like [terminalSize], or -1 if interrupted. */
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("resizeNotifierAwait") // Avoid internal name mangling.
+	internal external fun resizeNotifierAwait(notifier: Long): Long
+
+	/** Returns the signal and interrupt file descriptors packed like [stdinReaderFds], or -1. */
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("resizeNotifierFds") // Avoid internal name mangling.
+	internal external fun resizeNotifierFds(notifier: Long): Long
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("resizeNotifierInterrupt") // Avoid internal name mangling.
+	internal external fun resizeNotifierInterrupt(notifier: Long): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("resizeNotifierFree") // Avoid internal name mangling.
+	internal external fun resizeNotifierFree(notifier: Long): Int
+
+	@JvmStatic
+	private external fun eventLoopInit(watchResize: Boolean): Long
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("stdinWriterEventLoop") // Avoid internal name mangling.
+	internal external fun stdinWriterEventLoop(writer: Long): Long
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopInitWithoutStdin") // Avoid internal name mangling.
+	internal external fun eventLoopInitWithoutStdin(): Long
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopAddFd") // Avoid internal name mangling.
+	internal external fun eventLoopAddFd(loop: Long, fd: Int): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopRemoveFd") // Avoid internal name mangling.
+	internal external fun eventLoopRemoveFd(loop: Long, fd: Int): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopSetTimeout") // Avoid internal name mangling.
+	internal external fun eventLoopSetTimeout(loop: Long, timeoutNanos: Long): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopWait") // Avoid internal name mangling.
+	internal external fun eventLoopWait(loop: Long, events: LongArray): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopInterrupt") // Avoid internal name mangling.
+	internal external fun eventLoopInterrupt(loop: Long): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("eventLoopFree") // Avoid internal name mangling.
+	internal external fun eventLoopFree(loop: Long): Int
+
+	@JvmStatic
+	private external fun inputParserInit(): Long
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("inputParserParse") // Avoid internal name mangling.
+	internal external fun inputParserParse(
+		parser: Long,
+		buffer: ByteArray,
+		offset: Int,
+		length: Int,
+		events: LongArray,
+	): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("inputParserHasPending") // Avoid internal name mangling.
+	internal external fun inputParserHasPending(parser: Long): Boolean
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("inputParserFlush") // Avoid internal name mangling.
+	internal external fun inputParserFlush(parser: Long, events: LongArray): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("inputParserPaste") // Avoid internal name mangling.
+	internal external fun inputParserPaste(parser: Long, offset: Int, length: Int): ByteArray?
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("inputParserFree") // Avoid internal name mangling.
+	internal external fun inputParserFree(parser: Long)
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("cellGridEncodeRow") // Avoid internal name mangling.
+	internal external fun cellGridEncodeRow(
+		cells: IntArray,
+		offset: Int,
+		count: Int,
+		colorLevel: Int,
+		output: ByteArray,
+		outputOffset: Int,
+	): Int
+
+	@JvmStatic
+	@JvmSynthetic // Hide from Java callers.
+	@JvmName("cellGridDiff") // Avoid internal name mangling.
+	internal external fun cellGridDiff(
+		previous: IntArray,
+		next: IntArray,
+		width: Int,
+		height: Int,
+		mergeGap: Int,
+		runs: IntArray,
+	): Int
+
+	/**
+	 * Load the speed-optimized `mosaic-fast` library when the host CPU is known to support it, or
+	 * the size-optimized `mosaic` library otherwise. Set the `mosaic.native.variant` system property
+	 * to `fast` or `small` to override the choice.
+	 */
+	private fun loadNativeLibrary() {
+		val osName = System.getProperty("os.name").lowercase(US)
+		val osArch = System.getProperty("os.arch").lowercase(US)
+		val fast = when (val variant = System.getProperty("mosaic.native.variant")) {
+			null, "auto" -> supportsFastLibrary(osName, osArch)
+			"fast" -> true
+			"small" -> false
+			else -> throw IllegalArgumentException("Unknown mosaic.native.variant: $variant")
+		}
+		// The fast library is optional and may be missing from local builds, so fall back to the
+		// small library. Binding native methods only happens after a successful load.
+		if (fast) {
+			try {
+				if (loadNativeLibrary("mosaic-fast", osName, osArch)) return
+			} catch (e: UnsatisfiedLinkError) {
+				// Fall back to the small library below.
+			}
+		}
+		check(loadNativeLibrary("mosaic", osName, osArch)) {
+			"Unable to read native library for $osName $osArch from JAR"
+		}
+	}
+
+	/** Returns false if the library [name] is not in the JAR. */
 	@Suppress(
 		// Only loading from our own JAR contents.
 		"UnsafeDynamicallyLoadedCode",
-		// Preserving copy/paste!
-		"SameParameterValue",
 	)
-	private fun loadNativeLibrary(name: String) {
-		val osName = System.getProperty("os.name").lowercase(US)
-		val osArch = System.getProperty("os.arch").lowercase(US)
-		val nativeLibraryJarPath = "/jni/$osArch/" + when {
+	private fun loadNativeLibrary(name: String, osName: String, osArch: String): Boolean {
+		val nativeLibraryFileName = when {
 			"linux" in osName -> "lib$name.so"
 			"mac" in osName -> "lib$name.dylib"
 			"windows" in osName -> "$name.dll"
 			else -> throw IllegalStateException("Unsupported OS: $osName $osArch")
 		}
-		val nativeLibraryUrl = Tty::class.java.getResource(nativeLibraryJarPath)
-			?: throw IllegalStateException("Unable to read $nativeLibraryJarPath from JAR")
+		val nativeLibraryJarPath = "/jni/$osArch/$nativeLibraryFileName"
+		val nativeLibraryUrl = Tty::class.java.getResource(nativeLibraryJarPath) ?: return false
 		val nativeLibraryFile: Path
 		try {
-			nativeLibraryFile = Files.createTempFile(name, null)
-
-			// File-based deleteOnExit() uses a special internal shutdown hook that always runs last.
-			nativeLibraryFile.toFile().deleteOnExit()
-			nativeLibraryUrl.openStream().use { nativeLibrary ->
-				Files.copy(nativeLibrary, nativeLibraryFile, REPLACE_EXISTING)
+			val nativeLibrary = nativeLibraryUrl.openStream().use { it.readBytes() }
+			nativeLibraryFile = try {
+				nativeLibraryCacheRoot(osName)?.let { cacheRoot ->
+					cachedNativeLibrary(cacheRoot, nativeLibraryFileName, nativeLibrary)
+				}
+			} catch (e: IOException) {
+				null
+			} ?: Files.createTempFile(name, null).also { file ->
+				// File-based deleteOnExit() uses a special internal shutdown hook that always runs last.
+				file.toFile().deleteOnExit()
+				Files.write(file, nativeLibrary)
 			}
 		} catch (e: IOException) {
 			throw RuntimeException("Unable to extract native library from JAR", e)
 		}
 		System.load(nativeLibraryFile.toAbsolutePath().toString())
+		return true
+	}
+
+	/**
+	 * Returns a copy of [nativeLibrary] in a directory of [cacheRoot] named for its SHA-256 so that
+	 * it is only extracted by the first JVM to use it. An existing copy is only used if its contents
+	 * match.
+	 */
+	@JvmSynthetic // Hide from Java callers.
+	internal fun cachedNativeLibrary(cacheRoot: Path, fileName: String, nativeLibrary: ByteArray): Path {
+		val sha256 = MessageDigest.getInstance("SHA-256").digest(nativeLibrary)
+			.joinToString("") { (it.toInt() and 0xFF).toString(16).padStart(2, '0') }
+		val directory = cacheRoot.resolve("mosaic").resolve(sha256)
+		val file = directory.resolve(fileName)
+		if (Files.isRegularFile(file) && Files.readAllBytes(file).contentEquals(nativeLibrary)) {
+			return file
+		}
+
+		Files.createDirectories(directory)
+		val temp = Files.createTempFile(directory, fileName, ".tmp")
+		try {
+			Files.write(temp, nativeLibrary)
+			// Concurrent JVMs each write their own temporary file and the last rename wins. On Windows
+			// the rename fails if another process has already loaded the library.
+			Files.move(temp, file, ATOMIC_MOVE, REPLACE_EXISTING)
+		} catch (e: IOException) {
+			Files.deleteIfExists(temp)
+			if (!Files.readAllBytes(file).contentEquals(nativeLibrary)) throw e
+		}
+		return file
+	}
+
+	/** `$XDG_CACHE_HOME` if set, otherwise the conventional user cache directory for the OS. */
+	private fun nativeLibraryCacheRoot(osName: String): Path? {
+		val xdgCacheHome = System.getenv("XDG_CACHE_HOME")?.let { Paths.get(it) }
+		// Relative paths are invalid according to the XDG base directory specification.
+		if (xdgCacheHome != null && xdgCacheHome.isAbsolute) return xdgCacheHome
+		if ("windows" in osName) {
+			return System.getenv("LOCALAPPDATA")?.takeIf { it.isNotEmpty() }?.let { Paths.get(it) }
+		}
+		val home = System.getProperty("user.home")?.takeIf { it.isNotEmpty() } ?: return null
+		return if ("mac" in osName) {
+			Paths.get(home, "Library", "Caches")
+		} else {
+			Paths.get(home, ".cache")
+		}
+	}
+
+	/**
+	 * The fast library targets the baseline CPU of every architecture except x86_64, where it
+	 * requires x86-64-v3. Those features are only detected on Linux. Elsewhere the small library
+	 * is used unless the `mosaic.native.variant` system property requests the fast one.
+	 */
+	private fun supportsFastLibrary(osName: String, osArch: String): Boolean {
+		if (osArch != "amd64" && osArch != "x86_64") return true
+		if ("linux" !in osName) return false
+		val flags = try {
+			File("/proc/cpuinfo").useLines { lines ->
+				lines.firstOrNull { it.startsWith("flags") }
+					?.substringAfter(':')
+					?.split(' ')
+					?.toSet()
+			}
+		} catch (e: IOException) {
+			null
+		} ?: return false
+		// The kernel omits the AVX flags when it does not save their registers.
+		return flags.containsAll(x8664V3Flags)
 	}
 }
 
@@ -137,9 +451,96 @@ public actual class StdinReader internal constructor(
 	}
 
 	public actual fun readWithTimeout(buffer: ByteArray, offset: Int, length: Int, timeoutMillis: Int): Int {
-		return Tty.stdinReaderReadWithTimeout(readerPtr, buffer, offset, length, timeoutMillis)
+		return readWithTimeoutNanos(buffer, offset, length, timeoutMillis * 1_000_000L)
 	}
 
+	public actual fun readWithTimeoutNanos(buffer: ByteArray, offset: Int, length: Int, timeoutNanos: Long): Int {
+		return Tty.stdinReaderReadWithTimeout(readerPtr, buffer, offset, length, timeoutNanos)
+	}
+
+	/**
+	 * Read up to [remaining][ByteBuffer.remaining] bytes into [buffer] at its
+	 * [position][ByteBuffer.position]. The number of bytes read will be returned and the position
+	 * advanced by that amount. 0 will be returned if [interrupt] is called while waiting for input.
+	 * -1 will be returned if the input stream is closed.
+	 *
+	 * Unlike the [ByteArray] overload, bytes are read directly into the buffer's native memory
+	 * without any intermediate copies.
+	 *
+	 * @param buffer A [direct][ByteBuffer.isDirect] buffer.
+	 * @see readWithTimeout
+	 */
+	public fun read(buffer: ByteBuffer): Int {
+		require(buffer.isDirect) { "Buffer must be direct" }
+		val position = buffer.position()
+		val read = Tty.stdinReaderReadBuffer(readerPtr, buffer, position, buffer.remaining())
+		buffer.advance(position, read)
+		return read
+	}
+
+	/**
+	 * Read up to [remaining][ByteBuffer.remaining] bytes into [buffer] at its
+	 * [position][ByteBuffer.position]. The number of bytes read will be returned and the position
+	 * advanced by that amount. 0 will be returned if [interrupt] is called while waiting for input,
+	 * or if at least [timeoutMillis] have passed without data. -1 will be returned if the input
+	 * stream is closed.
+	 *
+	 * Unlike the [ByteArray] overload, bytes are read directly into the buffer's native memory
+	 * without any intermediate copies.
+	 *
+	 * @param buffer A [direct][ByteBuffer.isDirect] buffer.
+	 * @param timeoutMillis A value of 0 will perform a non-blocking read. A negative value will wait
+	 * indefinitely, like [read]. Otherwise, the maximum time (in milliseconds) to wait for data.
+	 * @see read
+	 * @see readWithTimeoutNanos
+	 */
+	public fun readWithTimeout(buffer: ByteBuffer, timeoutMillis: Int): Int {
+		return readWithTimeoutNanos(buffer, timeoutMillis * 1_000_000L)
+	}
+
+	/**
+	 * Read up to [remaining][ByteBuffer.remaining] bytes into [buffer] at its
+	 * [position][ByteBuffer.position]. The number of bytes read will be returned and the position
+	 * advanced by that amount. 0 will be returned if [interrupt] is called while waiting for input,
+	 * or if at least [timeoutNanos] have passed without data. -1 will be returned if the input
+	 * stream is closed.
+	 *
+	 * Unlike the [ByteArray] overload, bytes are read directly into the buffer's native memory
+	 * without any intermediate copies.
+	 *
+	 * @param buffer A [direct][ByteBuffer.isDirect] buffer.
+	 * @param timeoutNanos A value of 0 will perform a non-blocking read. A negative value will wait
+	 * indefinitely, like [read]. Otherwise, the maximum time (in nanoseconds) to wait for data.
+	 * @see read
+	 * @see readWithTimeout
+	 */
+	public fun readWithTimeoutNanos(buffer: ByteBuffer, timeoutNanos: Long): Int {
+		require(buffer.isDirect) { "Buffer must be direct" }
+		val position = buffer.position()
+		val read = Tty.stdinReaderReadBufferWithTimeout(
+			readerPtr,
+			buffer,
+			position,
+			buffer.remaining(),
+			timeoutNanos,
+		)
+		buffer.advance(position, read)
+		return read
+	}
+
+	private fun ByteBuffer.advance(position: Int, read: Int) {
+		if (read > 0) {
+			// Cast to Buffer to avoid the covariant override added in Java 9.
+			(this as Buffer).position(position + read)
+		}
+	}
+
+	public actual suspend fun awaitRead(buffer: ByteArray, offset: Int, length: Int): Int {
+		return pollAndRead(buffer, offset, length, Tty.stdinReaderFds(readerPtr))
+	}
+
+	internal actual var canceledInput: ByteArray? = null
+
 	public actual fun interrupt() {
 		Tty.stdinReaderInterrupt(readerPtr)
 	}
@@ -160,7 +561,186 @@ internal actual class StdinWriter internal constructor(
 		Tty.stdinWriterWrite(writerPtr, buffer)
 	}
 
+	actual fun eventLoop(): EventLoop {
+		val loop = Tty.stdinWriterEventLoop(writerPtr)
+		if (loop == 0L) throw OutOfMemoryError()
+		return EventLoop(loop)
+	}
+
 	actual override fun close() {
 		Tty.stdinWriterFree(writerPtr)
 	}
 }
+
+public actual class StdoutWriter internal constructor(
+	private val writerPtr: Long,
+) : AutoCloseable {
+	private val encoder = UTF_8.newEncoder()
+		.onMalformedInput(REPLACE)
+		.onUnmappableCharacter(REPLACE)
+
+	/** A direct view of the native buffer. Replaced only when the native buffer needs to grow. */
+	private var buffer: ByteBuffer? = null
+
+	public actual fun write(chars: CharSequence) {
+		// Nothing to write, and no buffer may have been allocated yet.
+		if (chars.isEmpty()) return
+
+		// Each UTF-16 char encodes to at most three UTF-8 bytes so the encoder cannot overflow.
+		val buffer = buffer(chars.length * 3)
+		encoder.reset()
+		encoder.encode(CharBuffer.wrap(chars), buffer, true)
+		encoder.flush(buffer)
+
+		Tty.stdoutWriterWrite(writerPtr, buffer.position())
+	}
+
+	public actual fun write(buffer: ByteArray, offset: Int, length: Int) {
+		if (offset < 0 || length < 0 || offset > buffer.size - length) {
+			throw IndexOutOfBoundsException("offset=$offset, length=$length, size=${buffer.size}")
+		}
+		// Nothing to write, and no buffer may have been allocated yet.
+		if (length == 0) return
+
+		val nativeBuffer = buffer(length)
+		nativeBuffer.put(buffer, offset, length)
+
+		Tty.stdoutWriterWrite(writerPtr, length)
+	}
+
+	/** The native buffer with room for at least [required] bytes, cleared for writing. */
+	private fun buffer(required: Int): ByteBuffer {
+		var buffer = buffer
+		if (buffer == null || buffer.capacity() < required) {
+			val capacity = maxOf(required, (buffer?.capacity() ?: 0) * 2)
+			buffer = Tty.stdoutWriterBuffer(writerPtr, capacity) ?: throw OutOfMemoryError()
+			this.buffer = buffer
+		}
+		// Cast to Buffer to avoid the covariant override added in Java 9.
+		(buffer as Buffer).clear()
+		return buffer
+	}
+
+	public actual override fun close() {
+		val error = Tty.stdoutWriterFree(writerPtr)
+		check(error == 0) { "Unable to free stdout writer: $error" }
+	}
+}
+
+public actual class EventLoop internal constructor(
+	private val loopPtr: Long,
+) : AutoCloseable {
+	public actual fun addFd(fd: Int) {
+		val error = Tty.eventLoopAddFd(loopPtr, fd)
+		check(error == 0) { "Unable to add fd $fd to event loop: $error" }
+	}
+
+	public actual fun removeFd(fd: Int) {
+		val error = Tty.eventLoopRemoveFd(loopPtr, fd)
+		check(error == 0) { "Unable to remove fd $fd from event loop: $error" }
+	}
+
+	public actual fun setTimeout(timeoutNanos: Long) {
+		val error = Tty.eventLoopSetTimeout(loopPtr, timeoutNanos)
+		check(error == 0) { "Unable to set event loop timeout: $error" }
+	}
+
+	public actual fun await(events: LongArray): Int {
+		require(events.isNotEmpty()) { "events must not be empty" }
+		return Tty.eventLoopWait(loopPtr, events)
+	}
+
+	public actual fun interrupt() {
+		val error = Tty.eventLoopInterrupt(loopPtr)
+		check(error == 0) { "Unable to interrupt event loop: $error" }
+	}
+
+	public actual override fun close() {
+		val error = Tty.eventLoopFree(loopPtr)
+		check(error == 0) { "Unable to free event loop: $error" }
+	}
+}
+
+public actual class ResizeNotifier internal constructor(
+	private val notifierPtr: Long,
+	size: Long,
+) : AutoCloseable {
+	private var size = size
+
+	public actual val columns: Int get() = (size ushr 32).toInt()
+	public actual val rows: Int get() = size.toInt()
+
+	public actual suspend fun awaitResize(): Boolean {
+		return pollAndAwaitResize(Tty.resizeNotifierFds(notifierPtr))
+	}
+
+	public actual fun awaitResizeBlocking(): Boolean {
+		val size = Tty.resizeNotifierAwait(notifierPtr)
+		if (size == -1L) return false
+		this.size = size
+		return true
+	}
+
+	public actual fun interrupt() {
+		val error = Tty.resizeNotifierInterrupt(notifierPtr)
+		check(error == 0) { "Unable to interrupt resize notifier: $error" }
+	}
+
+	public actual override fun close() {
+		val error = Tty.resizeNotifierFree(notifierPtr)
+		check(error == 0) { "Unable to free resize notifier: $error" }
+	}
+}
+
+public actual class InputParser internal constructor(
+	private val parserPtr: Long,
+) : AutoCloseable {
+	public actual fun parse(buffer: ByteArray, offset: Int, length: Int, events: LongArray): Int {
+		// The native parser writes directly into these arrays so bounds must be verified up front.
+		if (offset < 0 || length < 0 || offset > buffer.size - length) {
+			throw IndexOutOfBoundsException("offset=$offset, length=$length, size=${buffer.size}")
+		}
+		require(events.size > length) { "events.size must be at least length + 1" }
+		return Tty.inputParserParse(parserPtr, buffer, offset, length, events)
+	}
+
+	public actual val hasPending: Boolean
+		get() = Tty.inputParserHasPending(parserPtr)
+
+	public actual fun flush(events: LongArray): Int {
+		require(events.isNotEmpty()) { "events must not be empty" }
+		return Tty.inputParserFlush(parserPtr, events)
+	}
+
+	public actual fun pasteText(offset: Int, length: Int): String {
+		val bytes = Tty.inputParserPaste(parserPtr, offset, length)
+			?: throw IndexOutOfBoundsException("offset=$offset, length=$length")
+		return bytes.decodeToString()
+	}
+
+	public actual override fun close() {
+		Tty.inputParserFree(parserPtr)
+	}
+}
+
+internal actual fun cellGridEncodeRow(
+	cells: IntArray,
+	offset: Int,
+	count: Int,
+	colorLevel: Int,
+	output: ByteArray,
+	outputOffset: Int,
+): Int = Tty.cellGridEncodeRow(cells, offset, count, colorLevel, output, outputOffset)
+
+internal actual fun cellGridDiff(
+	previous: IntArray,
+	next: IntArray,
+	width: Int,
+	height: Int,
+	mergeGap: Int,
+	runs: IntArray,
+): Int = Tty.cellGridDiff(previous, next, width, height, mergeGap, runs)
+
+internal actual fun startDaemonThread(name: String, block: () -> Unit) {
+	Thread(block, name).apply { isDaemon = true }.start()
+}
@@ -0,0 +1,49 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import assertk.assertions.isNotEqualTo
+import java.nio.file.Files
+import java.nio.file.attribute.FileTime
+import kotlin.test.AfterTest
+import kotlin.test.Test
+
+class NativeLibraryCacheTest {
+	private val cacheRoot = Files.createTempDirectory("mosaic-cache")
+	private val library = "not really a library".encodeToByteArray()
+
+	@AfterTest fun after() {
+		cacheRoot.toFile().deleteRecursively()
+	}
+
+	@Test fun extractsIntoDirectoryNamedForContents() {
+		val file = Tty.cachedNativeLibrary(cacheRoot, "libmosaic.so", library)
+		assertThat(file.fileName.toString()).isEqualTo("libmosaic.so")
+		assertThat(file.parent.parent).isEqualTo(cacheRoot.resolve("mosaic"))
+		assertThat(Files.readAllBytes(file).decodeToString()).isEqualTo("not really a library")
+
+		val other = Tty.cachedNativeLibrary(cacheRoot, "libmosaic.so", "other".encodeToByteArray())
+		assertThat(other.parent).isNotEqualTo(file.parent)
+	}
+
+	@Test fun reusesExistingCopy() {
+		val file = Tty.cachedNativeLibrary(cacheRoot, "libmosaic.so", library)
+		val modified = FileTime.fromMillis(1_000_000)
+		Files.setLastModifiedTime(file, modified)
+
+		val again = Tty.cachedNativeLibrary(cacheRoot, "libmosaic.so", library)
+		assertThat(again).isEqualTo(file)
+		assertThat(Files.getLastModifiedTime(again)).isEqualTo(modified)
+	}
+
+	@Test fun replacesCorruptCopy() {
+		val file = Tty.cachedNativeLibrary(cacheRoot, "libmosaic.so", library)
+		Files.write(file, "truncated".encodeToByteArray())
+
+		val again = Tty.cachedNativeLibrary(cacheRoot, "libmosaic.so", library)
+		assertThat(again).isEqualTo(file)
+		assertThat(Files.readAllBytes(again).decodeToString()).isEqualTo("not really a library")
+		// Only the library remains, not the temporary file it was written to.
+		assertThat(file.parent.toFile().list()!!.toList()).isEqualTo(listOf("libmosaic.so"))
+	}
+}
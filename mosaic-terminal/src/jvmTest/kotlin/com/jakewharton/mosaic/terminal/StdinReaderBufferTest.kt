@@ -0,0 +1,48 @@
+package com.jakewharton.mosaic.terminal
+
+import assertk.assertFailure
+import assertk.assertThat
+import assertk.assertions.isEqualTo
+import assertk.assertions.isInstanceOf
+import assertk.assertions.isZero
+import java.nio.ByteBuffer
+import kotlin.test.AfterTest
+import kotlin.test.Test
+
+class StdinReaderBufferTest {
+	private val writer = Tty.stdinWriter()
+	private val reader = writer.reader
+
+	@AfterTest fun after() {
+		reader.close()
+		writer.close()
+	}
+
+	@Test fun readWhatWasWritten() {
+		writer.write("hello".encodeToByteArray())
+
+		val buffer = ByteBuffer.allocateDirect(100)
+		buffer.position(2)
+		val read = reader.read(buffer)
+		assertThat(read).isEqualTo(5)
+		assertThat(buffer.position()).isEqualTo(7)
+
+		val bytes = ByteArray(5)
+		buffer.position(2)
+		buffer.get(bytes)
+		assertThat(bytes.decodeToString()).isEqualTo("hello")
+	}
+
+	@Test fun readWithTimeoutReturnsZeroOnTimeout() {
+		val buffer = ByteBuffer.allocateDirect(10)
+		val read = reader.readWithTimeout(buffer, 100)
+		assertThat(read).isZero()
+		assertThat(buffer.position()).isZero()
+	}
+
+	@Test fun heapBufferThrows() {
+		assertFailure {
+			reader.read(ByteBuffer.allocate(10))
+		}.isInstanceOf<IllegalArgumentException>()
+	}
+}
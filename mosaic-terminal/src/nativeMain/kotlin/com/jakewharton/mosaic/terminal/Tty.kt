@@ -1,10 +1,23 @@
 package com.jakewharton.mosaic.terminal
 
+import kotlin.native.concurrent.ObsoleteWorkersApi
+import kotlin.native.concurrent.Worker
+import kotlinx.cinterop.ByteVar
 import kotlinx.cinterop.CPointer
 import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.IntVar
 import kotlinx.cinterop.addressOf
+import kotlinx.cinterop.alloc
+import kotlinx.cinterop.convert
+import kotlinx.cinterop.memScoped
+import kotlinx.cinterop.ptr
+import kotlinx.cinterop.readBytes
+import kotlinx.cinterop.reinterpret
+import kotlinx.cinterop.set
 import kotlinx.cinterop.useContents
 import kotlinx.cinterop.usePinned
+import kotlinx.cinterop.value
+import platform.posix.memcpy
 
 @OptIn(ExperimentalForeignApi::class)
 public actual object Tty {
@@ -41,6 +54,50 @@ public actual object Tty {
 		val reader = stdinWriter_getReader(writer)!!
 		return StdinWriter(writer, reader)
 	}
+
+	public actual fun stdoutWriter(): StdoutWriter {
+		val writer = stdoutWriter_init().useContents {
+			check(error == 0U) { "Unable to create stdout writer: $error" }
+			writer ?: throw OutOfMemoryError()
+		}
+		return StdoutWriter(writer)
+	}
+
+	public actual fun resizeNotifier(): ResizeNotifier {
+		val notifier = resizeNotifier_init().useContents {
+			check(error == 0U) { "Unable to create resize notifier: $error" }
+			notifier ?: throw OutOfMemoryError()
+		}
+		val notifierResult = ResizeNotifier(notifier)
+		getTerminalSize().useContents {
+			// Not being attached to a terminal is not exceptional. Leave the size unknown as 0x0.
+			if (error == 0U) {
+				notifierResult.update(columns, rows)
+			}
+		}
+		return notifierResult
+	}
+
+	public actual fun eventLoop(watchResize: Boolean): EventLoop {
+		val loop = eventLoop_init(if (watchResize) 1 else 0).useContents {
+			check(error == 0U) { "Unable to create event loop: $error" }
+			loop ?: throw OutOfMemoryError()
+		}
+		return EventLoop(loop)
+	}
+
+	internal actual fun eventLoopWithoutStdin(): EventLoop {
+		val loop = eventLoop_initWithoutStdin().useContents {
+			check(error == 0U) { "Unable to create event loop: $error" }
+			loop ?: throw OutOfMemoryError()
+		}
+		return EventLoop(loop)
+	}
+
+	public actual fun inputParser(): InputParser {
+		val parser = inputParser_init() ?: throw OutOfMemoryError()
+		return InputParser(parser)
+	}
 }
 
 @OptIn(ExperimentalForeignApi::class)
@@ -57,14 +114,25 @@ public actual class StdinReader internal constructor(
 	}
 
 	public actual fun readWithTimeout(buffer: ByteArray, offset: Int, length: Int, timeoutMillis: Int): Int {
+		return readWithTimeoutNanos(buffer, offset, length, timeoutMillis * 1_000_000L)
+	}
+
+	public actual fun readWithTimeoutNanos(buffer: ByteArray, offset: Int, length: Int, timeoutNanos: Long): Int {
 		buffer.usePinned {
-			stdinReader_readWithTimeout(ref, it.addressOf(offset), length, timeoutMillis).useContents {
+			stdinReader_readWithTimeoutNanos(ref, it.addressOf(offset), length, timeoutNanos).useContents {
 				if (error == 0U) return count
 				throw RuntimeException(error.toString())
 			}
 		}
 	}
 
+	public actual suspend fun awaitRead(buffer: ByteArray, offset: Int, length: Int): Int {
+		val packedFds = packFds { stdinFd, interruptFd -> stdinReader_fds(ref, stdinFd, interruptFd) }
+		return pollAndRead(buffer, offset, length, packedFds)
+	}
+
+	internal actual var canceledInput: ByteArray? = null
+
 	public actual fun interrupt() {
 		stdinReader_interrupt(ref)
 	}
@@ -87,7 +155,285 @@ internal actual class StdinWriter internal constructor(
 		}
 	}
 
+	actual fun eventLoop(): EventLoop {
+		val loop = stdinWriter_eventLoop(ref).useContents {
+			check(error == 0U) { "Unable to create event loop: $error" }
+			loop ?: throw OutOfMemoryError()
+		}
+		return EventLoop(loop)
+	}
+
 	actual override fun close() {
 		stdinWriter_free(ref)
 	}
 }
+
+@OptIn(ExperimentalForeignApi::class)
+public actual class StdoutWriter internal constructor(
+	private val ref: CPointer<stdoutWriter>,
+) : AutoCloseable {
+	private var capacity = 0
+
+	public actual fun write(chars: CharSequence) {
+		// Nothing to write, and no buffer may have been allocated yet.
+		if (chars.isEmpty()) return
+
+		// Each UTF-16 char encodes to at most three UTF-8 bytes.
+		val count = buffer(chars.length * 3).encodeUtf8(chars)
+
+		val error = stdoutWriter_write(ref, count)
+		check(error == 0U) { "Unable to write stdout: $error" }
+	}
+
+	public actual fun write(buffer: ByteArray, offset: Int, length: Int) {
+		if (offset < 0 || length < 0 || offset > buffer.size - length) {
+			throw IndexOutOfBoundsException("offset=$offset, length=$length, size=${buffer.size}")
+		}
+		// Nothing to write, and no buffer may have been allocated yet.
+		if (length == 0) return
+
+		val nativeBuffer = buffer(length)
+		buffer.usePinned {
+			memcpy(nativeBuffer, it.addressOf(offset), length.convert())
+		}
+
+		val error = stdoutWriter_write(ref, length)
+		check(error == 0U) { "Unable to write stdout: $error" }
+	}
+
+	/** The native buffer with room for at least [required] bytes. */
+	private fun buffer(required: Int): CPointer<ByteVar> {
+		if (capacity < required) {
+			capacity = maxOf(required, capacity * 2)
+		}
+		return stdoutWriter_buffer(ref, capacity) ?: throw OutOfMemoryError()
+	}
+
+	private fun CPointer<ByteVar>.encodeUtf8(chars: CharSequence): Int {
+		var count = 0
+		var index = 0
+		val length = chars.length
+		while (index < length) {
+			val char = chars[index++]
+			val code = char.code
+			if (code < 0x80) {
+				this[count++] = code.toByte()
+			} else if (code < 0x800) {
+				this[count++] = (0xC0 or (code shr 6)).toByte()
+				this[count++] = (0x80 or (code and 0x3F)).toByte()
+			} else if (char.isHighSurrogate() && index < length && chars[index].isLowSurrogate()) {
+				val codePoint = ((code - 0xD800) shl 10) + (chars[index++].code - 0xDC00) + 0x10000
+				this[count++] = (0xF0 or (codePoint shr 18)).toByte()
+				this[count++] = (0x80 or ((codePoint shr 12) and 0x3F)).toByte()
+				this[count++] = (0x80 or ((codePoint shr 6) and 0x3F)).toByte()
+				this[count++] = (0x80 or (codePoint and 0x3F)).toByte()
+			} else if (char.isSurrogate()) {
+				// Unpaired surrogate. Match the JVM encoder's replacement.
+				this[count++] = '?'.code.toByte()
+			} else {
+				this[count++] = (0xE0 or (code shr 12)).toByte()
+				this[count++] = (0x80 or ((code shr 6) and 0x3F)).toByte()
+				this[count++] = (0x80 or (code and 0x3F)).toByte()
+			}
+		}
+		return count
+	}
+
+	public actual override fun close() {
+		val error = stdoutWriter_free(ref)
+		check(error == 0U) { "Unable to free stdout writer: $error" }
+	}
+}
+
+@OptIn(ExperimentalForeignApi::class)
+public actual class EventLoop internal constructor(
+	private val ref: CPointer<eventLoop>,
+) : AutoCloseable {
+	public actual fun addFd(fd: Int) {
+		val error = eventLoop_addFd(ref, fd)
+		check(error == 0U) { "Unable to add fd $fd to event loop: $error" }
+	}
+
+	public actual fun removeFd(fd: Int) {
+		val error = eventLoop_removeFd(ref, fd)
+		check(error == 0U) { "Unable to remove fd $fd from event loop: $error" }
+	}
+
+	public actual fun setTimeout(timeoutNanos: Long) {
+		val error = eventLoop_setTimeout(ref, timeoutNanos)
+		check(error == 0U) { "Unable to set event loop timeout: $error" }
+	}
+
+	public actual fun await(events: LongArray): Int {
+		require(events.isNotEmpty()) { "events must not be empty" }
+		events.usePinned {
+			// Each 8-byte eventLoopEvent is written directly into one element of the long array.
+			eventLoop_wait(ref, it.addressOf(0).reinterpret<eventLoopEvent>(), events.size).useContents {
+				check(error == 0U) { "Unable to wait for events: $error" }
+				return count
+			}
+		}
+	}
+
+	public actual fun interrupt() {
+		val error = eventLoop_interrupt(ref)
+		check(error == 0U) { "Unable to interrupt event loop: $error" }
+	}
+
+	public actual override fun close() {
+		val error = eventLoop_free(ref)
+		check(error == 0U) { "Unable to free event loop: $error" }
+	}
+}
+
+@OptIn(ExperimentalForeignApi::class)
+public actual class ResizeNotifier internal constructor(
+	private val ref: CPointer<resizeNotifier>,
+) : AutoCloseable {
+	private var currentColumns = 0
+	private var currentRows = 0
+
+	public actual val columns: Int get() = currentColumns
+	public actual val rows: Int get() = currentRows
+
+	internal fun update(columns: Int, rows: Int) {
+		currentColumns = columns
+		currentRows = rows
+	}
+
+	public actual suspend fun awaitResize(): Boolean {
+		val packedFds = packFds { signalFd, interruptFd -> resizeNotifier_fds(ref, signalFd, interruptFd) }
+		return pollAndAwaitResize(packedFds)
+	}
+
+	public actual fun awaitResizeBlocking(): Boolean {
+		resizeNotifier_await(ref).useContents {
+			check(error == 0U) { "Unable to await resize: $error" }
+			if (interrupted != 0) return false
+			update(columns, rows)
+			return true
+		}
+	}
+
+	public actual fun interrupt() {
+		val error = resizeNotifier_interrupt(ref)
+		check(error == 0U) { "Unable to interrupt resize notifier: $error" }
+	}
+
+	public actual override fun close() {
+		val error = resizeNotifier_free(ref)
+		check(error == 0U) { "Unable to free resize notifier: $error" }
+	}
+}
+
+@OptIn(ExperimentalForeignApi::class)
+public actual class InputParser internal constructor(
+	private val ref: CPointer<inputParser>,
+) : AutoCloseable {
+	public actual fun parse(buffer: ByteArray, offset: Int, length: Int, events: LongArray): Int {
+		// The native parser writes directly into these arrays so bounds must be verified up front.
+		if (offset < 0 || length < 0 || offset > buffer.size - length) {
+			throw IndexOutOfBoundsException("offset=$offset, length=$length, size=${buffer.size}")
+		}
+		require(events.size > length) { "events.size must be at least length + 1" }
+		if (length == 0) return 0
+
+		buffer.usePinned { pinnedBuffer ->
+			events.usePinned { pinnedEvents ->
+				// Each 8-byte inputEvent is written directly into one element of the long array.
+				return inputParser_parse(
+					ref,
+					pinnedBuffer.addressOf(offset),
+					length,
+					pinnedEvents.addressOf(0).reinterpret<inputEvent>(),
+				)
+			}
+		}
+	}
+
+	public actual val hasPending: Boolean
+		get() = inputParser_hasPending(ref) != 0
+
+	public actual fun flush(events: LongArray): Int {
+		require(events.isNotEmpty()) { "events must not be empty" }
+		events.usePinned {
+			return inputParser_flush(ref, it.addressOf(0).reinterpret<inputEvent>())
+		}
+	}
+
+	public actual fun pasteText(offset: Int, length: Int): String {
+		val paste = inputParser_paste(ref, offset, length)
+			?: throw IndexOutOfBoundsException("offset=$offset, length=$length")
+		return paste.readBytes(length).decodeToString()
+	}
+
+	public actual override fun close() {
+		inputParser_free(ref)
+	}
+}
+
+@OptIn(ExperimentalForeignApi::class)
+internal actual fun cellGridEncodeRow(
+	cells: IntArray,
+	offset: Int,
+	count: Int,
+	colorLevel: Int,
+	output: ByteArray,
+	outputOffset: Int,
+): Int {
+	cells.usePinned { pinnedCells ->
+		output.usePinned { pinnedOutput ->
+			return cellGrid_encodeRow(
+				pinnedCells.addressOf(offset * CellGrid.CellWords).reinterpret(),
+				count,
+				colorLevel,
+				pinnedOutput.addressOf(outputOffset),
+			)
+		}
+	}
+}
+
+@OptIn(ExperimentalForeignApi::class)
+internal actual fun cellGridDiff(
+	previous: IntArray,
+	next: IntArray,
+	width: Int,
+	height: Int,
+	mergeGap: Int,
+	runs: IntArray,
+): Int {
+	previous.usePinned { pinnedPrevious ->
+		next.usePinned { pinnedNext ->
+			runs.usePinned { pinnedRuns ->
+				return cellGrid_diff(
+					pinnedPrevious.addressOf(0).reinterpret(),
+					pinnedNext.addressOf(0).reinterpret(),
+					width,
+					height,
+					mergeGap,
+					pinnedRuns.addressOf(0),
+				)
+			}
+		}
+	}
+}
+
+/**
+ * Retrieve two file descriptors with [getFds] and pack them like the JVM's native functions do:
+ * the first in the upper 32 bits and the second in the lower 32 bits, or -1 if not supported.
+ */
+@OptIn(ExperimentalForeignApi::class)
+private inline fun packFds(getFds: (CPointer<IntVar>, CPointer<IntVar>) -> UInt): Long {
+	memScoped {
+		val first = alloc<IntVar>()
+		val second = alloc<IntVar>()
+		if (getFds(first.ptr, second.ptr) != 0U) return -1L
+		return (first.value.toLong() shl 32) or (second.value.toLong() and 0xFFFFFFFFL)
+	}
+}
+
+@OptIn(ObsoleteWorkersApi::class) // There is no other way to start a thread from common native code.
+internal actual fun startDaemonThread(name: String, block: () -> Unit) {
+	// Worker threads do not prevent the process from exiting when main returns.
+	Worker.start(name = name).executeAfter(0L, block)
+}
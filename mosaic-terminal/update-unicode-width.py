@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Generate the two-stage code point width tables used by UnicodeWidth.kt and mosaic-width.c.
+
+Widths follow wcwidth with a few changes for drawing into a grid of cells:
+ - Nonspacing and enclosing marks, format characters (except U+00AD SOFT HYPHEN), and Hangul
+   medial vowels and final consonants are 0.
+ - East Asian Wide and Fullwidth characters, including emoji with default emoji presentation, and
+   unassigned code points in the CJK ideograph blocks are 2.
+ - Everything else, including control characters, is 1.
+
+The table data comes from Python's unicodedata module. Run with the newest Python available to
+pick up the latest Unicode version, then commit the regenerated files.
+"""
+
+import os
+import unicodedata
+
+BLOCK_BITS = 8
+BLOCK_SIZE = 1 << BLOCK_BITS
+# Four 2-bit widths are packed into each byte.
+PACKED_BLOCK_SIZE = BLOCK_SIZE // 4
+
+REPO_DIR = os.path.dirname(os.path.abspath(__file__))
+C_FILE = os.path.join(REPO_DIR, 'src/c/mosaic-width-table.h')
+KOTLIN_FILE = os.path.join(
+	REPO_DIR,
+	'src/commonMain/kotlin/com/jakewharton/mosaic/terminal/UnicodeWidthTable.kt',
+)
+
+CJK_UNASSIGNED_WIDE = [
+	(0x3400, 0x4DBF),
+	(0x4E00, 0x9FFF),
+	(0xF900, 0xFAFF),
+	(0x20000, 0x2FFFD),
+	(0x30000, 0x3FFFD),
+]
+
+
+def width(code_point):
+	if 0xD800 <= code_point <= 0xDFFF:
+		return 1
+	character = chr(code_point)
+	category = unicodedata.category(character)
+	if category in ('Mn', 'Me'):
+		return 0
+	if category == 'Cf' and code_point != 0x00AD:
+		return 0
+	if 0x1160 <= code_point <= 0x11FF or 0xD7B0 <= code_point <= 0xD7FF:
+		return 0
+	if unicodedata.east_asian_width(character) in ('W', 'F'):
+		return 2
+	if category == 'Cn' and any(start <= code_point <= end for start, end in CJK_UNASSIGNED_WIDE):
+		return 2
+	return 1
+
+
+def build_tables():
+	blocks = {}
+	stage1 = []
+	for block in range(0x110000 >> BLOCK_BITS):
+		widths = tuple(width(code_point) for code_point in range(block << BLOCK_BITS, (block + 1) << BLOCK_BITS))
+		stage1.append(blocks.setdefault(widths, len(blocks)))
+	assert len(blocks) <= 256, 'Stage 1 entries must fit in a byte'
+
+	stage2 = []
+	for widths in blocks:
+		for index in range(0, BLOCK_SIZE, 4):
+			stage2.append(widths[index] | widths[index + 1] << 2 | widths[index + 2] << 4 | widths[index + 3] << 6)
+	return stage1, stage2
+
+
+def header(comment):
+	return f'{comment} Generated by update-unicode-width.py from Unicode {unicodedata.unidata_version}. Do not edit.\n'
+
+
+def write_c(stage1, stage2):
+	def array(name, values):
+		lines = []
+		for start in range(0, len(values), 16):
+			lines.append('\t' + ', '.join(f'0x{value:02x}' for value in values[start:start + 16]) + ',')
+		return f'static const uint8_t {name}[{len(values)}] = {{\n' + '\n'.join(lines) + '\n};\n'
+
+	with open(C_FILE, 'w') as f:
+		f.write(header('//'))
+		f.write('\n')
+		f.write('#include <stdint.h>\n')
+		f.write('\n')
+		f.write(f'#define widthBlockBits {BLOCK_BITS}\n')
+		f.write('\n')
+		f.write('// The block of packed widths for each run of 256 code points.\n')
+		f.write(array('widthStage1', stage1))
+		f.write('\n')
+		f.write('// Widths of 2 bits each, packed four to a byte starting from the low bits.\n')
+		f.write(array('widthStage2', stage2))
+
+
+def write_kotlin(stage1, stage2):
+	def string(name, values):
+		hex_string = ''.join(f'{value:02x}' for value in values)
+		lines = [hex_string[start:start + 96] for start in range(0, len(hex_string), 96)]
+		return f'internal const val {name}: String =\n' + ' +\n'.join(f'\t"{line}"' for line in lines) + '\n'
+
+	with open(KOTLIN_FILE, 'w') as f:
+		f.write(header('//'))
+		f.write('\n')
+		f.write('package com.jakewharton.mosaic.terminal\n')
+		f.write('\n')
+		f.write(f'internal const val widthBlockBits: Int = {BLOCK_BITS}\n')
+		f.write('\n')
+		f.write('/** The block of packed widths for each run of 256 code points, as hex. */\n')
+		f.write(string('widthStage1', stage1))
+		f.write('\n')
+		f.write('/** Widths of 2 bits each, packed four to a byte starting from the low bits, as hex. */\n')
+		f.write(string('widthStage2', stage2))
+
+
+if __name__ == '__main__':
+	stage1, stage2 = build_tables()
+	write_c(stage1, stage2)
+	write_kotlin(stage1, stage2)